@@ -0,0 +1,380 @@
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor-sparse/xcoo_scheme.hpp"
+#include "xtensor-sparse/xcoo_soa_scheme.hpp"
+#include "xtensor-sparse/xcsf_scheme.hpp"
+#include "xtensor-sparse/xcsr_scheme.hpp"
+#include "xtensor-sparse/xfixed_csf_scheme.hpp"
+#include "xtensor-sparse/xhash_scheme.hpp"
+#include "xtensor-sparse/xlinear_coo_scheme.hpp"
+#include "xtensor-sparse/xmap_scheme.hpp"
+#include "xtensor-sparse/xsparse_array.hpp"
+#include "xtensor-sparse/xsparse_convert.hpp"
+
+#include "benchmark_common.hpp"
+
+namespace xt
+{
+    namespace access_bench
+    {
+        using index_type = svector<std::size_t>;
+        using coo_scheme = xdefault_coo_scheme_t<double, index_type>;
+        using coo_soa_scheme = xdefault_coo_soa_scheme_t<double, index_type>;
+        using coo32_scheme = xdefault_coo_scheme_t<double, index_type, std::uint32_t>;
+        using coo_soa32_scheme = xdefault_coo_soa_scheme_t<double, index_type, std::uint32_t>;
+        using linear_coo_scheme = xdefault_linear_coo_scheme_t<double, index_type>;
+        using csf_scheme = xdefault_csf_scheme_t<double, index_type>;
+        using map_scheme = xdefault_map_scheme_t<double, index_type>;
+        using hash_scheme = xdefault_hash_scheme_t<double, index_type>;
+        using csr_scheme = xcsr_scheme<std::vector<std::size_t>,
+                                       std::vector<std::size_t>,
+                                       std::vector<double>>;
+
+        template <class S>
+        inline S make_scheme(std::size_t /*rows*/)
+        {
+            return S();
+        }
+
+        template <>
+        inline csr_scheme make_scheme<csr_scheme>(std::size_t rows)
+        {
+            return csr_scheme(rows);
+        }
+
+        // The hash and linear COO schemes linearize the indices, hence need
+        // the shape of the (square) array.
+        template <class S>
+        inline S make_linearized_scheme(std::size_t rows)
+        {
+            S res;
+            index_type strides = {rows, 1};
+            res.update_entries(strides, strides, index_type({rows, rows}));
+            return res;
+        }
+
+        template <>
+        inline hash_scheme make_scheme<hash_scheme>(std::size_t rows)
+        {
+            return make_linearized_scheme<hash_scheme>(rows);
+        }
+
+        template <>
+        inline linear_coo_scheme make_scheme<linear_coo_scheme>(std::size_t rows)
+        {
+            return make_linearized_scheme<linear_coo_scheme>(rows);
+        }
+
+        // Measures the latency of a random read (half hits, half misses)
+        // as a function of the number of non-zeros.
+        template <class S>
+        void find_element(benchmark::State& state)
+        {
+            using scheme_index_type = typename S::index_type;
+            constexpr std::size_t nb_queries = 1024;
+
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            std::size_t side = bench::square_side(nnz, 0.01);
+            auto coords = bench::make_random_coordinates(nnz, side, side);
+
+            S scheme = make_scheme<S>(side);
+            for (const auto& c: coords)
+            {
+                scheme.insert_element({c[0], c[1]}, 1.);
+            }
+
+            auto misses = bench::make_random_coordinates(nb_queries / 2, side, side, 7);
+            std::vector<scheme_index_type> queries;
+            queries.reserve(nb_queries);
+            for (std::size_t i = 0; i < nb_queries / 2; ++i)
+            {
+                const auto& hit = coords[(i * 7919) % nnz];
+                queries.push_back({hit[0], hit[1]});
+                queries.push_back({misses[i][0], misses[i][1]});
+            }
+
+            std::size_t i = 0;
+            for (auto _: state)
+            {
+                benchmark::DoNotOptimize(scheme.find_element(queries[i]));
+                i = (i + 1) % nb_queries;
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        }
+
+        BENCHMARK_TEMPLATE(find_element, coo_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(find_element, coo_soa_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(find_element, linear_coo_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(find_element, csr_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(find_element, csf_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(find_element, map_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(find_element, hash_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+
+        // Measures the throughput of random writes into an empty scheme.
+        template <class S>
+        void insert_element(benchmark::State& state)
+        {
+            using scheme_index_type = typename S::index_type;
+
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            std::size_t side = bench::square_side(nnz, 0.01);
+            auto coords = bench::make_random_coordinates(nnz, side, side);
+            std::vector<scheme_index_type> indices;
+            indices.reserve(nnz);
+            for (const auto& c: coords)
+            {
+                indices.push_back({c[0], c[1]});
+            }
+
+            for (auto _: state)
+            {
+                S scheme = make_scheme<S>(side);
+                for (const auto& index: indices)
+                {
+                    scheme.insert_element(index, 1.);
+                }
+                benchmark::DoNotOptimize(scheme.find_element(indices.front()));
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nnz));
+        }
+
+        BENCHMARK_TEMPLATE(insert_element, map_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 20);
+        BENCHMARK_TEMPLATE(insert_element, hash_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 20);
+
+        // Bytes held by the coordinates and the values of a COO scheme. The
+        // indices of rank 2 fit in the inline buffer of svector, hence own
+        // no heap memory.
+        template <class P, class C, class ST, class IT>
+        inline std::size_t memory_usage(const xcoo_scheme<P, C, ST, IT>& s)
+        {
+            return s.coordinate().capacity() * sizeof(typename C::value_type)
+                + s.storage().capacity() * sizeof(typename ST::value_type);
+        }
+
+        template <class C, class ST, class IT>
+        inline std::size_t memory_usage(const xcoo_soa_scheme<C, ST, IT>& s)
+        {
+            std::size_t res = s.coordinate().capacity() * sizeof(typename C::value_type)
+                + s.storage().capacity() * sizeof(typename ST::value_type);
+            for (const auto& c: s.coordinate())
+            {
+                res += c.capacity() * sizeof(typename C::value_type::value_type);
+            }
+            return res;
+        }
+
+        template <class K, class ST, class IT>
+        inline std::size_t memory_usage(const xlinear_coo_scheme<K, ST, IT>& s)
+        {
+            return s.keys().capacity() * sizeof(typename K::value_type)
+                + s.storage().capacity() * sizeof(typename ST::value_type);
+        }
+
+        // Builds a COO scheme from random entries with a single call to
+        // insert_elements (append, sort, merge), and reports the memory held
+        // per non-zero by the array-of-indices, structure-of-arrays and
+        // linearized-key layouts.
+        template <class S>
+        void insert_elements(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            std::size_t side = bench::square_side(nnz, 0.01);
+            auto coords = bench::make_random_coordinates(nnz, side, side);
+
+            std::vector<std::pair<index_type, double>> entries;
+            entries.reserve(nnz);
+            for (const auto& c: coords)
+            {
+                entries.push_back({{c[0], c[1]}, 1.});
+            }
+
+            std::size_t bytes = 0;
+            for (auto _: state)
+            {
+                S scheme = make_scheme<S>(side);
+                scheme.insert_elements(entries.cbegin(), entries.cend());
+                bytes = memory_usage(scheme);
+                benchmark::DoNotOptimize(scheme.storage().data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nnz));
+            state.counters["bytes/nnz"] = static_cast<double>(bytes) / static_cast<double>(nnz);
+        }
+
+        BENCHMARK_TEMPLATE(insert_elements, coo_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 20);
+        BENCHMARK_TEMPLATE(insert_elements, coo_soa_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 20);
+        BENCHMARK_TEMPLATE(insert_elements, coo32_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 20);
+        BENCHMARK_TEMPLATE(insert_elements, coo_soa32_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 20);
+        // radix sort of the keys instead of a comparison sort of the indices
+        BENCHMARK_TEMPLATE(insert_elements, linear_coo_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 20);
+
+        // Dense traversal through the iterators of a sparse array holding
+        // 1% of non-zeros, as done when printing it or when mixing it with
+        // dense expressions.
+        template <class S>
+        void dense_traversal(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            std::size_t side = bench::square_side(nnz, 0.01);
+            auto coords = bench::make_random_coordinates(nnz, side, side);
+
+            std::vector<std::pair<index_type, double>> entries;
+            entries.reserve(nnz);
+            for (const auto& c: coords)
+            {
+                entries.push_back({{c[0], c[1]}, 1.});
+            }
+            xsparse_array<double, coo_scheme> coo(std::vector<std::size_t>{side, side});
+            coo.insert_elements(entries.cbegin(), entries.cend());
+            auto a = sparse::convert<S>(coo);
+
+            for (auto _: state)
+            {
+                double res = 0.;
+                for (auto it = a.cbegin(); it != a.cend(); ++it)
+                {
+                    res += *it;
+                }
+                benchmark::DoNotOptimize(res);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(side * side));
+        }
+
+        using csr_array_scheme = xdefault_csr_scheme_t<double, index_type>;
+
+        BENCHMARK_TEMPLATE(dense_traversal, coo_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(dense_traversal, csr_array_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(dense_traversal, csf_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(dense_traversal, map_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+        BENCHMARK_TEMPLATE(dense_traversal, hash_scheme)->RangeMultiplier(4)->Range(1 << 8, 1 << 16);
+
+        /*****************
+         * CSF of rank N *
+         *****************/
+
+        // The CSF scheme of a tensor knows its number of levels at compile
+        // time and unrolls the loops over them, the dynamic one holds its
+        // levels in vectors.
+
+        template <std::size_t N>
+        using csf_tensor_scheme = xdefault_csf_scheme_t<double, std::array<std::size_t, N>>;
+
+        template <std::size_t N>
+        using fixed_csf_tensor_scheme = xdefault_fixed_csf_scheme_t<double, std::array<std::size_t, N>>;
+
+        // Rank N tensor holding 0.1% of non-zeros, built from shuffled
+        // entries.
+        template <class S>
+        inline auto make_csf_entries(std::size_t nnz)
+        {
+            using scheme_index_type = typename S::index_type;
+            constexpr std::size_t N = std::tuple_size<scheme_index_type>::value;
+            std::size_t side = bench::cube_side(nnz, 0.001, N);
+            auto indices = bench::make_random_indices<N>(nnz, side);
+
+            std::vector<std::pair<scheme_index_type, double>> entries;
+            entries.reserve(nnz);
+            for (std::size_t i = 0; i < nnz; ++i)
+            {
+                entries.push_back({indices[(i * 7919) % nnz], double(i)});
+            }
+            return std::make_pair(side, std::move(entries));
+        }
+
+        // Latency of a random read, descending all the levels.
+        template <class S>
+        void csf_find_element(benchmark::State& state)
+        {
+            using scheme_index_type = typename S::index_type;
+            constexpr std::size_t nb_queries = 1024;
+
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            auto entries = make_csf_entries<S>(nnz);
+            S scheme;
+            scheme.insert_elements(entries.second.cbegin(), entries.second.cend());
+
+            // Half hits, half misses differing from a hit in the leaf level
+            std::vector<scheme_index_type> queries;
+            queries.reserve(nb_queries);
+            for (std::size_t i = 0; i < nb_queries / 2; ++i)
+            {
+                scheme_index_type hit = entries.second[(i * 31) % nnz].first;
+                queries.push_back(hit);
+                hit.back() = (hit.back() + 1) % entries.first;
+                queries.push_back(hit);
+            }
+
+            std::size_t i = 0;
+            for (auto _: state)
+            {
+                benchmark::DoNotOptimize(scheme.find_element(queries[i]));
+                i = (i + 1) % nb_queries;
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        }
+
+        // Throughput of the nz_iterator increment and of index().
+        template <class S>
+        void csf_nz_traversal(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            auto entries = make_csf_entries<S>(nnz);
+            S scheme;
+            scheme.insert_elements(entries.second.cbegin(), entries.second.cend());
+
+            for (auto _: state)
+            {
+                double res = 0.;
+                std::size_t last = 0;
+                for (auto it = scheme.nz_cbegin(); it != scheme.nz_cend(); ++it)
+                {
+                    res += *it;
+                    last += it.index().back();
+                }
+                benchmark::DoNotOptimize(res);
+                benchmark::DoNotOptimize(last);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nnz));
+        }
+
+        // Builds all the levels from unsorted entries in a single call.
+        template <class S>
+        void csf_insert_elements(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            auto entries = make_csf_entries<S>(nnz);
+
+            for (auto _: state)
+            {
+                S scheme;
+                scheme.insert_elements(entries.second.cbegin(), entries.second.cend());
+                benchmark::DoNotOptimize(scheme.storage().data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nnz));
+        }
+
+        BENCHMARK_TEMPLATE(csf_find_element, csf_tensor_scheme<3>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_find_element, fixed_csf_tensor_scheme<3>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_find_element, csf_tensor_scheme<4>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_find_element, fixed_csf_tensor_scheme<4>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_find_element, csf_tensor_scheme<5>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_find_element, fixed_csf_tensor_scheme<5>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+        BENCHMARK_TEMPLATE(csf_nz_traversal, csf_tensor_scheme<3>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_nz_traversal, fixed_csf_tensor_scheme<3>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_nz_traversal, csf_tensor_scheme<4>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_nz_traversal, fixed_csf_tensor_scheme<4>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_nz_traversal, csf_tensor_scheme<5>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_nz_traversal, fixed_csf_tensor_scheme<5>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+
+        BENCHMARK_TEMPLATE(csf_insert_elements, csf_tensor_scheme<3>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_insert_elements, fixed_csf_tensor_scheme<3>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_insert_elements, csf_tensor_scheme<4>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_insert_elements, fixed_csf_tensor_scheme<4>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_insert_elements, csf_tensor_scheme<5>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+        BENCHMARK_TEMPLATE(csf_insert_elements, fixed_csf_tensor_scheme<5>)->RangeMultiplier(8)->Range(1 << 10, 1 << 19);
+    }
+}
@@ -0,0 +1,275 @@
+#ifndef BENCHMARK_COMMON_HPP
+#define BENCHMARK_COMMON_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace xt
+{
+    namespace bench
+    {
+        using coordinate_list = std::vector<std::array<std::size_t, 2>>;
+
+        // Returns nnz distinct coordinates drawn uniformly from a rows x cols
+        // matrix, sorted in row-major order.
+        inline coordinate_list make_random_coordinates(std::size_t nnz, std::size_t rows, std::size_t cols, unsigned seed = 42)
+        {
+            std::mt19937_64 gen(seed);
+            std::uniform_int_distribution<std::size_t> dist(0, rows * cols - 1);
+            std::vector<std::size_t> offsets;
+            offsets.reserve(nnz);
+            while (offsets.size() < nnz)
+            {
+                std::size_t missing = nnz - offsets.size();
+                for (std::size_t i = 0; i < missing; ++i)
+                {
+                    offsets.push_back(dist(gen));
+                }
+                std::sort(offsets.begin(), offsets.end());
+                offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+            }
+
+            coordinate_list res(nnz);
+            for (std::size_t i = 0; i < nnz; ++i)
+            {
+                res[i] = {{offsets[i] / cols, offsets[i] % cols}};
+            }
+            return res;
+        }
+
+        // Returns nnz distinct indices drawn uniformly from a tensor of rank
+        // N whose dimensions all equal side, sorted in row-major order.
+        template <std::size_t N>
+        inline std::vector<std::array<std::size_t, N>> make_random_indices(std::size_t nnz, std::size_t side, unsigned seed = 42)
+        {
+            std::size_t size = 1;
+            for (std::size_t d = 0; d < N; ++d)
+            {
+                size *= side;
+            }
+
+            std::mt19937_64 gen(seed);
+            std::uniform_int_distribution<std::size_t> dist(0, size - 1);
+            std::vector<std::size_t> offsets;
+            offsets.reserve(nnz);
+            while (offsets.size() < nnz)
+            {
+                std::size_t missing = nnz - offsets.size();
+                for (std::size_t i = 0; i < missing; ++i)
+                {
+                    offsets.push_back(dist(gen));
+                }
+                std::sort(offsets.begin(), offsets.end());
+                offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+            }
+
+            std::vector<std::array<std::size_t, N>> res(nnz);
+            for (std::size_t i = 0; i < nnz; ++i)
+            {
+                std::size_t offset = offsets[i];
+                for (std::size_t d = N; d != std::size_t(0); --d)
+                {
+                    res[i][d - 1] = offset % side;
+                    offset /= side;
+                }
+            }
+            return res;
+        }
+
+        struct csr_arrays
+        {
+            std::vector<std::size_t> pos;
+            std::vector<std::size_t> coords;
+            std::vector<double> values;
+        };
+
+        // Compressed rows of a rows x cols matrix, row i holding row_sizes[i]
+        // distinct random columns.
+        inline csr_arrays make_random_csr(std::size_t cols, const std::vector<std::size_t>& row_sizes, unsigned seed = 42)
+        {
+            std::mt19937_64 gen(seed);
+            std::uniform_int_distribution<std::size_t> col_dist(0, cols - 1);
+            std::uniform_real_distribution<double> value_dist(-1., 1.);
+
+            csr_arrays res;
+            res.pos.reserve(row_sizes.size() + 1);
+            res.pos.push_back(0);
+            std::vector<std::size_t> row;
+            for (auto size: row_sizes)
+            {
+                size = std::min(size, cols);
+                row.clear();
+                if (4 * size > cols)
+                {
+                    // Selection sampling, rejection is too slow for dense rows
+                    std::uniform_real_distribution<double> unit(0., 1.);
+                    for (std::size_t c = 0; c < cols && row.size() < size; ++c)
+                    {
+                        if (unit(gen) * static_cast<double>(cols - c) < static_cast<double>(size - row.size()))
+                        {
+                            row.push_back(c);
+                        }
+                    }
+                }
+                while (row.size() < size)
+                {
+                    std::size_t missing = size - row.size();
+                    for (std::size_t i = 0; i < missing; ++i)
+                    {
+                        row.push_back(col_dist(gen));
+                    }
+                    std::sort(row.begin(), row.end());
+                    row.erase(std::unique(row.begin(), row.end()), row.end());
+                }
+                for (auto c: row)
+                {
+                    res.coords.push_back(c);
+                    res.values.push_back(value_dist(gen));
+                }
+                res.pos.push_back(res.coords.size());
+            }
+            return res;
+        }
+
+        // Compressed rows of a rows x cols matrix with nnz_per_row distinct
+        // random columns per row.
+        inline csr_arrays make_random_csr(std::size_t rows, std::size_t cols, std::size_t nnz_per_row, unsigned seed = 42)
+        {
+            return make_random_csr(cols, std::vector<std::size_t>(rows, nnz_per_row), seed);
+        }
+
+        // Compressed rows of a square matrix whose row lengths follow a
+        // power law (Zipf with exponent 1) in random row order, with about
+        // avg_nnz_per_row non-zeros per row on average.
+        inline csr_arrays make_power_law_csr(std::size_t rows, std::size_t avg_nnz_per_row, unsigned seed = 42)
+        {
+            double harmonic = 0.;
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                harmonic += 1. / static_cast<double>(i + 1);
+            }
+            double scale = static_cast<double>(rows * avg_nnz_per_row) / harmonic;
+            std::vector<std::size_t> row_sizes(rows);
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                row_sizes[i] = std::max(std::size_t(1), static_cast<std::size_t>(scale / static_cast<double>(i + 1)));
+            }
+            std::shuffle(row_sizes.begin(), row_sizes.end(), std::mt19937_64(seed));
+            return make_random_csr(rows, row_sizes, seed);
+        }
+
+        // Compressed rows of a 2^scale x 2^scale R-MAT graph with about
+        // edge_factor * 2^scale edges, using the Graph500 probabilities
+        // (a, b, c) = (0.57, 0.19, 0.19); duplicate edges are merged.
+        inline csr_arrays make_rmat_csr(std::size_t scale, std::size_t edge_factor, unsigned seed = 42)
+        {
+            std::mt19937_64 gen(seed);
+            std::uniform_real_distribution<double> unit(0., 1.);
+            std::uniform_real_distribution<double> value_dist(-1., 1.);
+            std::size_t n = std::size_t(1) << scale;
+            std::size_t nb_edges = edge_factor * n;
+
+            std::vector<std::size_t> offsets(nb_edges);
+            for (auto& offset: offsets)
+            {
+                std::size_t row = 0;
+                std::size_t col = 0;
+                for (std::size_t level = 0; level < scale; ++level)
+                {
+                    double r = unit(gen);
+                    row = 2 * row + (r >= 0.76 ? 1 : 0);
+                    col = 2 * col + ((r >= 0.57 && r < 0.76) || r >= 0.95 ? 1 : 0);
+                }
+                offset = row * n + col;
+            }
+            std::sort(offsets.begin(), offsets.end());
+            offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+
+            csr_arrays res;
+            res.pos.assign(n + 1, 0);
+            res.coords.reserve(offsets.size());
+            res.values.reserve(offsets.size());
+            for (auto offset: offsets)
+            {
+                ++res.pos[offset / n + 1];
+                res.coords.push_back(offset % n);
+                res.values.push_back(value_dist(gen));
+            }
+            std::partial_sum(res.pos.begin(), res.pos.end(), res.pos.begin());
+            return res;
+        }
+
+        // Compressed rows of an n x n banded matrix with the given half
+        // bandwidth.
+        inline csr_arrays make_banded_csr(std::size_t n, std::size_t half_bandwidth, unsigned seed = 42)
+        {
+            std::mt19937_64 gen(seed);
+            std::uniform_real_distribution<double> value_dist(-1., 1.);
+
+            csr_arrays res;
+            res.pos.reserve(n + 1);
+            res.pos.push_back(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                std::size_t first = i < half_bandwidth ? 0 : i - half_bandwidth;
+                std::size_t last = std::min(n, i + half_bandwidth + 1);
+                for (std::size_t j = first; j < last; ++j)
+                {
+                    res.coords.push_back(j);
+                    res.values.push_back(value_dist(gen));
+                }
+                res.pos.push_back(res.coords.size());
+            }
+            return res;
+        }
+
+        // Compressed rows of a square matrix made of dense block x block
+        // blocks, each block row holding blocks_per_row random blocks; this
+        // is the structure of FEM matrices with block degrees of freedom.
+        inline csr_arrays make_block_csr(std::size_t rows, std::size_t blocks_per_row, std::size_t block, unsigned seed = 42)
+        {
+            std::size_t nb_blocks = rows / block;
+            csr_arrays pattern = make_random_csr(nb_blocks, nb_blocks, blocks_per_row, seed);
+            std::mt19937_64 gen(seed);
+            std::uniform_real_distribution<double> value_dist(-1., 1.);
+
+            csr_arrays res;
+            res.pos.reserve(nb_blocks * block + 1);
+            res.pos.push_back(0);
+            for (std::size_t i = 0; i < nb_blocks * block; ++i)
+            {
+                std::size_t bi = i / block;
+                for (std::size_t j = pattern.pos[bi]; j < pattern.pos[bi + 1]; ++j)
+                {
+                    for (std::size_t c = 0; c < block; ++c)
+                    {
+                        res.coords.push_back(pattern.coords[j] * block + c);
+                        res.values.push_back(value_dist(gen));
+                    }
+                }
+                res.pos.push_back(res.coords.size());
+            }
+            return res;
+        }
+
+        // Side of a square matrix holding nnz non-zeros with the given density.
+        inline std::size_t square_side(std::size_t nnz, double density)
+        {
+            return static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nnz) / density)));
+        }
+
+        // Side of the hypercube of rank N holding nnz non-zeros with the
+        // given density.
+        inline std::size_t cube_side(std::size_t nnz, double density, std::size_t N)
+        {
+            return static_cast<std::size_t>(std::ceil(std::pow(static_cast<double>(nnz) / density, 1. / static_cast<double>(N))));
+        }
+    }
+}
+
+#endif
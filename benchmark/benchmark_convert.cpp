@@ -0,0 +1,123 @@
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <xtensor/xtensor.hpp>
+
+#include "xtensor-sparse/xsparse_array.hpp"
+#include "xtensor-sparse/xsparse_convert.hpp"
+
+#include "benchmark_common.hpp"
+
+namespace xt
+{
+    namespace convert_bench
+    {
+        using index_type = svector<std::size_t>;
+        using coo_scheme = xdefault_coo_scheme_t<double, index_type>;
+        using csr_scheme = xdefault_csr_scheme_t<double, index_type>;
+        using csc_scheme = xdefault_csc_scheme_t<double, index_type>;
+        using csf_scheme = xdefault_csf_scheme_t<double, index_type>;
+        using map_scheme = xdefault_map_scheme_t<double, index_type>;
+
+        constexpr std::size_t nnz_per_row = 16;
+
+        inline xsparse_array<double, coo_scheme> make_coo(std::size_t nnz)
+        {
+            std::size_t rows = nnz / nnz_per_row;
+            bench::csr_arrays arrays = bench::make_random_csr(rows, rows, nnz_per_row);
+
+            std::vector<std::pair<index_type, double>> entries;
+            entries.reserve(arrays.values.size());
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                for (std::size_t j = arrays.pos[i]; j < arrays.pos[i + 1]; ++j)
+                {
+                    entries.push_back({{i, arrays.coords[j]}, arrays.values[j]});
+                }
+            }
+
+            xsparse_array<double, coo_scheme> res(std::vector<std::size_t>{rows, rows});
+            res.insert_elements(entries.cbegin(), entries.cend());
+            return res;
+        }
+
+        // Conversion of a square matrix from scheme S to scheme T, as a
+        // function of the number of non-zeros.
+        template <class S, class T>
+        void convert(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            auto a = sparse::convert<S>(make_coo(nnz));
+
+            for (auto _: state)
+            {
+                auto res = sparse::convert<T>(a);
+                benchmark::DoNotOptimize(res);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(nnz));
+        }
+
+        void convert_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t nnz: {1 << 20, 10000000})
+            {
+                b->Arg(nnz);
+            }
+            b->Unit(benchmark::kMillisecond);
+        }
+
+        BENCHMARK_TEMPLATE(convert, coo_scheme, csr_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, coo_scheme, csc_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, coo_scheme, csf_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, coo_scheme, map_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, csr_scheme, coo_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, csr_scheme, csc_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, csc_scheme, csr_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, csc_scheme, coo_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, csf_scheme, coo_scheme)->Apply(convert_args);
+        BENCHMARK_TEMPLATE(convert, map_scheme, coo_scheme)->Apply(convert_args);
+
+        // Sparsification of a dense n x n activation matrix of which about
+        // 1/8 of the values are above the threshold.
+        template <class S>
+        void from_dense(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            xtensor<float, 2> d = xtensor<float, 2>::from_shape({n, n});
+            std::mt19937 gen(42);
+            std::uniform_real_distribution<float> dist(-1.f, 1.f);
+            for (auto& v: d)
+            {
+                float x = dist(gen);
+                v = x > 0.75f ? x : 1e-4f * x;
+            }
+
+            for (auto _: state)
+            {
+                auto res = sparse::from_dense<S>(d, 1e-3f);
+                benchmark::DoNotOptimize(res);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n * n));
+        }
+
+        void from_dense_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t n: {1024, 4096, 8192})
+            {
+                b->Arg(n);
+            }
+            b->Unit(benchmark::kMillisecond);
+        }
+
+        using coo_float_scheme = xdefault_coo_scheme_t<float, index_type>;
+        using csr_float_scheme = xdefault_csr_scheme_t<float, index_type>;
+        using csf_float_scheme = xdefault_csf_scheme_t<float, index_type>;
+
+        BENCHMARK_TEMPLATE(from_dense, coo_float_scheme)->Apply(from_dense_args);
+        BENCHMARK_TEMPLATE(from_dense, csr_float_scheme)->Apply(from_dense_args);
+        BENCHMARK_TEMPLATE(from_dense, csf_float_scheme)->Apply(from_dense_args);
+    }
+}
@@ -0,0 +1,123 @@
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <xtensor/xeval.hpp>
+#include <xtensor/xtensor.hpp>
+
+#include "xtensor-sparse/xsparse_array.hpp"
+#include "xtensor-sparse/xsparse_function.hpp"
+#include "xtensor-sparse/xsparse_types.hpp"
+
+#include "benchmark_common.hpp"
+
+namespace xt
+{
+    namespace function_bench
+    {
+        using array_type = xcoo_array<double>;
+        using index_type = typename array_type::index_type;
+
+        constexpr std::size_t nnz_per_row = 8;
+
+        // Builds a rows x (16 * nnz_per_row) COO array, so that two arrays
+        // generated with different seeds overlap on about 1/16 of their
+        // non-zeros.
+        inline array_type make_array(std::size_t nnz, unsigned seed)
+        {
+            std::size_t rows = nnz / nnz_per_row;
+            std::size_t cols = 16 * nnz_per_row;
+            bench::csr_arrays arrays = bench::make_random_csr(rows, cols, nnz_per_row, seed);
+
+            std::vector<std::pair<index_type, double>> entries;
+            entries.reserve(arrays.values.size());
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                for (std::size_t j = arrays.pos[i]; j < arrays.pos[i + 1]; ++j)
+                {
+                    entries.push_back({{i, arrays.coords[j]}, arrays.values[j]});
+                }
+            }
+
+            array_type res(std::vector<std::size_t>{rows, cols});
+            res.insert_elements(entries.cbegin(), entries.cend());
+            return res;
+        }
+
+        // Traversal of the non-zeros of a + b, which isolates the cost of
+        // merging the operand iterators.
+        void iterate_sum(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            array_type a = make_array(nnz, 42);
+            array_type b = make_array(nnz, 43);
+
+            auto f = a + b;
+            for (auto _: state)
+            {
+                double res = 0.;
+                for (auto it = f.nz_cbegin(); it != f.nz_cend(); ++it)
+                {
+                    res += *it;
+                }
+                benchmark::DoNotOptimize(res);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(2 * nnz));
+        }
+
+        // Evaluation of a + b into a new sparse array.
+        void eval_sum(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            array_type a = make_array(nnz, 42);
+            array_type b = make_array(nnz, 43);
+
+            for (auto _: state)
+            {
+                auto res = xt::eval(a + b);
+                benchmark::DoNotOptimize(res);
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(2 * nnz));
+        }
+
+        void function_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t nnz: {1 << 16, 1 << 20, 10000000})
+            {
+                b->Arg(nnz);
+            }
+            b->Unit(benchmark::kMillisecond);
+        }
+
+        // Evaluation of a + d where d is dense, which produces a dense
+        // result of 16 * nnz elements.
+        void eval_dense_sum(benchmark::State& state)
+        {
+            std::size_t nnz = static_cast<std::size_t>(state.range(0));
+            array_type a = make_array(nnz, 42);
+            xtensor<double, 2> d = xtensor<double, 2>::from_shape({a.shape()[0], a.shape()[1]});
+            d.fill(1.);
+
+            for (auto _: state)
+            {
+                auto res = xt::eval(a + d);
+                benchmark::DoNotOptimize(res.data());
+            }
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(d.size()));
+        }
+
+        void dense_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t nnz: {1 << 16, 1 << 20})
+            {
+                b->Arg(nnz);
+            }
+            b->Unit(benchmark::kMillisecond);
+        }
+
+        BENCHMARK(iterate_sum)->Apply(function_args);
+        BENCHMARK(eval_sum)->Apply(function_args);
+        BENCHMARK(eval_dense_sum)->Apply(dense_args);
+    }
+}
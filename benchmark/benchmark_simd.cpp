@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include "xtensor-sparse/xcsr_scheme.hpp"
+#include "xtensor-sparse/xsparse_linalg.hpp"
+#include "xtensor-sparse/xsparse_simd.hpp"
+
+#include "benchmark_common.hpp"
+
+namespace xt
+{
+    namespace simd_bench
+    {
+        template <class T>
+        using csr_scheme = xdefault_csr_scheme_t<T, std::array<std::size_t, 2>>;
+
+        template <class T>
+        csr_scheme<T> make_scheme(std::size_t rows, std::size_t nnz_per_row)
+        {
+            auto arrays = bench::make_random_csr(rows, rows, nnz_per_row);
+            std::vector<T> values(arrays.values.cbegin(), arrays.values.cend());
+            return csr_scheme<T>(std::move(arrays.pos), std::move(arrays.coords), std::move(values));
+        }
+
+        // Run these with and without XTENSOR_USE_XSIMD to compare the
+        // vectorized kernels with the scalar fallback.
+
+        // Range 0 is the number of non-zeros per row of a 2^14 x 2^14 matrix
+        template <class T>
+        void spmv(benchmark::State& state)
+        {
+            constexpr std::size_t rows = 1 << 14;
+            auto a = make_scheme<T>(rows, static_cast<std::size_t>(state.range(0)));
+            std::size_t nnz = a.storage().size();
+
+            std::vector<T> x(rows, T(1));
+            std::vector<T> y(rows);
+            for (auto _: state)
+            {
+                std::fill(y.begin(), y.end(), T(0));
+                sparse::spmv(a, x.data(), y.data());
+                benchmark::DoNotOptimize(y.data());
+                benchmark::ClobberMemory();
+            }
+            state.counters["GFLOP/s"] = benchmark::Counter(2e-9 * static_cast<double>(nnz),
+                                                           benchmark::Counter::kIsIterationInvariantRate);
+        }
+
+        // Range 0 is the number of stored values
+        template <class T>
+        void scale(benchmark::State& state)
+        {
+            auto a = make_scheme<T>(static_cast<std::size_t>(state.range(0)) / 16, 16);
+            for (auto _: state)
+            {
+                sparse::scale(a, T(1.0001));
+                benchmark::ClobberMemory();
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * a.storage().size()));
+        }
+
+        template <class T>
+        void sum(benchmark::State& state)
+        {
+            auto a = make_scheme<T>(static_cast<std::size_t>(state.range(0)) / 16, 16);
+            for (auto _: state)
+            {
+                benchmark::DoNotOptimize(sparse::sum(a));
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * a.storage().size()));
+        }
+
+        BENCHMARK_TEMPLATE(spmv, float)->RangeMultiplier(4)->Range(4, 256);
+        BENCHMARK_TEMPLATE(spmv, double)->RangeMultiplier(4)->Range(4, 256);
+        BENCHMARK_TEMPLATE(scale, float)->RangeMultiplier(8)->Range(1 << 12, 1 << 21);
+        BENCHMARK_TEMPLATE(scale, double)->RangeMultiplier(8)->Range(1 << 12, 1 << 21);
+        BENCHMARK_TEMPLATE(sum, float)->RangeMultiplier(8)->Range(1 << 12, 1 << 21);
+        BENCHMARK_TEMPLATE(sum, double)->RangeMultiplier(8)->Range(1 << 12, 1 << 21);
+    }
+}
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include "xtensor-sparse/xcsr_scheme.hpp"
+#include "xtensor-sparse/xsparse_linalg.hpp"
+
+#include "benchmark_common.hpp"
+
+namespace xt
+{
+    namespace spgemm_bench
+    {
+        using csr_scheme = xdefault_csr_scheme_t<double, std::array<std::size_t, 2>>;
+
+        inline csr_scheme make_scheme(bench::csr_arrays&& arrays)
+        {
+            return csr_scheme(std::move(arrays.pos), std::move(arrays.coords), std::move(arrays.values));
+        }
+
+        template <class M>
+        void run_square(benchmark::State& state, M&& make_matrix)
+        {
+            std::size_t nb_parts = static_cast<std::size_t>(state.range(1));
+            csr_scheme a = make_scheme(make_matrix(static_cast<std::size_t>(state.range(0))));
+            std::size_t n = a.position().size() - 1;
+
+            csr_scheme c;
+            for (auto _: state)
+            {
+                sparse::spgemm(a, a, n, c, nb_parts);
+                benchmark::DoNotOptimize(c.storage().data());
+            }
+            state.counters["nnz(A)"] = static_cast<double>(a.storage().size());
+            state.counters["nnz(C)"] = static_cast<double>(c.storage().size());
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * c.storage().size()));
+        }
+
+        // C = A * A on an R-MAT graph of scale range(0) with edge factor 8,
+        // using range(1) partitions.
+        void spgemm_rmat(benchmark::State& state)
+        {
+            run_square(state, [](std::size_t scale) { return bench::make_rmat_csr(scale, 8); });
+        }
+
+        // C = A * A on a 2^16 x 2^16 banded matrix of half bandwidth
+        // range(0), using range(1) partitions.
+        void spgemm_banded(benchmark::State& state)
+        {
+            run_square(state, [](std::size_t half_bandwidth) { return bench::make_banded_csr(1 << 16, half_bandwidth); });
+        }
+
+        void product_args(benchmark::internal::Benchmark* b, std::initializer_list<int64_t> sizes)
+        {
+            for (int64_t size: sizes)
+            {
+                for (int64_t nb_parts: {1, 4, 16})
+                {
+                    b->Args({size, nb_parts});
+                }
+            }
+        }
+
+        BENCHMARK(spgemm_rmat)->Apply([](benchmark::internal::Benchmark* b) { product_args(b, {12, 14, 16}); })->UseRealTime();
+        BENCHMARK(spgemm_banded)->Apply([](benchmark::internal::Benchmark* b) { product_args(b, {2, 8, 32}); })->UseRealTime();
+    }
+}
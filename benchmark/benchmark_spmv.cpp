@@ -0,0 +1,390 @@
+#include <cstdint>
+#include <random>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/tbb.h>
+#endif
+
+#if defined(XTENSOR_USE_OPENMP)
+#include <omp.h>
+#endif
+
+#include "xtensor-sparse/xbcsr_scheme.hpp"
+#include "xtensor-sparse/xcoo_scheme.hpp"
+#include "xtensor-sparse/xcsr_scheme.hpp"
+#include "xtensor-sparse/xdcsr_scheme.hpp"
+#include "xtensor-sparse/xdia_scheme.hpp"
+#include "xtensor-sparse/xlinear_coo_scheme.hpp"
+#include "xtensor-sparse/xsell_scheme.hpp"
+#include "xtensor-sparse/xsparse_linalg.hpp"
+
+#include "benchmark_common.hpp"
+
+namespace xt
+{
+    namespace spmv_bench
+    {
+        using index_type = std::array<std::size_t, 2>;
+        using csr_scheme = xdefault_csr_scheme_t<double, index_type>;
+        using csr32_scheme = xdefault_csr_scheme_t<double, index_type, std::uint32_t>;
+        using coo_scheme = xdefault_coo_scheme_t<double, index_type>;
+        using linear_coo_scheme = xdefault_linear_coo_scheme_t<double, index_type>;
+        using dcsr_scheme = xdefault_dcsr_scheme_t<double, index_type>;
+        using bcsr2_scheme = xdefault_bcsr_scheme_t<double, index_type, 2>;
+        using bcsr4_scheme = xdefault_bcsr_scheme_t<double, index_type, 4>;
+        using sell_scheme = xdefault_sell_scheme_t<double, index_type>;
+        using unsorted_sell_scheme = xdefault_sell_scheme_t<double, index_type, 8, 1>;
+        using dia_scheme = xdefault_dia_scheme_t<double, index_type>;
+
+        template <class S>
+        S make_scheme(bench::csr_arrays&& arrays);
+
+        template <>
+        inline csr_scheme make_scheme<csr_scheme>(bench::csr_arrays&& arrays)
+        {
+            return csr_scheme(std::move(arrays.pos), std::move(arrays.coords), std::move(arrays.values));
+        }
+
+        template <>
+        inline csr32_scheme make_scheme<csr32_scheme>(bench::csr_arrays&& arrays)
+        {
+            using position_type = csr32_scheme::position_type;
+            using coordinate_type = csr32_scheme::coordinate_type;
+            return csr32_scheme(position_type(arrays.pos.cbegin(), arrays.pos.cend()),
+                                coordinate_type(arrays.coords.cbegin(), arrays.coords.cend()),
+                                std::move(arrays.values));
+        }
+
+        template <>
+        inline dcsr_scheme make_scheme<dcsr_scheme>(bench::csr_arrays&& arrays)
+        {
+            std::vector<std::size_t> rows;
+            std::vector<std::size_t> pos = {0};
+            for (std::size_t i = 0; i + 1 < arrays.pos.size(); ++i)
+            {
+                if (arrays.pos[i + 1] != arrays.pos[i])
+                {
+                    rows.push_back(i);
+                    pos.push_back(arrays.pos[i + 1]);
+                }
+            }
+            return dcsr_scheme(std::move(rows), std::move(pos), std::move(arrays.coords), std::move(arrays.values));
+        }
+
+        // BCSR, SELL and DIA are built from the CSR arrays of a square matrix.
+        template <class S>
+        inline S make_from_csr(bench::csr_arrays&& arrays)
+        {
+            std::size_t rows = arrays.pos.size() - 1;
+            csr_scheme csr = make_scheme<csr_scheme>(std::move(arrays));
+            S res(rows, rows);
+            res.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+            return res;
+        }
+
+        template <>
+        inline bcsr2_scheme make_scheme<bcsr2_scheme>(bench::csr_arrays&& arrays)
+        {
+            return make_from_csr<bcsr2_scheme>(std::move(arrays));
+        }
+
+        template <>
+        inline bcsr4_scheme make_scheme<bcsr4_scheme>(bench::csr_arrays&& arrays)
+        {
+            return make_from_csr<bcsr4_scheme>(std::move(arrays));
+        }
+
+        template <>
+        inline sell_scheme make_scheme<sell_scheme>(bench::csr_arrays&& arrays)
+        {
+            return make_from_csr<sell_scheme>(std::move(arrays));
+        }
+
+        template <>
+        inline unsorted_sell_scheme make_scheme<unsorted_sell_scheme>(bench::csr_arrays&& arrays)
+        {
+            return make_from_csr<unsorted_sell_scheme>(std::move(arrays));
+        }
+
+        template <>
+        inline dia_scheme make_scheme<dia_scheme>(bench::csr_arrays&& arrays)
+        {
+            return make_from_csr<dia_scheme>(std::move(arrays));
+        }
+
+        inline std::vector<std::pair<index_type, double>> make_entries(const bench::csr_arrays& arrays)
+        {
+            std::vector<std::pair<index_type, double>> entries;
+            entries.reserve(arrays.values.size());
+            for (std::size_t i = 0; i + 1 < arrays.pos.size(); ++i)
+            {
+                for (std::size_t j = arrays.pos[i]; j < arrays.pos[i + 1]; ++j)
+                {
+                    entries.push_back({{{i, arrays.coords[j]}}, arrays.values[j]});
+                }
+            }
+            return entries;
+        }
+
+        template <>
+        inline coo_scheme make_scheme<coo_scheme>(bench::csr_arrays&& arrays)
+        {
+            auto entries = make_entries(arrays);
+            coo_scheme res;
+            res.insert_elements(entries.cbegin(), entries.cend());
+            return res;
+        }
+
+        // The matrices of the spmv benchmark are square.
+        template <>
+        inline linear_coo_scheme make_scheme<linear_coo_scheme>(bench::csr_arrays&& arrays)
+        {
+            auto entries = make_entries(arrays);
+            std::size_t rows = arrays.pos.size() - 1;
+            index_type strides = {rows, 1};
+            linear_coo_scheme res;
+            res.update_entries(strides, strides, index_type({rows, rows}));
+            res.insert_elements(entries.cbegin(), entries.cend());
+            return res;
+        }
+
+        // Throughput of y = A * x on a square matrix, as a function of the
+        // number of rows (range 0) and of non-zeros per row (range 1).
+        template <class S>
+        void spmv(benchmark::State& state)
+        {
+            std::size_t rows = static_cast<std::size_t>(state.range(0));
+            std::size_t nnz_per_row = static_cast<std::size_t>(state.range(1));
+            S a = make_scheme<S>(bench::make_random_csr(rows, rows, nnz_per_row));
+            std::size_t nnz = a.storage().size();
+
+            std::vector<double> x(rows, 1.);
+            std::vector<double> y(rows);
+            for (auto _: state)
+            {
+                std::fill(y.begin(), y.end(), 0.);
+                sparse::spmv(a, x.data(), y.data());
+                benchmark::DoNotOptimize(y.data());
+                benchmark::ClobberMemory();
+            }
+            state.counters["GFLOP/s"] = benchmark::Counter(2e-9 * static_cast<double>(nnz),
+                                                           benchmark::Counter::kIsIterationInvariantRate);
+        }
+
+        void spmv_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t rows: {1 << 10, 1 << 13, 1 << 16})
+            {
+                for (int64_t nnz_per_row: {4, 16, 64})
+                {
+                    b->Args({rows, nnz_per_row});
+                }
+            }
+        }
+
+        BENCHMARK_TEMPLATE(spmv, csr_scheme)->Apply(spmv_args);
+        // 32-bit coordinates and positions: 12 instead of 16 bytes loaded
+        // per non-zero
+        BENCHMARK_TEMPLATE(spmv, csr32_scheme)->Apply(spmv_args);
+        BENCHMARK_TEMPLATE(spmv, coo_scheme)->Apply(spmv_args);
+        // one key instead of two coordinates per non-zero, one division per
+        // non-empty row
+        BENCHMARK_TEMPLATE(spmv, linear_coo_scheme)->Apply(spmv_args);
+        BENCHMARK_TEMPLATE(spmv, dcsr_scheme)->Apply(spmv_args);
+
+        template <class S>
+        inline double fill_ratio(const S&)
+        {
+            return 1.;
+        }
+
+        template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+        inline double fill_ratio(const xbcsr_scheme<R, CB, P, C, ST, IT>& a)
+        {
+            return a.fill_ratio();
+        }
+
+        template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+        inline double fill_ratio(const xsell_scheme<CS, SW, P, C, ST, IT>& a)
+        {
+            return a.fill_ratio();
+        }
+
+        // Throughput of y = A * x on a matrix made of dense blocks of size
+        // range 1 (2^16 rows, 8 blocks per block row), counted in useful
+        // flops, i.e. on the non-zeros only. "fill" is the ratio of stored
+        // values to non-zeros: BCSR pays off when its block size divides
+        // the one of the matrix.
+        template <class S>
+        void spmv_blocked(benchmark::State& state)
+        {
+            constexpr std::size_t rows = 1 << 16;
+            std::size_t block = static_cast<std::size_t>(state.range(0));
+            bench::csr_arrays arrays = bench::make_block_csr(rows, 8, block);
+            std::size_t nnz = arrays.values.size();
+            S a = make_scheme<S>(std::move(arrays));
+
+            std::vector<double> x(rows, 1.);
+            std::vector<double> y(rows);
+            for (auto _: state)
+            {
+                std::fill(y.begin(), y.end(), 0.);
+                sparse::spmv(a, x.data(), y.data());
+                benchmark::DoNotOptimize(y.data());
+                benchmark::ClobberMemory();
+            }
+            state.counters["GFLOP/s"] = benchmark::Counter(2e-9 * static_cast<double>(nnz),
+                                                           benchmark::Counter::kIsIterationInvariantRate);
+            state.counters["fill"] = fill_ratio(a);
+        }
+
+        void spmv_blocked_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t block: {1, 2, 4, 8})
+            {
+                b->Arg(block);
+            }
+        }
+
+        BENCHMARK_TEMPLATE(spmv_blocked, csr_scheme)->Apply(spmv_blocked_args);
+        BENCHMARK_TEMPLATE(spmv_blocked, bcsr2_scheme)->Apply(spmv_blocked_args);
+        BENCHMARK_TEMPLATE(spmv_blocked, bcsr4_scheme)->Apply(spmv_blocked_args);
+
+        // Throughput of y = A * x on a square matrix (2^16 rows) whose row
+        // lengths are drawn uniformly in [16 - d, 16 + d], d being range 0,
+        // counted in useful flops. SELL-8-1 does not sort the rows, SELL-8-256
+        // sorts them by windows of 256 rows.
+        template <class S>
+        void spmv_row_variance(benchmark::State& state)
+        {
+            constexpr std::size_t rows = 1 << 16;
+            constexpr std::size_t mean = 16;
+            std::size_t spread = static_cast<std::size_t>(state.range(0));
+            std::mt19937_64 gen(42);
+            std::uniform_int_distribution<std::size_t> dist(mean - spread, mean + spread);
+            std::vector<std::size_t> row_sizes(rows);
+            for (auto& size: row_sizes)
+            {
+                size = dist(gen);
+            }
+            bench::csr_arrays arrays = bench::make_random_csr(rows, row_sizes);
+            std::size_t nnz = arrays.values.size();
+            S a = make_scheme<S>(std::move(arrays));
+
+            std::vector<double> x(rows, 1.);
+            std::vector<double> y(rows);
+            for (auto _: state)
+            {
+                std::fill(y.begin(), y.end(), 0.);
+                sparse::spmv(a, x.data(), y.data());
+                benchmark::DoNotOptimize(y.data());
+                benchmark::ClobberMemory();
+            }
+            state.counters["GFLOP/s"] = benchmark::Counter(2e-9 * static_cast<double>(nnz),
+                                                           benchmark::Counter::kIsIterationInvariantRate);
+            state.counters["fill"] = fill_ratio(a);
+        }
+
+        void spmv_row_variance_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t spread: {0, 4, 8, 16})
+            {
+                b->Arg(spread);
+            }
+        }
+
+        BENCHMARK_TEMPLATE(spmv_row_variance, csr_scheme)->Apply(spmv_row_variance_args);
+        BENCHMARK_TEMPLATE(spmv_row_variance, unsorted_sell_scheme)->Apply(spmv_row_variance_args);
+        BENCHMARK_TEMPLATE(spmv_row_variance, sell_scheme)->Apply(spmv_row_variance_args);
+
+        // Throughput of y = A * x on a banded matrix (2^20 rows) with the
+        // half bandwidth given by range 0: DIA streams the diagonals without
+        // loading any coordinate.
+        template <class S>
+        void spmv_banded(benchmark::State& state)
+        {
+            constexpr std::size_t rows = 1 << 20;
+            std::size_t half_bandwidth = static_cast<std::size_t>(state.range(0));
+            bench::csr_arrays arrays = bench::make_banded_csr(rows, half_bandwidth);
+            std::size_t nnz = arrays.values.size();
+            S a = make_scheme<S>(std::move(arrays));
+
+            std::vector<double> x(rows, 1.);
+            std::vector<double> y(rows);
+            for (auto _: state)
+            {
+                std::fill(y.begin(), y.end(), 0.);
+                sparse::spmv(a, x.data(), y.data());
+                benchmark::DoNotOptimize(y.data());
+                benchmark::ClobberMemory();
+            }
+            state.counters["GFLOP/s"] = benchmark::Counter(2e-9 * static_cast<double>(nnz),
+                                                           benchmark::Counter::kIsIterationInvariantRate);
+        }
+
+        void spmv_banded_args(benchmark::internal::Benchmark* b)
+        {
+            for (int64_t half_bandwidth: {1, 2, 8, 32})
+            {
+                b->Arg(half_bandwidth);
+            }
+        }
+
+        BENCHMARK_TEMPLATE(spmv_banded, csr_scheme)->Apply(spmv_banded_args);
+        BENCHMARK_TEMPLATE(spmv_banded, dia_scheme)->Apply(spmv_banded_args);
+
+        // Strong scaling of parallel_spmv on a fixed power-law matrix
+        // (2^20 rows, 16 non-zeros per row on average) with the number of
+        // threads given by range 0.
+        void parallel_spmv(benchmark::State& state)
+        {
+            constexpr std::size_t rows = 1 << 20;
+            std::size_t nb_threads = static_cast<std::size_t>(state.range(0));
+            csr_scheme a = make_scheme<csr_scheme>(bench::make_power_law_csr(rows, 16));
+            std::size_t nnz = a.storage().size();
+
+            std::vector<double> x(rows, 1.);
+            std::vector<double> y(rows);
+            auto run = [&]()
+            {
+                std::fill(y.begin(), y.end(), 0.);
+                sparse::parallel_spmv(a, x.data(), y.data(), nb_threads);
+                benchmark::DoNotOptimize(y.data());
+                benchmark::ClobberMemory();
+            };
+
+#if defined(XTENSOR_USE_TBB)
+            tbb::task_arena arena(static_cast<int>(nb_threads));
+            for (auto _: state)
+            {
+                arena.execute(run);
+            }
+#else
+#if defined(XTENSOR_USE_OPENMP)
+            omp_set_num_threads(static_cast<int>(nb_threads));
+#endif
+            for (auto _: state)
+            {
+                run();
+            }
+#endif
+            state.counters["GFLOP/s"] = benchmark::Counter(2e-9 * static_cast<double>(nnz),
+                                                           benchmark::Counter::kIsIterationInvariantRate);
+        }
+
+        void parallel_spmv_args(benchmark::internal::Benchmark* b)
+        {
+            int64_t max_threads = std::max(int64_t(1), static_cast<int64_t>(std::thread::hardware_concurrency()));
+            for (int64_t nb_threads = 1; nb_threads < max_threads; nb_threads *= 2)
+            {
+                b->Arg(nb_threads);
+            }
+            b->Arg(max_threads);
+        }
+
+        BENCHMARK(parallel_spmv)->Apply(parallel_spmv_args)->UseRealTime();
+    }
+}
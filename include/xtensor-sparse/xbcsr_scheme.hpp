@@ -0,0 +1,707 @@
+#ifndef XSPARSE_BCSR_SCHEME_HPP
+#define XSPARSE_BCSR_SCHEME_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <xtl/xiterator_base.hpp>
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xlayout.hpp>
+#include <xtensor/xstorage.hpp>
+#include <xtensor/xstrides.hpp>
+
+namespace xt
+{
+    template <class scheme>
+    class xbcsr_scheme_nz_iterator;
+
+    /****************************
+     * xbcsr_scheme declaration *
+     ****************************/
+
+    // Block compressed sparse row scheme with R x CB dense blocks. position()
+    // is indexed by block rows, coordinate() holds one block column per block
+    // and storage() holds the blocks one after the other, each in row-major
+    // order. Entries of the blocks that are not set hold zeros; they are
+    // skipped by the nz_iterator, which iterates the blocks in order.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT = std::array<std::size_t, 2>>
+    class xbcsr_scheme
+    {
+    public:
+
+        using self_type = xbcsr_scheme<R, CB, P, C, ST, IT>;
+        using position_type = P;
+        using coordinate_type = C;
+        using storage_type = ST;
+        using index_type = IT;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using nz_iterator = xbcsr_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xbcsr_scheme_nz_iterator<const self_type>;
+
+        static constexpr std::size_t block_rows = R;
+        static constexpr std::size_t block_cols = CB;
+        static constexpr std::size_t block_size = R * CB;
+        static constexpr layout_type nz_layout = R == 1 ? layout_type::row_major : layout_type::dynamic;
+
+        xbcsr_scheme();
+        xbcsr_scheme(std::size_t rows, std::size_t cols);
+        xbcsr_scheme(std::size_t rows, std::size_t cols, position_type pos, coordinate_type coords, storage_type storage);
+
+        const std::array<std::size_t, 2>& shape() const;
+        const position_type& position() const;
+        const coordinate_type& coordinate() const;
+        const storage_type& storage() const;
+
+        storage_type& storage();
+
+        double fill_ratio() const;
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+    private:
+
+        using size_type = typename position_type::value_type;
+        using entry_type = std::tuple<std::size_t, std::size_t, value_type>;
+
+        std::size_t nb_block_rows() const;
+        std::size_t find_block(std::size_t row, std::size_t col) const;
+        const_pointer find_element_impl(const index_type& index) const;
+        void erase_block(std::size_t block_row, std::size_t block);
+        void build(const std::vector<entry_type>& entries);
+
+        std::array<std::size_t, 2> m_shape;
+        position_type m_pos;
+        coordinate_type m_coords;
+        storage_type m_storage;
+
+        friend class xbcsr_scheme_nz_iterator<self_type>;
+        friend class xbcsr_scheme_nz_iterator<const self_type>;
+    };
+
+    /************************
+     * xdefault_bcsr_scheme *
+     ************************/
+
+    template <class T, class I, std::size_t R, std::size_t CB = R, class C = typename I::value_type, class P = C>
+    struct xdefault_bcsr_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xbcsr_scheme<R, CB,
+                                  std::vector<position_value_type>,
+                                  std::vector<coordinate_value_type>,
+                                  storage_type,
+                                  index_type>;
+    };
+
+    template <class T, class I, std::size_t R, std::size_t CB = R, class C = typename I::value_type, class P = C>
+    using xdefault_bcsr_scheme_t = typename xdefault_bcsr_scheme<T, I, R, CB, C, P>::type;
+
+    /****************************************
+     * xbcsr_scheme_nz_iterator declaration *
+     ****************************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xbcsr_scheme_nz_iterator_types
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::reference;
+            using pointer = typename storage_type::pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+
+        template <class scheme>
+        struct xbcsr_scheme_nz_iterator_types<const scheme>
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::const_reference;
+            using pointer = typename storage_type::const_pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+    }
+
+    // Iterates the entries of the blocks, skipping the zeros they hold.
+    // Jumping by n entries or measuring a distance scans the block entries
+    // in between, hence the iterator is not flagged by has_fast_nz_advance:
+    // BCSR containers keep the indexed stepper, even with R == 1.
+    template <class scheme>
+    class xbcsr_scheme_nz_iterator
+        : public xtl::xrandom_access_iterator_base3<xbcsr_scheme_nz_iterator<scheme>,
+                                                    detail::xbcsr_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xbcsr_scheme_nz_iterator<scheme>;
+        using scheme_type = scheme;
+        using iterator_types = detail::xbcsr_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+
+        xbcsr_scheme_nz_iterator(scheme& s, std::size_t pos);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+    private:
+
+        bool is_zero(std::size_t pos) const;
+
+        scheme_type* p_scheme;
+        std::size_t m_pos;
+        mutable index_type m_current_index;
+    };
+
+    template <class scheme>
+    bool operator==(const xbcsr_scheme_nz_iterator<scheme>& lhs,
+                    const xbcsr_scheme_nz_iterator<scheme>& rhs);
+
+    template <class scheme>
+    bool operator<(const xbcsr_scheme_nz_iterator<scheme>& lhs,
+                   const xbcsr_scheme_nz_iterator<scheme>& rhs);
+
+    /*******************************
+     * xbcsr_scheme implementation *
+     *******************************/
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline xbcsr_scheme<R, CB, P, C, ST, IT>::xbcsr_scheme()
+        : xbcsr_scheme(0u, 0u)
+    {
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline xbcsr_scheme<R, CB, P, C, ST, IT>::xbcsr_scheme(std::size_t rows, std::size_t cols)
+        : m_shape({rows, cols})
+        , m_pos((rows + R - 1) / R + 1, 0)
+    {
+    }
+
+    // Builds the scheme from already compressed arrays: pos holds one more
+    // entry than the number of block rows, block columns must be sorted
+    // within each block row and storage holds R * CB values per block.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline xbcsr_scheme<R, CB, P, C, ST, IT>::xbcsr_scheme(std::size_t rows, std::size_t cols,
+                                                           position_type pos, coordinate_type coords, storage_type storage)
+        : m_shape({rows, cols})
+        , m_pos(std::move(pos))
+        , m_coords(std::move(coords))
+        , m_storage(std::move(storage))
+    {
+        XTENSOR_ASSERT(m_pos.size() == nb_block_rows() + 1);
+        XTENSOR_ASSERT(m_pos.back() == m_coords.size());
+        XTENSOR_ASSERT(m_coords.size() * block_size == m_storage.size());
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::shape() const -> const std::array<std::size_t, 2>&
+    {
+        return m_shape;
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::position() const -> const position_type&
+    {
+        return m_pos;
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::coordinate() const -> const coordinate_type&
+    {
+        return m_coords;
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::storage() -> storage_type&
+    {
+        return m_storage;
+    }
+
+    // Ratio of the number of stored values to the number of non-zeros, 1
+    // when the blocks are full. Values above 1.5 usually make BCSR slower
+    // than CSR.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline double xbcsr_scheme<R, CB, P, C, ST, IT>::fill_ratio() const
+    {
+        std::size_t nnz = static_cast<std::size_t>(std::count_if(m_storage.cbegin(), m_storage.cend(),
+                                                                 [](const value_type& v) { return v != value_type(0); }));
+        return nnz == 0 ? 1. : static_cast<double>(m_storage.size()) / static_cast<double>(nnz);
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(find_element_impl(index));
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::find_element(const index_type& index) const -> const_pointer
+    {
+        return find_element_impl(index);
+    }
+
+    // Inserting into a new block adds R * CB values, the others being zero.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline void xbcsr_scheme<R, CB, P, C, ST, IT>::insert_element(const index_type& index, const_reference value)
+    {
+        XTENSOR_ASSERT(index.size() == 2);
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        XTENSOR_ASSERT(row / R + 1 < m_pos.size());
+
+        std::size_t block = find_block(row, col);
+        if (block == std::numeric_limits<std::size_t>::max())
+        {
+            std::size_t block_row = row / R;
+            auto first = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[block_row]);
+            auto last = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[block_row + 1]);
+            auto it = std::lower_bound(first, last, col / CB);
+            block = static_cast<std::size_t>(std::distance(m_coords.begin(), it));
+            m_coords.insert(it, static_cast<typename coordinate_type::value_type>(col / CB));
+            m_storage.insert(m_storage.begin() + static_cast<std::ptrdiff_t>(block * block_size), block_size, value_type(0));
+            for (std::size_t j = block_row + 1; j < m_pos.size(); ++j)
+            {
+                ++m_pos[j];
+            }
+        }
+        m_storage[block * block_size + (row % R) * CB + col % CB] = value;
+    }
+
+    // The element is set to zero; its block is removed when it holds no
+    // other non-zero.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline void xbcsr_scheme<R, CB, P, C, ST, IT>::remove_element(const index_type& index)
+    {
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        std::size_t block = find_block(row, col);
+        if (block == std::numeric_limits<std::size_t>::max())
+        {
+            return;
+        }
+
+        auto first = m_storage.begin() + static_cast<std::ptrdiff_t>(block * block_size);
+        first[static_cast<std::ptrdiff_t>((row % R) * CB + col % CB)] = value_type(0);
+        if (std::all_of(first, first + block_size, [](const value_type& v) { return v == value_type(0); }))
+        {
+            erase_block(row / R, block);
+        }
+    }
+
+    // Sets the stored values whose magnitude is lower than or equal to
+    // tolerance to zero, and removes the blocks left empty in a single pass.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline void xbcsr_scheme<R, CB, P, C, ST, IT>::prune(value_type tolerance)
+    {
+        std::size_t dst = 0;
+        std::size_t begin = m_pos[0];
+        for (std::size_t i = 0; i + 1 < m_pos.size(); ++i)
+        {
+            std::size_t end = m_pos[i + 1];
+            for (std::size_t b = begin; b < end; ++b)
+            {
+                bool empty = true;
+                for (std::size_t k = 0; k < block_size; ++k)
+                {
+                    value_type v = m_storage[b * block_size + k];
+                    bool keep = std::abs(v) > tolerance;
+                    m_storage[dst * block_size + k] = keep ? v : value_type(0);
+                    empty = empty && !keep;
+                }
+                if (!empty)
+                {
+                    m_coords[dst] = m_coords[b];
+                    ++dst;
+                }
+            }
+            begin = end;
+            m_pos[i + 1] = static_cast<size_type>(dst);
+        }
+        m_coords.resize(dst);
+        m_storage.resize(dst * block_size);
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    template <class strides_type, class shape_type>
+    inline void xbcsr_scheme<R, CB, P, C, ST, IT>::update_entries(const strides_type& old_strides,
+                                                                  const strides_type& new_strides,
+                                                                  const shape_type& new_shape)
+    {
+        XTENSOR_ASSERT(new_shape.size() == 2);
+
+        std::vector<entry_type> entries;
+        std::array<std::size_t, 2> old_index;
+        for (auto it = nz_cbegin(); it != nz_cend(); ++it)
+        {
+            const auto& index = it.index();
+            old_index[0] = static_cast<std::size_t>(index[0]);
+            old_index[1] = static_cast<std::size_t>(index[1]);
+            std::size_t offset = element_offset<std::size_t>(old_strides, old_index.cbegin(), old_index.cend());
+            auto new_index = unravel_from_strides(offset, new_strides);
+            entries.emplace_back(new_index[0], new_index[1], *it);
+        }
+        std::sort(entries.begin(), entries.end(), [](const entry_type& lhs, const entry_type& rhs)
+        {
+            return std::tie(std::get<0>(lhs), std::get<1>(lhs)) < std::tie(std::get<0>(rhs), std::get<1>(rhs));
+        });
+
+        m_shape = {static_cast<std::size_t>(new_shape[0]), static_cast<std::size_t>(new_shape[1])};
+        build(entries);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    template <class It>
+    inline void xbcsr_scheme<R, CB, P, C, ST, IT>::assign_nz(It first, It last)
+    {
+        std::vector<entry_type> entries;
+        for (; first != last; ++first)
+        {
+            const auto& index = first.index();
+            entries.emplace_back(static_cast<std::size_t>(index[0]), static_cast<std::size_t>(index[1]), *first);
+        }
+        build(entries);
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, 0u);
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, m_storage.size());
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, 0u);
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_storage.size());
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline std::size_t xbcsr_scheme<R, CB, P, C, ST, IT>::nb_block_rows() const
+    {
+        return (m_shape[0] + R - 1) / R;
+    }
+
+    // Returns the position of the block holding (row, col) in coordinate(),
+    // or npos if there is none.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline std::size_t xbcsr_scheme<R, CB, P, C, ST, IT>::find_block(std::size_t row, std::size_t col) const
+    {
+        std::size_t block_row = row / R;
+        if (block_row + 1 >= m_pos.size())
+        {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        auto first = m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[block_row]);
+        auto last = m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[block_row + 1]);
+        auto it = std::lower_bound(first, last, col / CB);
+        if (it == last || static_cast<std::size_t>(*it) != col / CB)
+        {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        return static_cast<std::size_t>(std::distance(m_coords.cbegin(), it));
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline auto xbcsr_scheme<R, CB, P, C, ST, IT>::find_element_impl(const index_type& index) const -> const_pointer
+    {
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        std::size_t block = find_block(row, col);
+        if (block == std::numeric_limits<std::size_t>::max())
+        {
+            return nullptr;
+        }
+        return &m_storage[block * block_size + (row % R) * CB + col % CB];
+    }
+
+    // Builds the blocks from entries sorted in row-major order. The entries
+    // of a block row are contiguous: the blocks they touch are flagged in an
+    // array indexed by block column, sorted, then filled, so that the cost
+    // is linear in the number of non-zeros plus the number of block columns.
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline void xbcsr_scheme<R, CB, P, C, ST, IT>::build(const std::vector<entry_type>& entries)
+    {
+        constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        m_pos.assign(nb_block_rows() + 1, size_type(0));
+        m_coords.clear();
+        m_storage.clear();
+
+        std::vector<std::size_t> slot((m_shape[1] + CB - 1) / CB, npos);
+        std::vector<std::size_t> blocks;
+        std::size_t first = 0;
+        while (first != entries.size())
+        {
+            std::size_t block_row = std::get<0>(entries[first]) / R;
+            XTENSOR_ASSERT(block_row + 1 < m_pos.size());
+            std::size_t last = first;
+            for (; last != entries.size() && std::get<0>(entries[last]) / R == block_row; ++last)
+            {
+                std::size_t block_col = std::get<1>(entries[last]) / CB;
+                if (slot[block_col] == npos)
+                {
+                    slot[block_col] = 0;
+                    blocks.push_back(block_col);
+                }
+            }
+
+            std::sort(blocks.begin(), blocks.end());
+            std::size_t offset = m_coords.size();
+            for (std::size_t b = 0; b < blocks.size(); ++b)
+            {
+                slot[blocks[b]] = offset + b;
+                m_coords.push_back(static_cast<typename coordinate_type::value_type>(blocks[b]));
+            }
+            m_storage.resize(m_coords.size() * block_size, value_type(0));
+            for (std::size_t k = first; k != last; ++k)
+            {
+                std::size_t row = std::get<0>(entries[k]);
+                std::size_t col = std::get<1>(entries[k]);
+                m_storage[slot[col / CB] * block_size + (row % R) * CB + col % CB] = std::get<2>(entries[k]);
+            }
+            for (std::size_t b: blocks)
+            {
+                slot[b] = npos;
+            }
+            blocks.clear();
+            m_pos[block_row + 1] = static_cast<size_type>(m_coords.size());
+            first = last;
+        }
+
+        for (std::size_t i = 1; i < m_pos.size(); ++i)
+        {
+            m_pos[i] = std::max(m_pos[i], m_pos[i - 1]);
+        }
+    }
+
+    template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+    inline void xbcsr_scheme<R, CB, P, C, ST, IT>::erase_block(std::size_t block_row, std::size_t block)
+    {
+        m_coords.erase(m_coords.begin() + static_cast<std::ptrdiff_t>(block));
+        auto first = m_storage.begin() + static_cast<std::ptrdiff_t>(block * block_size);
+        m_storage.erase(first, first + static_cast<std::ptrdiff_t>(block_size));
+        for (std::size_t j = block_row + 1; j < m_pos.size(); ++j)
+        {
+            --m_pos[j];
+        }
+    }
+
+    /*******************************************
+     * xbcsr_scheme_nz_iterator implementation *
+     *******************************************/
+
+    template <class scheme>
+    inline xbcsr_scheme_nz_iterator<scheme>::xbcsr_scheme_nz_iterator(scheme& s, std::size_t pos)
+        : p_scheme(&s)
+        , m_pos(pos)
+        , m_current_index(xtl::make_sequence<index_type>(2))
+    {
+        while (m_pos < p_scheme->m_storage.size() && is_zero(m_pos))
+        {
+            ++m_pos;
+        }
+    }
+
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::operator++() -> self_type&
+    {
+        do
+        {
+            ++m_pos;
+        }
+        while (m_pos < p_scheme->m_storage.size() && is_zero(m_pos));
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::operator--() -> self_type&
+    {
+        do
+        {
+            --m_pos;
+        }
+        while (is_zero(m_pos));
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::operator+=(difference_type n) -> self_type&
+    {
+        for (; n > 0; --n)
+        {
+            ++(*this);
+        }
+        for (; n < 0; ++n)
+        {
+            --(*this);
+        }
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::operator-=(difference_type n) -> self_type&
+    {
+        return *this += -n;
+    }
+
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::operator-(const self_type& rhs) const -> difference_type
+    {
+        std::size_t first = std::min(m_pos, rhs.m_pos);
+        std::size_t last = std::max(m_pos, rhs.m_pos);
+        difference_type count = 0;
+        for (std::size_t i = first; i < last; ++i)
+        {
+            count += is_zero(i) ? 0 : 1;
+        }
+        return m_pos < rhs.m_pos ? -count : count;
+    }
+
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::operator*() const -> reference
+    {
+        return p_scheme->m_storage[m_pos];
+    }
+
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::operator->() const -> pointer
+    {
+        return &(this->operator*());
+    }
+
+    // The block row is found by a binary search in position(), which is only
+    // paid when the index is requested.
+    template <class scheme>
+    inline auto xbcsr_scheme_nz_iterator<scheme>::index() const -> const index_type&
+    {
+        constexpr std::size_t block_size = scheme::block_size;
+        const auto& pos = p_scheme->m_pos;
+        std::size_t block = m_pos / block_size;
+        std::size_t entry = m_pos % block_size;
+        auto it = std::upper_bound(pos.cbegin(), pos.cend(), block);
+        std::size_t block_row = static_cast<std::size_t>(std::distance(pos.cbegin(), it)) - 1;
+        m_current_index[0] = block_row * scheme::block_rows + entry / scheme::block_cols;
+        m_current_index[1] = static_cast<std::size_t>(p_scheme->m_coords[block]) * scheme::block_cols + entry % scheme::block_cols;
+        return m_current_index;
+    }
+
+    template <class scheme>
+    inline bool xbcsr_scheme_nz_iterator<scheme>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_pos == rhs.m_pos;
+    }
+
+    template <class scheme>
+    inline bool xbcsr_scheme_nz_iterator<scheme>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_pos < rhs.m_pos;
+    }
+
+    template <class scheme>
+    inline bool xbcsr_scheme_nz_iterator<scheme>::is_zero(std::size_t pos) const
+    {
+        return p_scheme->m_storage[pos] == value_type(0);
+    }
+
+    template <class scheme>
+    inline bool operator==(const xbcsr_scheme_nz_iterator<scheme>& lhs,
+                           const xbcsr_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class scheme>
+    inline bool operator<(const xbcsr_scheme_nz_iterator<scheme>& lhs,
+                          const xbcsr_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
@@ -3,10 +3,19 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include <xtl/xsequence.hpp>
+
 #include <xtensor/xstorage.hpp>
 #include <xtensor/xstrides.hpp>
+#include <xtensor/xutils.hpp>
+
+#include "xutils.hpp"
 
 namespace xt
 {
@@ -17,6 +26,8 @@ namespace xt
      * xcoo_scheme *
      ***************/
 
+    // Coordinates are stored as sequences of type coordinate_type::value_type,
+    // which may hold narrower integers than index_type.
     template <class P, class C, class ST, class IT = svector<std::size_t>>
     class xcoo_scheme
     {
@@ -27,6 +38,7 @@ namespace xt
         using coordinate_type = C;
         using storage_type = ST;
         using index_type = IT;
+        using stored_index_type = typename coordinate_type::value_type;
 
         using value_type = typename storage_type::value_type;
         using reference = typename storage_type::reference;
@@ -42,17 +54,25 @@ namespace xt
         using const_nz_iterator = xcoo_scheme_nz_iterator<const self_type>;
 
         xcoo_scheme();
+        xcoo_scheme(coordinate_type coords, storage_type storage);
 
         pointer find_element(const index_type& index);
         const_pointer find_element(const index_type& index) const;
         void insert_element(const index_type& index, const_reference value);
         void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class It>
+        void insert_elements(It first, It last);
 
         template <class strides_type, class shape_type>
         void update_entries(const strides_type& old_strides,
                             const strides_type& new_strides,
                             const shape_type& new_shape);
 
+        template <class It>
+        void assign_nz(It first, It last);
+
         nz_iterator nz_begin();
         nz_iterator nz_end();
         const_nz_iterator nz_begin() const;
@@ -76,21 +96,22 @@ namespace xt
      * xdefault_coo_scheme *
      ***********************/
 
-    template <class T, class I>
+    template <class T, class I, class C = typename I::value_type, class P = C>
     struct xdefault_coo_scheme
     {
         using index_type = I;
         using value_type = T;
-        using size_type = typename index_type::value_type;
+        using coordinate_value_type = C;
+        using position_value_type = P;
         using storage_type = std::vector<value_type>;
-        using type = xcoo_scheme<std::array<size_type, 2>,
-                                 std::vector<index_type>,
+        using type = xcoo_scheme<std::array<position_value_type, 2>,
+                                 std::vector<rebind_container_t<coordinate_value_type, index_type>>,
                                  storage_type,
                                  index_type>;
     };
 
-    template <class T, class I>
-    using xdefault_coo_scheme_t = typename xdefault_coo_scheme<T, I>::type;
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_coo_scheme_t = typename xdefault_coo_scheme<T, I, C, P>::type;
 
     /***************************
      * xcoo_scheme_nz_iterator *
@@ -171,6 +192,7 @@ namespace xt
         scheme_type* p_scheme;
         coordinate_iterator m_cit;
         value_iterator m_vit;
+        mutable index_type m_current_index;
     };
 
     template <class S>
@@ -191,6 +213,17 @@ namespace xt
     {
     }
 
+    // Builds the scheme from already compacted arrays: coordinates must be
+    // sorted in row-major order.
+    template <class P, class C, class ST, class IT>
+    inline xcoo_scheme<P, C, ST, IT>::xcoo_scheme(coordinate_type coords, storage_type storage)
+        : m_pos(P{{0u, static_cast<typename P::value_type>(coords.size())}})
+        , m_coords(std::move(coords))
+        , m_storage(std::move(storage))
+    {
+        XTENSOR_ASSERT(m_coords.size() == m_storage.size());
+    }
+
     template <class P, class C, class ST, class IT>
     inline auto xcoo_scheme<P, C, ST, IT>::position() const -> const position_type&
     {
@@ -225,16 +258,17 @@ namespace xt
     template <class P, class C, class ST, class IT>
     inline void xcoo_scheme<P, C, ST, IT>::insert_element(const index_type& index, const_reference value)
     {
-        auto it = std::upper_bound(m_coords.cbegin(), m_coords.cend(), index);
+        const auto& key = detail::convert_index<stored_index_type>(index);
+        auto it = std::upper_bound(m_coords.cbegin(), m_coords.cend(), key);
         if (it != m_coords.cend())
         {
             auto diff = std::distance(m_coords.cbegin(), it);
-            m_coords.insert(it, index);
+            m_coords.insert(it, key);
             m_storage.insert(m_storage.cbegin() + diff, value);
         }
         else
         {
-            m_coords.push_back(index);
+            m_coords.push_back(key);
             m_storage.push_back(value);
         }
         ++m_pos.back();
@@ -243,8 +277,9 @@ namespace xt
     template <class P, class C, class ST, class IT>
     inline void xcoo_scheme<P, C, ST, IT>::remove_element(const index_type& index)
     {
-        auto it = std::find(m_coords.begin(), m_coords.end(), index);
-        if (it != m_coords.end())
+        const auto& key = detail::convert_index<stored_index_type>(index);
+        auto it = std::lower_bound(m_coords.begin(), m_coords.end(), key);
+        if (it != m_coords.end() && *it == key)
         {
             auto diff = it - m_coords.begin();
             m_coords.erase(it);
@@ -253,6 +288,72 @@ namespace xt
         }
     }
 
+    template <class P, class C, class ST, class IT>
+    inline void xcoo_scheme<P, C, ST, IT>::prune(value_type tolerance)
+    {
+        std::size_t dst = 0;
+        for (std::size_t i = 0; i < m_storage.size(); ++i)
+        {
+            if (std::abs(m_storage[i]) > tolerance)
+            {
+                if (dst != i)
+                {
+                    m_coords[dst] = std::move(m_coords[i]);
+                    m_storage[dst] = m_storage[i];
+                }
+                ++dst;
+            }
+        }
+        m_coords.resize(dst);
+        m_storage.resize(dst);
+        m_pos.back() = detail::stored_cast<typename P::value_type>(dst);
+    }
+
+    // Appends the (index, value) pairs in [first, last), then sorts once and
+    // merges the result with the existing entries. Values sharing the same
+    // index are summed. The overall complexity is O(N log N) instead of the
+    // O(N^2) of repeated calls to insert_element.
+    template <class P, class C, class ST, class IT>
+    template <class It>
+    inline void xcoo_scheme<P, C, ST, IT>::insert_elements(It first, It last)
+    {
+        std::size_t old_size = m_coords.size();
+        for (; first != last; ++first)
+        {
+            m_coords.push_back(detail::convert_index<stored_index_type>(std::get<0>(*first)));
+            m_storage.push_back(std::get<1>(*first));
+        }
+
+        std::vector<std::size_t> perm(m_coords.size());
+        std::iota(perm.begin(), perm.end(), std::size_t(0));
+        auto comp = [this](std::size_t lhs, std::size_t rhs) { return m_coords[lhs] < m_coords[rhs]; };
+        auto middle = perm.begin() + static_cast<std::ptrdiff_t>(old_size);
+        std::stable_sort(middle, perm.end(), comp);
+        std::inplace_merge(perm.begin(), middle, perm.end(), comp);
+
+        coordinate_type new_coords;
+        storage_type new_storage;
+        new_coords.reserve(perm.size());
+        new_storage.reserve(perm.size());
+        for (auto p: perm)
+        {
+            if (!new_coords.empty() && new_coords.back() == m_coords[p])
+            {
+                new_storage.back() += m_storage[p];
+            }
+            else
+            {
+                new_coords.push_back(std::move(m_coords[p]));
+                new_storage.push_back(m_storage[p]);
+            }
+        }
+
+        using std::swap;
+        swap(m_coords, new_coords);
+        swap(m_storage, new_storage);
+        m_pos.back() = detail::stored_cast<typename P::value_type>(m_coords.size());
+    }
+
     template <class P, class C, class ST, class IT>
     template <class strides_type, class shape_type>
     inline void xcoo_scheme<P, C, ST, IT>::update_entries(const strides_type& old_strides,
@@ -265,17 +366,35 @@ namespace xt
         {
             std::size_t offset = element_offset<std::size_t>(old_strides, old_index.cbegin(), old_index.cend());
             index_type new_index = unravel_from_strides(offset, new_strides);
-            new_coords.push_back(new_index);
+            new_coords.push_back(detail::convert_index<stored_index_type>(new_index));
         }
         using std::swap;
         swap(m_coords, new_coords);
     }
 
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order; the elements
+    // are appended, so the complexity is linear.
+    template <class P, class C, class ST, class IT>
+    template <class It>
+    inline void xcoo_scheme<P, C, ST, IT>::assign_nz(It first, It last)
+    {
+        m_coords.clear();
+        m_storage.clear();
+        for (; first != last; ++first)
+        {
+            m_coords.push_back(detail::convert_index<stored_index_type>(first.index()));
+            m_storage.push_back(*first);
+        }
+        m_pos.back() = detail::stored_cast<typename P::value_type>(m_coords.size());
+    }
+
     template <class P, class C, class ST, class IT>
     inline auto xcoo_scheme<P, C, ST, IT>::find_element_impl(const index_type& index) const -> const_pointer
     {
-        auto it = std::find(m_coords.begin(), m_coords.end(), index);
-        return it == m_coords.end() ? nullptr : &*(m_storage.begin() + (it - m_coords.begin()));
+        const auto& key = detail::convert_index<stored_index_type>(index);
+        auto it = std::lower_bound(m_coords.begin(), m_coords.end(), key);
+        return (it == m_coords.end() || *it != key) ? nullptr : &*(m_storage.begin() + (it - m_coords.begin()));
     }
 
     template <class P, class C, class ST, class IT>
@@ -391,7 +510,7 @@ namespace xt
     template <class S>
     inline auto xcoo_scheme_nz_iterator<S>::index() const -> const index_type&
     {
-        return *m_cit;
+        return detail::convert_index(*m_cit, m_current_index);
     }
 
     template <class S>
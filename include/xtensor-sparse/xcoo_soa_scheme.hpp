@@ -0,0 +1,621 @@
+#ifndef XSPARSE_COO_SOA_SCHEME_HPP
+#define XSPARSE_COO_SOA_SCHEME_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xstorage.hpp>
+#include <xtensor/xstrides.hpp>
+#include <xtensor/xutils.hpp>
+
+#include "xutils.hpp"
+
+namespace xt
+{
+    template <class scheme>
+    class xcoo_soa_scheme_nz_iterator;
+
+    /*******************
+     * xcoo_soa_scheme *
+     *******************/
+
+    // Structure-of-arrays variant of xcoo_scheme: coordinate()[d] holds the
+    // d-th coordinate of every non-zero in a single contiguous array, instead
+    // of one index per non-zero. Entries are kept sorted in row-major order,
+    // searches narrow the candidate range one dimension at a time with binary
+    // searches over flat integer arrays, and no per-element index object is
+    // allocated.
+    template <class C, class ST, class IT = svector<std::size_t>>
+    class xcoo_soa_scheme
+    {
+    public:
+
+        using self_type = xcoo_soa_scheme<C, ST, IT>;
+        using coordinate_type = C;
+        using storage_type = ST;
+        using index_type = IT;
+        using coordinate_array_type = typename coordinate_type::value_type;
+        using stored_index_type = typename coordinate_array_type::value_type;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using nz_iterator = xcoo_soa_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xcoo_soa_scheme_nz_iterator<const self_type>;
+
+        xcoo_soa_scheme();
+        xcoo_soa_scheme(coordinate_type coords, storage_type storage);
+
+        const coordinate_type& coordinate() const;
+        const storage_type& storage() const;
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class It>
+        void insert_elements(It first, It last);
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+    private:
+
+        std::pair<std::size_t, bool> search(const index_type& index) const;
+        template <class I>
+        void push_back(const I& index, const_reference value);
+        bool less(std::size_t lhs, std::size_t rhs) const;
+        bool equal(std::size_t lhs, std::size_t rhs) const;
+
+        coordinate_type m_coords;
+        storage_type m_storage;
+
+        friend class xcoo_soa_scheme_nz_iterator<self_type>;
+        friend class xcoo_soa_scheme_nz_iterator<const self_type>;
+    };
+
+    /***************************
+     * xdefault_coo_soa_scheme *
+     ***************************/
+
+    // The scheme stores no position, P is only accepted for consistency with
+    // the other schemes.
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_coo_soa_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xcoo_soa_scheme<std::vector<std::vector<coordinate_value_type>>,
+                                     storage_type,
+                                     index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_coo_soa_scheme_t = typename xdefault_coo_soa_scheme<T, I, C, P>::type;
+
+    /*******************************
+     * xcoo_soa_scheme_nz_iterator *
+     *******************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xcoo_soa_scheme_storage_type
+        {
+            using storage_type = typename scheme::storage_type;
+            using value_iterator = typename storage_type::iterator;
+        };
+
+        template <class scheme>
+        struct xcoo_soa_scheme_storage_type<const scheme>
+        {
+            using storage_type = typename scheme::storage_type;
+            using value_iterator = typename storage_type::const_iterator;
+        };
+
+        template <class scheme>
+        struct xcoo_soa_scheme_nz_iterator_types : xcoo_soa_scheme_storage_type<scheme>
+        {
+            using base_type = xcoo_soa_scheme_storage_type<scheme>;
+            using index_type = typename scheme::index_type;
+            using coordinate_type = typename scheme::coordinate_type;
+            using value_iterator = typename base_type::value_iterator;
+            using value_type = typename value_iterator::value_type;
+            using reference = typename value_iterator::reference;
+            using pointer = typename value_iterator::pointer;
+            using difference_type = typename value_iterator::difference_type;
+        };
+    }
+
+    // The iterator walks the values; the index of the current element is
+    // gathered from the coordinate arrays only when index() is called.
+    template <class scheme>
+    class xcoo_soa_scheme_nz_iterator : xtl::xrandom_access_iterator_base3<xcoo_soa_scheme_nz_iterator<scheme>,
+                                                                           detail::xcoo_soa_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xcoo_soa_scheme_nz_iterator<scheme>;
+        using scheme_type = scheme;
+        using iterator_types = detail::xcoo_soa_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using coordinate_type = typename iterator_types::coordinate_type;
+        using value_iterator = typename iterator_types::value_iterator;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+        xcoo_soa_scheme_nz_iterator();
+        xcoo_soa_scheme_nz_iterator(scheme& s, value_iterator vit);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+        static const value_type ZERO;
+
+    private:
+
+        scheme_type* p_scheme;
+        value_iterator m_vit;
+        mutable index_type m_current_index;
+    };
+
+    template <class S>
+    bool operator==(const xcoo_soa_scheme_nz_iterator<S>& lhs,
+                    const xcoo_soa_scheme_nz_iterator<S>& rhs);
+
+    template <class S>
+    bool operator<(const xcoo_soa_scheme_nz_iterator<S>& lhs,
+                   const xcoo_soa_scheme_nz_iterator<S>& rhs);
+
+    /**********************************
+     * xcoo_soa_scheme implementation *
+     **********************************/
+
+    template <class C, class ST, class IT>
+    inline xcoo_soa_scheme<C, ST, IT>::xcoo_soa_scheme()
+    {
+    }
+
+    // Builds the scheme from already compacted arrays: coords holds one array
+    // per dimension, and the entries must be sorted in row-major order.
+    template <class C, class ST, class IT>
+    inline xcoo_soa_scheme<C, ST, IT>::xcoo_soa_scheme(coordinate_type coords, storage_type storage)
+        : m_coords(std::move(coords))
+        , m_storage(std::move(storage))
+    {
+        XTENSOR_ASSERT(std::all_of(m_coords.cbegin(), m_coords.cend(),
+                                   [this](const auto& c) { return c.size() == m_storage.size(); }));
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::coordinate() const -> const coordinate_type&
+    {
+        return m_coords;
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(static_cast<const self_type&>(*this).find_element(index));
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::find_element(const index_type& index) const -> const_pointer
+    {
+        auto res = search(index);
+        return res.second ? &*(m_storage.cbegin() + static_cast<std::ptrdiff_t>(res.first)) : nullptr;
+    }
+
+    template <class C, class ST, class IT>
+    inline void xcoo_soa_scheme<C, ST, IT>::insert_element(const index_type& index, const_reference value)
+    {
+        if (m_coords.empty())
+        {
+            m_coords.resize(index.size());
+        }
+        XTENSOR_ASSERT(m_coords.size() == index.size());
+
+        auto res = search(index);
+        auto diff = static_cast<std::ptrdiff_t>(res.first);
+        if (res.second)
+        {
+            *(m_storage.begin() + diff) = value;
+            return;
+        }
+        for (std::size_t d = 0; d < m_coords.size(); ++d)
+        {
+            m_coords[d].insert(m_coords[d].cbegin() + diff, detail::stored_cast<stored_index_type>(index[d]));
+        }
+        m_storage.insert(m_storage.cbegin() + diff, value);
+    }
+
+    template <class C, class ST, class IT>
+    inline void xcoo_soa_scheme<C, ST, IT>::remove_element(const index_type& index)
+    {
+        auto res = search(index);
+        if (res.second)
+        {
+            auto diff = static_cast<std::ptrdiff_t>(res.first);
+            for (auto& c: m_coords)
+            {
+                c.erase(c.cbegin() + diff);
+            }
+            m_storage.erase(m_storage.cbegin() + diff);
+        }
+    }
+
+    template <class C, class ST, class IT>
+    inline void xcoo_soa_scheme<C, ST, IT>::prune(value_type tolerance)
+    {
+        std::size_t dst = 0;
+        for (std::size_t i = 0; i < m_storage.size(); ++i)
+        {
+            if (std::abs(m_storage[i]) > tolerance)
+            {
+                if (dst != i)
+                {
+                    for (auto& c: m_coords)
+                    {
+                        c[dst] = c[i];
+                    }
+                    m_storage[dst] = m_storage[i];
+                }
+                ++dst;
+            }
+        }
+        for (auto& c: m_coords)
+        {
+            c.resize(dst);
+        }
+        m_storage.resize(dst);
+    }
+
+    // Same algorithm as xcoo_scheme::insert_elements: the new entries are
+    // appended, sorted once and merged with the existing ones, values sharing
+    // the same index are summed.
+    template <class C, class ST, class IT>
+    template <class It>
+    inline void xcoo_soa_scheme<C, ST, IT>::insert_elements(It first, It last)
+    {
+        std::size_t old_size = m_storage.size();
+        for (; first != last; ++first)
+        {
+            push_back(std::get<0>(*first), std::get<1>(*first));
+        }
+
+        std::vector<std::size_t> perm(m_storage.size());
+        std::iota(perm.begin(), perm.end(), std::size_t(0));
+        auto comp = [this](std::size_t lhs, std::size_t rhs) { return less(lhs, rhs); };
+        auto middle = perm.begin() + static_cast<std::ptrdiff_t>(old_size);
+        std::stable_sort(middle, perm.end(), comp);
+        std::inplace_merge(perm.begin(), middle, perm.end(), comp);
+
+        coordinate_type new_coords(m_coords.size());
+        storage_type new_storage;
+        for (auto& c: new_coords)
+        {
+            c.reserve(perm.size());
+        }
+        new_storage.reserve(perm.size());
+        std::size_t prev = perm.size();
+        for (auto p: perm)
+        {
+            if (prev != perm.size() && equal(prev, p))
+            {
+                new_storage.back() += m_storage[p];
+            }
+            else
+            {
+                for (std::size_t d = 0; d < m_coords.size(); ++d)
+                {
+                    new_coords[d].push_back(m_coords[d][p]);
+                }
+                new_storage.push_back(m_storage[p]);
+                prev = p;
+            }
+        }
+
+        using std::swap;
+        swap(m_coords, new_coords);
+        swap(m_storage, new_storage);
+    }
+
+    template <class C, class ST, class IT>
+    template <class strides_type, class shape_type>
+    inline void xcoo_soa_scheme<C, ST, IT>::update_entries(const strides_type& old_strides,
+                                                           const strides_type& new_strides,
+                                                           const shape_type&)
+    {
+        coordinate_type new_coords(new_strides.size());
+        for (auto& c: new_coords)
+        {
+            c.reserve(m_storage.size());
+        }
+
+        index_type old_index = xtl::make_sequence<index_type>(m_coords.size());
+        for (std::size_t i = 0; i < m_storage.size(); ++i)
+        {
+            for (std::size_t d = 0; d < m_coords.size(); ++d)
+            {
+                old_index[d] = m_coords[d][i];
+            }
+            std::size_t offset = element_offset<std::size_t>(old_strides, old_index.cbegin(), old_index.cend());
+            index_type new_index = unravel_from_strides(offset, new_strides);
+            for (std::size_t d = 0; d < new_coords.size(); ++d)
+            {
+                new_coords[d].push_back(detail::stored_cast<stored_index_type>(new_index[d]));
+            }
+        }
+        using std::swap;
+        swap(m_coords, new_coords);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order; the elements
+    // are appended, so the complexity is linear.
+    template <class C, class ST, class IT>
+    template <class It>
+    inline void xcoo_soa_scheme<C, ST, IT>::assign_nz(It first, It last)
+    {
+        for (auto& c: m_coords)
+        {
+            c.clear();
+        }
+        m_storage.clear();
+        for (; first != last; ++first)
+        {
+            push_back(first.index(), *first);
+        }
+    }
+
+    // Returns the position of index in the storage and whether it is stored;
+    // if not, the position is the one where index should be inserted. The
+    // range [first, last) of candidates is narrowed by a binary search on the
+    // coordinate array of each dimension, the arrays being sorted within the
+    // range left by the previous dimensions.
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::search(const index_type& index) const -> std::pair<std::size_t, bool>
+    {
+        std::size_t first = 0;
+        std::size_t last = m_storage.size();
+        for (std::size_t d = 0; d < m_coords.size() && first != last; ++d)
+        {
+            const auto& c = m_coords[d];
+            auto value = detail::stored_cast<stored_index_type>(index[d]);
+            auto lower = std::lower_bound(c.cbegin() + static_cast<std::ptrdiff_t>(first),
+                                          c.cbegin() + static_cast<std::ptrdiff_t>(last),
+                                          value);
+            auto upper = std::upper_bound(lower, c.cbegin() + static_cast<std::ptrdiff_t>(last), value);
+            first = static_cast<std::size_t>(lower - c.cbegin());
+            last = static_cast<std::size_t>(upper - c.cbegin());
+        }
+        return {first, first != last};
+    }
+
+    template <class C, class ST, class IT>
+    template <class I>
+    inline void xcoo_soa_scheme<C, ST, IT>::push_back(const I& index, const_reference value)
+    {
+        if (m_coords.empty())
+        {
+            m_coords.resize(index.size());
+        }
+        XTENSOR_ASSERT(m_coords.size() == index.size());
+        for (std::size_t d = 0; d < m_coords.size(); ++d)
+        {
+            m_coords[d].push_back(detail::stored_cast<stored_index_type>(index[d]));
+        }
+        m_storage.push_back(value);
+    }
+
+    template <class C, class ST, class IT>
+    inline bool xcoo_soa_scheme<C, ST, IT>::less(std::size_t lhs, std::size_t rhs) const
+    {
+        for (const auto& c: m_coords)
+        {
+            if (c[lhs] != c[rhs])
+            {
+                return c[lhs] < c[rhs];
+            }
+        }
+        return false;
+    }
+
+    template <class C, class ST, class IT>
+    inline bool xcoo_soa_scheme<C, ST, IT>::equal(std::size_t lhs, std::size_t rhs) const
+    {
+        return std::all_of(m_coords.cbegin(), m_coords.cend(),
+                           [lhs, rhs](const auto& c) { return c[lhs] == c[rhs]; });
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, m_storage.begin());
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, m_storage.end());
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_storage.cbegin());
+    }
+
+    template <class C, class ST, class IT>
+    inline auto xcoo_soa_scheme<C, ST, IT>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_storage.cend());
+    }
+
+    /**********************************************
+     * xcoo_soa_scheme_nz_iterator implementation *
+     **********************************************/
+
+    template <class scheme>
+    const typename xcoo_soa_scheme_nz_iterator<scheme>::value_type
+    xcoo_soa_scheme_nz_iterator<scheme>::ZERO = 0;
+
+    template <class S>
+    inline xcoo_soa_scheme_nz_iterator<S>::xcoo_soa_scheme_nz_iterator()
+        : p_scheme(nullptr)
+    {
+    }
+
+    template <class S>
+    inline xcoo_soa_scheme_nz_iterator<S>::xcoo_soa_scheme_nz_iterator(S& s, value_iterator vit)
+        : p_scheme(&s)
+        , m_vit(vit)
+        , m_current_index(xtl::make_sequence<index_type>(s.m_coords.size()))
+    {
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::operator++() -> self_type&
+    {
+        ++m_vit;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::operator--() -> self_type&
+    {
+        --m_vit;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::operator+=(difference_type n) -> self_type&
+    {
+        m_vit += n;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::operator-=(difference_type n) -> self_type&
+    {
+        m_vit -= n;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return m_vit - rhs.m_vit;
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::operator*() const -> reference
+    {
+        return *m_vit;
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::operator->() const -> pointer
+    {
+        return &(*m_vit);
+    }
+
+    template <class S>
+    inline auto xcoo_soa_scheme_nz_iterator<S>::index() const -> const index_type&
+    {
+        const auto& coords = p_scheme->m_coords;
+        auto i = static_cast<std::size_t>(m_vit - p_scheme->m_storage.begin());
+        for (std::size_t d = 0; d < coords.size(); ++d)
+        {
+            m_current_index[d] = coords[d][i];
+        }
+        return m_current_index;
+    }
+
+    template <class S>
+    inline bool xcoo_soa_scheme_nz_iterator<S>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_vit == rhs.m_vit;
+    }
+
+    template <class S>
+    inline bool xcoo_soa_scheme_nz_iterator<S>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_vit < rhs.m_vit;
+    }
+
+    template <class S>
+    inline bool operator==(const xcoo_soa_scheme_nz_iterator<S>& lhs,
+                           const xcoo_soa_scheme_nz_iterator<S>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class S>
+    inline bool operator<(const xcoo_soa_scheme_nz_iterator<S>& lhs,
+                          const xcoo_soa_scheme_nz_iterator<S>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
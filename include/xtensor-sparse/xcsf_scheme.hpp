@@ -1,14 +1,22 @@
 #ifndef XSPARSE_CSF_SCHEME_HPP
 #define XSPARSE_CSF_SCHEME_HPP
 
+#include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <limits>
+#include <numeric>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 
 #include <xtensor/xstorage.hpp>
 #include <xtensor/xstrides.hpp>
 
+#include "xutils.hpp"
 
 namespace xt
 {
@@ -49,12 +57,19 @@ namespace xt
         const_pointer find_element(const index_type& index) const;
         void insert_element(const index_type& index, const_reference value);
         void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class It>
+        void insert_elements(It first, It last);
 
         template <class strides_type, class shape_type>
         void update_entries(const strides_type& old_strides,
                             const strides_type& new_strides,
                             const shape_type& new_shape);
 
+        template <class It>
+        void assign_nz(It first, It last);
+
         nz_iterator nz_begin();
         nz_iterator nz_end();
         const_nz_iterator nz_begin() const;
@@ -64,8 +79,14 @@ namespace xt
 
     private:
 
+        using entry_type = std::pair<index_type, value_type>;
+
         const_pointer find_element_impl(const index_type& index) const;
 
+        template <class I>
+        void push_back(const I& index, const_reference value);
+        void assign_sorted(const std::vector<entry_type>& entries);
+
         position_type m_pos;
         coordinate_type m_coords;
         storage_type m_storage;
@@ -78,21 +99,22 @@ namespace xt
      * xdefault_csf_scheme *
      ***********************/
 
-    template <class T, class I>
+    template <class T, class I, class C = typename I::value_type, class P = C>
     struct xdefault_csf_scheme
     {
         using index_type = I;
         using value_type = T;
-        using size_type = typename index_type::value_type;
+        using coordinate_value_type = C;
+        using position_value_type = P;
         using storage_type = std::vector<value_type>;
-        using type = xcsf_scheme<std::vector<std::vector<size_type>>,
-                                 std::vector<std::vector<size_type>>,
+        using type = xcsf_scheme<std::vector<std::vector<position_value_type>>,
+                                 std::vector<std::vector<coordinate_value_type>>,
                                  storage_type,
                                  index_type>;
     };
 
-    template <class T, class I>
-    using xdefault_csf_scheme_t = typename xdefault_csf_scheme<T, I>::type;
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_csf_scheme_t = typename xdefault_csf_scheme<T, I, C, P>::type;
 
     /***************************************
      * xcsf_scheme_nz_iterator declaration *
@@ -240,9 +262,23 @@ namespace xt
                 }
             }
 
+            // Returns the position of value in the fiber [first, last) of the
+            // level coordinates coords, or the position where it should be
+            // inserted, and whether it was found. The coordinates of a fiber
+            // are sorted, hence the binary search.
+            template <class Coord, class V>
+            std::pair<std::size_t, bool> search_fiber(const Coord& coords, std::size_t first, std::size_t last, const V& value)
+            {
+                auto begin = coords.cbegin();
+                auto end = begin + static_cast<std::ptrdiff_t>(last);
+                auto it = std::lower_bound(begin + static_cast<std::ptrdiff_t>(first), end, value);
+                return {static_cast<std::size_t>(it - begin), it != end && *it == value};
+            }
+
             template <class Pos, class Coord, class Index>
             std::size_t insert_index(Pos& pos, Coord& coord, const Index& index)
             {
+                using coordinate_type = typename Coord::value_type::value_type;
                 std::size_t ielem = 0;
                 if (pos.size() == 0)
                 {
@@ -251,22 +287,23 @@ namespace xt
                     for(std::size_t i=0; i<index.size(); ++i)
                     {
                         pos[i] = {0, 1};
-                        coord[i] = {index[i]};
+                        coord[i] = {stored_cast<coordinate_type>(index[i])};
                     }
                 }
                 else
                 {
                     for(std::size_t i=0; i<index.size(); ++i)
                     {
-                        auto it = std::find_if(coord[i].cbegin() + pos[i][ielem], coord[i].cbegin() + pos[i][ielem + 1], [&](auto e){return e >= index[i];});
-                        if (it == coord[i].cbegin() + pos[i][ielem + 1] || *it != index[i])
+                        auto res = search_fiber(coord[i], pos[i][ielem], pos[i][ielem + 1], index[i]);
+                        auto it = coord[i].cbegin() + static_cast<std::ptrdiff_t>(res.first);
+                        if (!res.second)
                         {
                             for(std::size_t j = ielem + 1; j < pos[i].size(); ++j)
                             {
                                 pos[i][j]++;
                             }
                             ielem = static_cast<std::size_t>(it - coord[i].cbegin());
-                            coord[i].insert(it, index[i]);
+                            coord[i].insert(it, stored_cast<coordinate_type>(index[i]));
 
                             for(std::size_t k = i + 1; k < index.size(); ++k)
                             {
@@ -275,12 +312,12 @@ namespace xt
                                 {
                                     pos[k][j]++;
                                 }
-                                coord[k].insert(coord[k].cbegin() + pos[k][ielem], index[k]);
+                                coord[k].insert(coord[k].cbegin() + pos[k][ielem], stored_cast<coordinate_type>(index[k]));
                                 ielem = pos[k][ielem];
                             }
                             return ielem;
                         }
-                        ielem = static_cast<std::size_t>(it - coord[i].cbegin());
+                        ielem = res.first;
                     }
                     return std::numeric_limits<std::size_t>::max();
                 }
@@ -344,32 +381,253 @@ namespace xt
     template <class P, class C, class ST, class IT>
     inline void xcsf_scheme<P, C, ST, IT>::remove_element(const index_type& index)
     {
-        // TODO: implement the version with a real remove inside coord, pos and storage
-        auto elem = find_element(index);
-        if (elem)
+        if (m_pos.size() == 0)
+        {
+            return;
+        }
+
+        // path[i] is the position of index[i] in m_coords[i]
+        std::vector<std::size_t> path(index.size());
+        std::size_t ielem = 0;
+        for (std::size_t i = 0; i < index.size(); ++i)
+        {
+            auto res = detail::csf::search_fiber(m_coords[i], m_pos[i][ielem], m_pos[i][ielem + 1], index[i]);
+            if (!res.second)
+            {
+                return;
+            }
+            ielem = res.first;
+            path[i] = ielem;
+        }
+
+        m_storage.erase(m_storage.begin() + static_cast<std::ptrdiff_t>(path.back()));
+
+        // Remove the leaf, then every ancestor whose fiber becomes empty
+        for (std::size_t i = index.size(); i != std::size_t(0); --i)
+        {
+            std::size_t d = i - 1;
+            std::size_t parent = d == 0 ? 0 : path[d - 1];
+            m_coords[d].erase(m_coords[d].begin() + static_cast<std::ptrdiff_t>(path[d]));
+            for (std::size_t j = parent + 1; j < m_pos[d].size(); ++j)
+            {
+                --m_pos[d][j];
+            }
+
+            if (m_pos[d][parent] != m_pos[d][parent + 1])
+            {
+                break;
+            }
+
+            if (d == 0)
+            {
+                m_pos.clear();
+                m_coords.clear();
+            }
+            else
+            {
+                m_pos[d].erase(m_pos[d].begin() + static_cast<std::ptrdiff_t>(parent + 1));
+            }
+        }
+    }
+
+    // Removes all the stored values whose magnitude is lower than or equal
+    // to tolerance. Levels are compacted from the leaves to the root so that
+    // fibers left empty are dropped in the same pass.
+    template <class P, class C, class ST, class IT>
+    inline void xcsf_scheme<P, C, ST, IT>::prune(value_type tolerance)
+    {
+        if (m_pos.size() == 0)
+        {
+            return;
+        }
+
+        std::vector<char> keep(m_storage.size());
+        std::transform(m_storage.cbegin(), m_storage.cend(), keep.begin(),
+                       [tolerance](const auto& v) { return std::abs(v) > tolerance; });
+
+        std::size_t leaf = m_pos.size() - 1;
+        for (std::size_t i = m_pos.size(); i != std::size_t(0); --i)
+        {
+            std::size_t d = i - 1;
+            auto& pos = m_pos[d];
+            auto& coords = m_coords[d];
+            std::size_t nb_fibers = pos.size() - 1;
+            std::vector<char> keep_parent(nb_fibers);
+
+            std::size_t dst = 0;
+            std::size_t begin = pos[0];
+            for (std::size_t f = 0; f < nb_fibers; ++f)
+            {
+                std::size_t end = pos[f + 1];
+                for (std::size_t k = begin; k < end; ++k)
+                {
+                    if (keep[k])
+                    {
+                        coords[dst] = coords[k];
+                        if (d == leaf)
+                        {
+                            m_storage[dst] = m_storage[k];
+                        }
+                        ++dst;
+                    }
+                }
+                begin = end;
+                pos[f + 1] = detail::stored_cast<typename P::value_type::value_type>(dst);
+                keep_parent[f] = pos[f + 1] != pos[f];
+            }
+            coords.resize(dst);
+            if (d == leaf)
+            {
+                m_storage.resize(dst);
+            }
+
+            std::size_t pdst = 1;
+            for (std::size_t f = 0; f < nb_fibers; ++f)
+            {
+                if (keep_parent[f])
+                {
+                    pos[pdst++] = pos[f + 1];
+                }
+            }
+            pos.resize(pdst);
+            keep = std::move(keep_parent);
+        }
+
+        if (m_pos[0].size() < 2)
+        {
+            m_pos.clear();
+            m_coords.clear();
+        }
+    }
+
+    // Merges the (index, value) pairs of [first, last) with the stored
+    // elements, then rebuilds all the levels in a single pass: the overall
+    // complexity is O(N log N) instead of one insert_element per pair.
+    // Values sharing the same index are summed, as in the COO scheme.
+    template <class P, class C, class ST, class IT>
+    template <class It>
+    inline void xcsf_scheme<P, C, ST, IT>::insert_elements(It first, It last)
+    {
+        std::vector<entry_type> entries;
+        entries.reserve(m_storage.size());
+        for (auto it = nz_cbegin(); it != nz_cend(); ++it)
         {
-            *elem = value_type(0);
+            entries.emplace_back(it.index(), *it);
         }
+        std::size_t old_size = entries.size();
+        for (; first != last; ++first)
+        {
+            entries.emplace_back(detail::convert_index<index_type>(std::get<0>(*first)), std::get<1>(*first));
+        }
+
+        auto comp = [](const entry_type& lhs, const entry_type& rhs) { return lhs.first < rhs.first; };
+        auto middle = entries.begin() + static_cast<std::ptrdiff_t>(old_size);
+        std::stable_sort(middle, entries.end(), comp);
+        std::inplace_merge(entries.begin(), middle, entries.end(), comp);
+        assign_sorted(entries);
     }
 
+    // Reshapes and resizes preserve the row-major offsets of the elements,
+    // hence their order: the levels are rebuilt in a single pass, the
+    // entries being sorted first only if the strides are not row-major.
     template <class P, class C, class ST, class IT>
     template <class strides_type, class shape_type>
     inline void xcsf_scheme<P, C, ST, IT>::update_entries(const strides_type& old_strides,
                                                           const strides_type& new_strides,
                                                           const shape_type&)
     {
-        coordinate_type new_coords;
-        position_type new_pos;
-
-        detail::csf::for_each(m_pos, m_coords, [&](auto index){
+        std::vector<entry_type> entries;
+        entries.reserve(m_storage.size());
+        std::size_t k = 0;
+        detail::csf::for_each(m_pos, m_coords, [&](const auto& index){
             std::size_t offset = element_offset<std::size_t>(old_strides, index.cbegin(), index.cend());
             index_type new_index = unravel_from_strides(offset, new_strides);
-            detail::csf::insert_index(new_pos, new_coords, new_index);
+            entries.emplace_back(std::move(new_index), m_storage[k++]);
         });
 
-        using std::swap;
-        swap(m_pos, new_pos);
-        swap(m_coords, new_coords);
+        auto comp = [](const entry_type& lhs, const entry_type& rhs) { return lhs.first < rhs.first; };
+        if (!std::is_sorted(entries.cbegin(), entries.cend(), comp))
+        {
+            std::stable_sort(entries.begin(), entries.end(), comp);
+        }
+        assign_sorted(entries);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order; every element
+    // is appended in O(dimension).
+    template <class P, class C, class ST, class IT>
+    template <class It>
+    inline void xcsf_scheme<P, C, ST, IT>::assign_nz(It first, It last)
+    {
+        m_pos.clear();
+        m_coords.clear();
+        m_storage.clear();
+        for (; first != last; ++first)
+        {
+            push_back(first.index(), *first);
+        }
+    }
+
+    // Appends an element greater than the stored ones in row-major order.
+    // It shares with the last element the fibers of the levels before the
+    // first coordinate that differs, and opens new fibers below it.
+    template <class P, class C, class ST, class IT>
+    template <class I>
+    inline void xcsf_scheme<P, C, ST, IT>::push_back(const I& index, const_reference value)
+    {
+        using coordinate_value_type = typename C::value_type::value_type;
+        std::size_t dim = index.size();
+        std::size_t k = 0;
+        if (m_pos.empty())
+        {
+            m_pos.resize(dim);
+            m_coords.resize(dim);
+            m_pos[0].push_back(0);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                m_pos[d].push_back(0);
+            }
+        }
+        else
+        {
+            XTENSOR_ASSERT(m_pos.size() == dim);
+            while (k < dim && m_coords[k].back() == index[k])
+            {
+                ++k;
+            }
+            XTENSOR_ASSERT(k < dim);
+        }
+
+        ++m_pos[k].back();
+        m_coords[k].push_back(detail::stored_cast<coordinate_value_type>(index[k]));
+        for (std::size_t d = k + 1; d < dim; ++d)
+        {
+            m_pos[d].push_back(m_pos[d].back() + 1);
+            m_coords[d].push_back(detail::stored_cast<coordinate_value_type>(index[d]));
+        }
+        m_storage.push_back(value);
+    }
+
+    // Replaces the stored elements with entries, which must be sorted in
+    // row-major order; values of consecutive equal indices are summed.
+    template <class P, class C, class ST, class IT>
+    inline void xcsf_scheme<P, C, ST, IT>::assign_sorted(const std::vector<entry_type>& entries)
+    {
+        m_pos.clear();
+        m_coords.clear();
+        m_storage.clear();
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            if (i != 0 && entries[i].first == entries[i - 1].first)
+            {
+                m_storage.back() += entries[i].second;
+            }
+            else
+            {
+                push_back(entries[i].first, entries[i].second);
+            }
+        }
     }
 
     template <class P, class C, class ST, class IT>
@@ -383,23 +641,12 @@ namespace xt
         std::size_t ielem = 0;
         for(std::size_t i=0; i<index.size(); ++i)
         {
-            auto it = std::find(m_coords[i].cbegin() + m_pos[i][ielem], m_coords[i].cbegin() + m_pos[i][ielem + 1], index[i]);
-            if (it != m_coords[i].cbegin() + m_pos[i][ielem + 1])
-            {
-                if (i == index.size() - 1)
-                {
-                    std::ptrdiff_t dst = std::distance(m_coords[i].cbegin(), it);
-                    return &(*(m_storage.begin() + dst));
-                }
-                else
-                {
-                    ielem = static_cast<std::size_t>(it - m_coords[i].cbegin());
-                }
-            }
-            else
+            auto res = detail::csf::search_fiber(m_coords[i], m_pos[i][ielem], m_pos[i][ielem + 1], index[i]);
+            if (!res.second)
             {
                 return nullptr;
             }
+            ielem = res.first;
         }
         return &m_storage[ielem];
     }
@@ -421,6 +668,13 @@ namespace xt
     template <class P, class C, class ST, class IT>
     inline auto xcsf_scheme<P, C, ST, IT>::nz_end() -> nz_iterator
     {
+        // The end iterator points past the last leaf coordinate, which
+        // does not exist when the scheme is empty.
+        if (m_storage.empty())
+        {
+            return nz_begin();
+        }
+
         std::size_t dim =  m_pos.size();
         typename nz_iterator::position_iterator pos_index(dim);
         typename nz_iterator::coordinate_iterator coord_index(dim);
@@ -463,6 +717,13 @@ namespace xt
     template <class P, class C, class ST, class IT>
     inline auto xcsf_scheme<P, C, ST, IT>::nz_cend() const -> const_nz_iterator
     {
+        // The end iterator points past the last leaf coordinate, which
+        // does not exist when the scheme is empty.
+        if (m_storage.empty())
+        {
+            return nz_cbegin();
+        }
+
         std::size_t dim =  m_pos.size();
         typename const_nz_iterator::position_iterator pos_index(dim);
         typename const_nz_iterator::coordinate_iterator coord_index(dim);
@@ -500,7 +761,6 @@ namespace xt
         , m_current_index(xtl::make_sequence<index_type>(m_pos_index.size()))
         , p_scheme(&s)
     {
-        update_current_index();
     }
 
     template <class scheme>
@@ -602,13 +862,16 @@ namespace xt
     template <class scheme>
     inline bool xcsf_scheme_nz_iterator<scheme>::equal(const self_type& rhs) const
     {
-        return p_scheme == rhs.p_scheme && m_coord_index.back() == rhs.m_coord_index.back();
+        // Iterators on an empty scheme hold no coordinate iterator.
+        return p_scheme == rhs.p_scheme &&
+            (m_coord_index.empty() || m_coord_index.back() == rhs.m_coord_index.back());
     }
 
     template <class scheme>
     inline bool xcsf_scheme_nz_iterator<scheme>::less_than(const self_type& rhs) const
     {
-        return p_scheme == rhs.p_scheme && m_coord_index.back() < rhs.m_coord_index.back();
+        return p_scheme == rhs.p_scheme &&
+            !m_coord_index.empty() && m_coord_index.back() < rhs.m_coord_index.back();
     }
 
     template <class scheme>
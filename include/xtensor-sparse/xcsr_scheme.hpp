@@ -1,11 +1,22 @@
 #ifndef XSPARSE_CSR_SCHEME_HPP
 #define XSPARSE_CSR_SCHEME_HPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xlayout.hpp>
 #include <xtensor/xstorage.hpp>
 #include <xtensor/xstrides.hpp>
 
+#include "xutils.hpp"
 
 namespace xt
 {
@@ -16,26 +27,37 @@ namespace xt
      * xcsr_scheme declaration *
      ***************************/
 
-    template <class P, class C, class ST>
+    // Compressed sparse 2-D scheme. With L == layout_type::row_major (CSR),
+    // position() is indexed by rows and coordinate() holds column indices;
+    // with L == layout_type::column_major (CSC), the roles of rows and
+    // columns are swapped. Non-zeros are iterated in the layout order.
+    template <class P, class C, class ST, class IT = std::array<std::size_t, 2>, layout_type L = layout_type::row_major>
     class xcsr_scheme
     {
     public:
 
-        using self_type = xcsr_scheme<P, C, ST>;
+        using self_type = xcsr_scheme<P, C, ST, IT, L>;
         using position_type = P;
         using coordinate_type = C;
         using storage_type = ST;
-        using index_type = std::array<std::size_t, 2>;
+        using index_type = IT;
 
         using value_type = typename storage_type::value_type;
         using reference = typename storage_type::reference;
         using const_reference = typename storage_type::const_reference;
         using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
 
         using nz_iterator = xcsr_scheme_nz_iterator<self_type>;
         using const_nz_iterator = xcsr_scheme_nz_iterator<const self_type>;
 
+        static constexpr layout_type nz_layout = L;
+        static constexpr std::size_t outer_axis = L == layout_type::row_major ? 0u : 1u;
+        static constexpr std::size_t inner_axis = 1u - outer_axis;
+
+        xcsr_scheme();
         xcsr_scheme(std::size_t size);
+        xcsr_scheme(position_type pos, coordinate_type coords, storage_type storage);
 
         const position_type& position() const;
         const coordinate_type& coordinate() const;
@@ -44,14 +66,19 @@ namespace xt
         storage_type& storage();
 
         pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
         void insert_element(const index_type& index, const_reference value);
         void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
 
         template <class strides_type, class shape_type>
         void update_entries(const strides_type& old_strides,
                             const strides_type& new_strides,
                             const shape_type& new_shape);
 
+        template <class It>
+        void assign_nz(It first, It last);
+
         nz_iterator nz_begin();
         nz_iterator nz_end();
         const_nz_iterator nz_begin() const;
@@ -61,6 +88,8 @@ namespace xt
 
     private:
 
+        const_pointer find_element_impl(const index_type& index) const;
+
         position_type m_pos;
         coordinate_type m_coords;
         storage_type m_storage;
@@ -69,6 +98,51 @@ namespace xt
         friend class xcsr_scheme_nz_iterator<const self_type>;
     };
 
+    template <class P, class C, class ST, class IT = std::array<std::size_t, 2>>
+    using xcsc_scheme = xcsr_scheme<P, C, ST, IT, layout_type::column_major>;
+
+    /***********************
+     * xdefault_csr_scheme *
+     ***********************/
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_csr_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xcsr_scheme<std::vector<position_value_type>,
+                                 std::vector<coordinate_value_type>,
+                                 storage_type,
+                                 index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_csr_scheme_t = typename xdefault_csr_scheme<T, I, C, P>::type;
+
+    /***********************
+     * xdefault_csc_scheme *
+     ***********************/
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_csc_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xcsc_scheme<std::vector<position_value_type>,
+                                 std::vector<coordinate_value_type>,
+                                 storage_type,
+                                 index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_csc_scheme_t = typename xdefault_csc_scheme<T, I, C, P>::type;
+
     /***************************************
      * xcsr_scheme_nz_iterator declaration *
      ***************************************/
@@ -149,6 +223,9 @@ namespace xt
     private:
 
         index_type& update_current_index() const;
+        void update_position_forward();
+        void update_position_backward();
+        void update_position(difference_type n);
 
         position_iterator m_pit;
         coordinate_iterator m_cit;
@@ -171,19 +248,20 @@ namespace xt
     {
         namespace csr
         {
-            template <class Pos, class Coord, class Index>
-            std::size_t insert_index(Pos& pos, Coord& coord, const Index& index)
+            template <class Pos, class Coord>
+            std::size_t insert_index(Pos& pos, Coord& coord, std::size_t outer, std::size_t inner)
             {
-                std::size_t ielem = index[0];
-                auto it = std::find_if(coord.cbegin() + static_cast<std::ptrdiff_t>(pos[ielem]), coord.cbegin() + static_cast<std::ptrdiff_t>(pos[ielem + 1]), [&](auto e){return e >= index[1];});
-                if (it == coord.cbegin() + static_cast<std::ptrdiff_t>(pos[ielem + 1]) || *it != index[1])
+                auto first = coord.cbegin() + static_cast<std::ptrdiff_t>(pos[outer]);
+                auto last = coord.cbegin() + static_cast<std::ptrdiff_t>(pos[outer + 1]);
+                auto it = std::find_if(first, last, [&](auto e){return e >= inner;});
+                if (it == last || *it != inner)
                 {
-                    for(std::size_t j = ielem + 1; j < pos.size(); ++j)
+                    for(std::size_t j = outer + 1; j < pos.size(); ++j)
                     {
                         pos[j]++;
                     }
                     auto dst = static_cast<std::size_t>(std::distance(coord.cbegin(), it));
-                    coord.insert(it, index[1]);
+                    coord.insert(it, stored_cast<typename Coord::value_type>(inner));
                     return dst;
                 }
                 return std::numeric_limits<std::size_t>::max();
@@ -191,55 +269,69 @@ namespace xt
         }
     }
 
-    template <class P, class C, class ST>
-    inline xcsr_scheme<P, C, ST>::xcsr_scheme(std::size_t size): m_pos(size + 1, 0)
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline xcsr_scheme<P, C, ST, IT, L>::xcsr_scheme()
+        : xcsr_scheme(0u)
     {
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::position() const -> const position_type&
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline xcsr_scheme<P, C, ST, IT, L>::xcsr_scheme(std::size_t size)
+        : m_pos(size + 1, 0)
+    {
+    }
+
+    // Builds the scheme from already compressed arrays: pos holds one more
+    // entry than the compressed dimension and coordinates must be sorted
+    // within each fiber.
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline xcsr_scheme<P, C, ST, IT, L>::xcsr_scheme(position_type pos, coordinate_type coords, storage_type storage)
+        : m_pos(std::move(pos))
+        , m_coords(std::move(coords))
+        , m_storage(std::move(storage))
+    {
+        XTENSOR_ASSERT(!m_pos.empty());
+        XTENSOR_ASSERT(m_pos.back() == m_coords.size());
+        XTENSOR_ASSERT(m_coords.size() == m_storage.size());
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::position() const -> const position_type&
     {
         return m_pos;
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::coordinate() const -> const coordinate_type&
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::coordinate() const -> const coordinate_type&
     {
         return m_coords;
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::storage() const -> const storage_type&
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::storage() const -> const storage_type&
     {
         return m_storage;
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::find_element(const index_type& index) -> pointer
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::find_element(const index_type& index) -> pointer
     {
-        if (m_pos.size() == 0 || m_pos[index[0]] == m_pos[index[0]+1])
-        {
-            return nullptr;
-        }
-
-        std::size_t ielem = index[0];
-        auto it = std::find(m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[ielem]), m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[ielem + 1]), index[1]);
-        if (it != m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[ielem + 1]))
-        {
-            std::ptrdiff_t dst = std::distance(m_coords.cbegin(), it);
-            return &(*(m_storage.begin() + dst));
-        }
+        return const_cast<pointer>(find_element_impl(index));
+    }
 
-        return nullptr;
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::find_element(const index_type& index) const -> const_pointer
+    {
+        return find_element_impl(index);
     }
 
-    template <class P, class C, class ST>
-    inline void xcsr_scheme<P, C, ST>::insert_element(const index_type& index, const_reference value)
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline void xcsr_scheme<P, C, ST, IT, L>::insert_element(const index_type& index, const_reference value)
     {
         XTENSOR_ASSERT(index.size() == 2);
-        XTENSOR_ASSERT(m_pos.size() - 1 > index[0]);
+        XTENSOR_ASSERT(m_pos.size() - 1 > index[outer_axis]);
 
-        auto ielem = detail::csr::insert_index(m_pos, m_coords, index);
+        auto ielem = detail::csr::insert_index(m_pos, m_coords, index[outer_axis], index[inner_axis]);
         XTENSOR_ASSERT(ielem != std::numeric_limits<std::size_t>::max());
 
         if (ielem == m_storage.size())
@@ -253,86 +345,226 @@ namespace xt
 
     }
 
-    template <class P, class C, class ST>
-    inline void xcsr_scheme<P, C, ST>::remove_element(const index_type& index)
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline void xcsr_scheme<P, C, ST, IT, L>::remove_element(const index_type& index)
     {
-        // TODO: implement the version with a real remove inside coord, pos and storage
-        auto elem = find_element(index);
-        if (elem)
+        std::size_t ielem = index[outer_axis];
+        auto first = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[ielem]);
+        auto last = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[ielem + 1]);
+        auto it = std::lower_bound(first, last, index[inner_axis]);
+        if (it != last && *it == index[inner_axis])
         {
-            *elem = value_type(0);
+            auto dst = std::distance(m_coords.begin(), it);
+            m_coords.erase(it);
+            m_storage.erase(m_storage.begin() + dst);
+            for (std::size_t j = ielem + 1; j < m_pos.size(); ++j)
+            {
+                --m_pos[j];
+            }
         }
     }
 
-    template <class P, class C, class ST>
-    template <class strides_type, class shape_type>
-    inline void xcsr_scheme<P, C, ST>::update_entries(const strides_type& old_strides,
-                                                      const strides_type& new_strides,
-                                                      const shape_type& new_shape)
+    // Removes all the stored values whose magnitude is lower than or equal
+    // to tolerance, compacting coordinates and storage in a single pass.
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline void xcsr_scheme<P, C, ST, IT, L>::prune(value_type tolerance)
     {
-        coordinate_type new_coords;
-        position_type new_pos(new_shape[0] + 1, 0);
-        index_type old_index;
+        std::size_t dst = 0;
+        std::size_t begin = m_pos[0];
+        for (std::size_t i = 0; i + 1 < m_pos.size(); ++i)
+        {
+            std::size_t end = m_pos[i + 1];
+            for (std::size_t j = begin; j < end; ++j)
+            {
+                if (std::abs(m_storage[j]) > tolerance)
+                {
+                    m_coords[dst] = m_coords[j];
+                    m_storage[dst] = m_storage[j];
+                    ++dst;
+                }
+            }
+            begin = end;
+            m_pos[i + 1] = detail::stored_cast<typename P::value_type>(dst);
+        }
+        m_coords.resize(dst);
+        m_storage.resize(dst);
+    }
 
-        for(std::size_t i = 0; i < m_pos.size() - 1; ++i)
+    // The elements are moved to their new (outer, inner) coordinates with two
+    // passes of a stable counting sort, by inner then by outer coordinate,
+    // so that a reshape costs O(nnz + rows + columns) whatever the order in
+    // which the old layout visits the new coordinates.
+    template <class P, class C, class ST, class IT, layout_type L>
+    template <class strides_type, class shape_type>
+    inline void xcsr_scheme<P, C, ST, IT, L>::update_entries(const strides_type& old_strides,
+                                                             const strides_type& new_strides,
+                                                             const shape_type& new_shape)
+    {
+        XTENSOR_ASSERT(new_shape.size() == 2);
+        using size_type = typename position_type::value_type;
+
+        std::size_t nnz = m_storage.size();
+        std::vector<std::size_t> outer(nnz);
+        std::vector<std::size_t> inner(nnz);
+        std::array<std::size_t, 2> old_index;
+        for (std::size_t i = 0; i + 1 < m_pos.size(); ++i)
         {
-            old_index[0] = i;
-            for(std::size_t j = m_pos[i]; j < m_pos[i+1]; ++j)
+            old_index[outer_axis] = i;
+            for (std::size_t j = m_pos[i]; j < m_pos[i + 1]; ++j)
             {
-                old_index[1] = m_coords[j];
+                old_index[inner_axis] = m_coords[j];
                 std::size_t offset = element_offset<std::size_t>(old_strides, old_index.cbegin(), old_index.cend());
-                index_type new_index = xtl::forward_sequence<index_type, svector<std::size_t>>(unravel_from_strides(offset, new_strides));
-                detail::csr::insert_index(new_pos, new_coords, new_index);
+                auto new_index = unravel_from_strides(offset, new_strides);
+                outer[j] = static_cast<std::size_t>(new_index[outer_axis]);
+                inner[j] = static_cast<std::size_t>(new_index[inner_axis]);
             }
         }
 
+        std::vector<std::size_t> cursor(static_cast<std::size_t>(new_shape[inner_axis]) + 1, 0);
+        for (std::size_t k = 0; k < nnz; ++k)
+        {
+            ++cursor[inner[k] + 1];
+        }
+        std::partial_sum(cursor.begin(), cursor.end(), cursor.begin());
+        std::vector<std::size_t> by_inner(nnz);
+        for (std::size_t k = 0; k < nnz; ++k)
+        {
+            by_inner[cursor[inner[k]]++] = k;
+        }
+
+        position_type new_pos(static_cast<std::size_t>(new_shape[outer_axis]) + 1, size_type(0));
+        for (std::size_t k = 0; k < nnz; ++k)
+        {
+            XTENSOR_ASSERT(outer[k] + 1 < new_pos.size());
+            ++new_pos[outer[k] + 1];
+        }
+        std::partial_sum(new_pos.begin(), new_pos.end(), new_pos.begin());
+        cursor.assign(new_pos.cbegin(), new_pos.cend() - 1);
+
+        coordinate_type new_coords(nnz);
+        storage_type new_storage(nnz);
+        for (std::size_t k: by_inner)
+        {
+            std::size_t dst = cursor[outer[k]]++;
+            new_coords[dst] = detail::stored_cast<typename coordinate_type::value_type>(inner[k]);
+            new_storage[dst] = m_storage[k];
+        }
+
         using std::swap;
         swap(m_pos, new_pos);
         swap(m_coords, new_coords);
+        swap(m_storage, new_storage);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order. The elements
+    // are bucketed by outer coordinate with a stable counting sort, so that
+    // the inner coordinates stay sorted for both layouts in linear time.
+    template <class P, class C, class ST, class IT, layout_type L>
+    template <class It>
+    inline void xcsr_scheme<P, C, ST, IT, L>::assign_nz(It first, It last)
+    {
+        using size_type = typename position_type::value_type;
+        XTENSOR_ASSERT(!m_pos.empty());
+
+        std::vector<size_type> outer;
+        coordinate_type inner;
+        storage_type values;
+        std::fill(m_pos.begin(), m_pos.end(), size_type(0));
+        for (; first != last; ++first)
+        {
+            const auto& index = first.index();
+            XTENSOR_ASSERT(static_cast<std::size_t>(index[outer_axis]) + 1 < m_pos.size());
+            outer.push_back(static_cast<size_type>(index[outer_axis]));
+            inner.push_back(static_cast<typename coordinate_type::value_type>(index[inner_axis]));
+            values.push_back(*first);
+            ++m_pos[static_cast<std::size_t>(index[outer_axis]) + 1];
+        }
+        std::partial_sum(m_pos.begin(), m_pos.end(), m_pos.begin());
+
+        using std::swap;
+        if (L == layout_type::row_major)
+        {
+            swap(m_coords, inner);
+            swap(m_storage, values);
+        }
+        else
+        {
+            m_coords.resize(inner.size());
+            m_storage.resize(values.size());
+            std::vector<size_type> cursor(m_pos.cbegin(), m_pos.cend() - 1);
+            for (std::size_t k = 0; k < values.size(); ++k)
+            {
+                std::size_t dst = static_cast<std::size_t>(cursor[static_cast<std::size_t>(outer[k])]++);
+                m_coords[dst] = inner[k];
+                m_storage[dst] = values[k];
+            }
+        }
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::nz_begin() -> nz_iterator
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::nz_begin() -> nz_iterator
     {
         return nz_iterator(*this, m_pos.cbegin(), m_coords.cbegin());
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::nz_end() -> nz_iterator
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::nz_end() -> nz_iterator
     {
-        return nz_iterator(*this, m_pos.cend() - 2, m_coords.cend());
+        return nz_iterator(*this, m_pos.cend() - 1, m_coords.cend());
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::nz_begin() const -> const_nz_iterator
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::nz_begin() const -> const_nz_iterator
     {
         return nz_cbegin();
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::nz_end() const -> const_nz_iterator
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::nz_end() const -> const_nz_iterator
     {
         return nz_cend();
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::nz_cbegin() const -> const_nz_iterator
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::nz_cbegin() const -> const_nz_iterator
     {
         return const_nz_iterator(*this, m_pos.cbegin(), m_coords.cbegin());
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::nz_cend() const -> const_nz_iterator
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::nz_cend() const -> const_nz_iterator
     {
-        return const_nz_iterator(*this, m_pos.cend() - 2, m_coords.cend());
+        return const_nz_iterator(*this, m_pos.cend() - 1, m_coords.cend());
     }
 
-    template <class P, class C, class ST>
-    inline auto xcsr_scheme<P, C, ST>::storage() -> storage_type&
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::storage() -> storage_type&
     {
         return m_storage;
     }
 
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xcsr_scheme<P, C, ST, IT, L>::find_element_impl(const index_type& index) const -> const_pointer
+    {
+        std::size_t ielem = index[outer_axis];
+        if (ielem + 1 >= m_pos.size() || m_pos[ielem] == m_pos[ielem + 1])
+        {
+            return nullptr;
+        }
+
+        auto first = m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[ielem]);
+        auto last = m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[ielem + 1]);
+        auto it = std::find(first, last, index[inner_axis]);
+        if (it != last)
+        {
+            std::ptrdiff_t dst = std::distance(m_coords.cbegin(), it);
+            return &(*(m_storage.cbegin() + dst));
+        }
+
+        return nullptr;
+    }
+
     /***************************************
      * xcsr_scheme_nz_iterator implementation *
      ***************************************/
@@ -348,20 +580,17 @@ namespace xt
         coordinate_iterator&& cit)
         : m_pit(std::move(pit))
         , m_cit(std::move(cit))
+        , m_current_index(xtl::make_sequence<index_type>(2))
         , p_scheme(&s)
     {
-        update_current_index();
+        update_position_forward();
     }
 
     template <class scheme>
     inline auto xcsr_scheme_nz_iterator<scheme>::operator++() -> self_type&
     {
         ++m_cit;
-        auto dst = static_cast<std::size_t>(std::distance(p_scheme->coordinate().cbegin(), m_cit));
-        while (dst == *(m_pit + 1))
-        {
-            ++m_pit;
-        }
+        update_position_forward();
         return *this;
     }
 
@@ -369,11 +598,7 @@ namespace xt
     inline auto xcsr_scheme_nz_iterator<scheme>::operator--() -> self_type&
     {
         --m_cit;
-        auto dst = static_cast<std::size_t>(std::distance(p_scheme->coordinate().cbegin(), m_cit));
-        while (dst == *m_pit - 1)
-        {
-            --m_pit;
-        }
+        update_position_backward();
         return *this;
     }
 
@@ -381,11 +606,7 @@ namespace xt
     inline auto xcsr_scheme_nz_iterator<scheme>::operator+=(difference_type n) -> self_type&
     {
         m_cit += n;
-        auto dst = static_cast<std::size_t>(std::distance(p_scheme->coordinate().cbegin(), m_cit));
-        while (m_pit != p_scheme->position().cend() && dst >= *(m_pit + 1))
-        {
-            ++m_pit;
-        }
+        update_position(n);
         return *this;
     }
 
@@ -393,11 +614,7 @@ namespace xt
     inline auto xcsr_scheme_nz_iterator<scheme>::operator-=(difference_type n) -> self_type&
     {
         m_cit -= n;
-        auto dst = static_cast<std::size_t>(std::distance(p_scheme->coordinate().cbegin(), m_cit));
-        while (m_pit != p_scheme->position().cbegin() && dst < *m_pit)
-        {
-            --m_pit;
-        }
+        update_position(-n);
         return *this;
     }
 
@@ -417,8 +634,7 @@ namespace xt
     template <class scheme>
     inline auto xcsr_scheme_nz_iterator<scheme>::operator->() const -> pointer
     {
-        std::ptrdiff_t dst = std::distance(p_scheme->coordinate().cbegin(), m_cit);
-        return &(p_scheme->storage().begin() + dst);
+        return &(this->operator*());
     }
 
     template <class scheme>
@@ -430,11 +646,53 @@ namespace xt
     template <class scheme>
     inline auto xcsr_scheme_nz_iterator<scheme>::update_current_index() const -> index_type&
     {
-        m_current_index[0] = static_cast<std::size_t>(std::distance(p_scheme->position().cbegin(), m_pit));
-        m_current_index[1] = *m_cit;
+        m_current_index[xcsr_scheme::outer_axis] = static_cast<std::size_t>(std::distance(p_scheme->position().cbegin(), m_pit));
+        m_current_index[xcsr_scheme::inner_axis] = *m_cit;
         return m_current_index;
     }
 
+    // Moves m_pit forward to the outer index containing m_cit; the past-the-end
+    // iterator points to the last element of position().
+    template <class scheme>
+    inline void xcsr_scheme_nz_iterator<scheme>::update_position_forward()
+    {
+        auto dst = static_cast<std::size_t>(std::distance(p_scheme->coordinate().cbegin(), m_cit));
+        auto last = p_scheme->position().cend() - 1;
+        while (m_pit != last && dst >= *(m_pit + 1))
+        {
+            ++m_pit;
+        }
+    }
+
+    template <class scheme>
+    inline void xcsr_scheme_nz_iterator<scheme>::update_position_backward()
+    {
+        auto dst = static_cast<std::size_t>(std::distance(p_scheme->coordinate().cbegin(), m_cit));
+        auto first = p_scheme->position().cbegin();
+        while (m_pit != first && dst < *m_pit)
+        {
+            --m_pit;
+        }
+    }
+
+    // Moves m_pit to the outer index containing m_cit after a jump of n
+    // elements, with a binary search on position() from m_pit toward the
+    // direction of the jump.
+    template <class scheme>
+    inline void xcsr_scheme_nz_iterator<scheme>::update_position(difference_type n)
+    {
+        auto dst = static_cast<std::size_t>(std::distance(p_scheme->coordinate().cbegin(), m_cit));
+        const auto& pos = p_scheme->position();
+        if (n >= 0)
+        {
+            m_pit = std::upper_bound(m_pit, pos.cend(), dst) - 1;
+        }
+        else
+        {
+            m_pit = std::upper_bound(pos.cbegin(), m_pit + 1, dst) - 1;
+        }
+    }
+
     template <class scheme>
     inline bool xcsr_scheme_nz_iterator<scheme>::equal(const self_type& rhs) const
     {
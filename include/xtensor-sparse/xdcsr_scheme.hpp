@@ -0,0 +1,680 @@
+#ifndef XSPARSE_DCSR_SCHEME_HPP
+#define XSPARSE_DCSR_SCHEME_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <xtl/xiterator_base.hpp>
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xlayout.hpp>
+#include <xtensor/xstorage.hpp>
+#include <xtensor/xstrides.hpp>
+
+#include "xutils.hpp"
+
+namespace xt
+{
+    template <class scheme>
+    class xdcsr_scheme_nz_iterator;
+
+    /****************************
+     * xdcsr_scheme declaration *
+     ****************************/
+
+    // Doubly compressed sparse 2-D scheme (DCSR, or DCSC with
+    // L == layout_type::column_major). Only the non-empty fibers are stored:
+    // outer_coordinate() holds their sorted outer indices and position() has
+    // one more entry than outer_coordinate(), so that the memory is O(nnz)
+    // whatever the shape of the matrix.
+    template <class P, class C, class ST, class IT = std::array<std::size_t, 2>, layout_type L = layout_type::row_major>
+    class xdcsr_scheme
+    {
+    public:
+
+        using self_type = xdcsr_scheme<P, C, ST, IT, L>;
+        using position_type = P;
+        using coordinate_type = C;
+        using storage_type = ST;
+        using index_type = IT;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using nz_iterator = xdcsr_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xdcsr_scheme_nz_iterator<const self_type>;
+
+        static constexpr layout_type nz_layout = L;
+        static constexpr std::size_t outer_axis = L == layout_type::row_major ? 0u : 1u;
+        static constexpr std::size_t inner_axis = 1u - outer_axis;
+
+        xdcsr_scheme();
+        xdcsr_scheme(coordinate_type outer, position_type pos, coordinate_type coords, storage_type storage);
+
+        const coordinate_type& outer_coordinate() const;
+        const position_type& position() const;
+        const coordinate_type& coordinate() const;
+        const storage_type& storage() const;
+
+        storage_type& storage();
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+    private:
+
+        using outer_type = typename coordinate_type::value_type;
+        using inner_type = typename coordinate_type::value_type;
+        using entry_type = std::tuple<outer_type, inner_type, value_type>;
+
+        std::size_t find_fiber(std::size_t outer) const;
+        const_pointer find_element_impl(const index_type& index) const;
+        void build(std::vector<entry_type>& entries);
+
+        coordinate_type m_outer;
+        position_type m_pos;
+        coordinate_type m_coords;
+        storage_type m_storage;
+
+        friend class xdcsr_scheme_nz_iterator<self_type>;
+        friend class xdcsr_scheme_nz_iterator<const self_type>;
+    };
+
+    template <class P, class C, class ST, class IT = std::array<std::size_t, 2>>
+    using xdcsc_scheme = xdcsr_scheme<P, C, ST, IT, layout_type::column_major>;
+
+    /************************
+     * xdefault_dcsr_scheme *
+     ************************/
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_dcsr_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xdcsr_scheme<std::vector<position_value_type>,
+                                  std::vector<coordinate_value_type>,
+                                  storage_type,
+                                  index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_dcsr_scheme_t = typename xdefault_dcsr_scheme<T, I, C, P>::type;
+
+    /************************
+     * xdefault_dcsc_scheme *
+     ************************/
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_dcsc_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xdcsc_scheme<std::vector<position_value_type>,
+                                  std::vector<coordinate_value_type>,
+                                  storage_type,
+                                  index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_dcsc_scheme_t = typename xdefault_dcsc_scheme<T, I, C, P>::type;
+
+    /****************************************
+     * xdcsr_scheme_nz_iterator declaration *
+     ****************************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xdcsr_scheme_nz_iterator_types
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::reference;
+            using pointer = typename storage_type::pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+
+        template <class scheme>
+        struct xdcsr_scheme_nz_iterator_types<const scheme>
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::const_reference;
+            using pointer = typename storage_type::const_pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+    }
+
+    template <class scheme>
+    class xdcsr_scheme_nz_iterator
+        : public xtl::xrandom_access_iterator_base3<xdcsr_scheme_nz_iterator<scheme>,
+                                                    detail::xdcsr_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xdcsr_scheme_nz_iterator<scheme>;
+        using scheme_type = scheme;
+        using iterator_types = detail::xdcsr_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+
+        xdcsr_scheme_nz_iterator(scheme& s, std::size_t fiber, std::size_t pos);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+    private:
+
+        void update_fiber_forward();
+        void update_fiber_backward();
+        void update_fiber();
+
+        scheme_type* p_scheme;
+        std::size_t m_fiber;
+        std::size_t m_pos;
+        mutable index_type m_current_index;
+    };
+
+    template <class scheme>
+    bool operator==(const xdcsr_scheme_nz_iterator<scheme>& lhs,
+                    const xdcsr_scheme_nz_iterator<scheme>& rhs);
+
+    template <class scheme>
+    bool operator<(const xdcsr_scheme_nz_iterator<scheme>& lhs,
+                   const xdcsr_scheme_nz_iterator<scheme>& rhs);
+
+    /*******************************
+     * xdcsr_scheme implementation *
+     *******************************/
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline xdcsr_scheme<P, C, ST, IT, L>::xdcsr_scheme()
+        : m_outer()
+        , m_pos(1, 0)
+        , m_coords()
+        , m_storage()
+    {
+    }
+
+    // Builds the scheme from already compressed arrays: outer must be
+    // sorted, pos holds one more entry than outer and coordinates must be
+    // sorted within each fiber.
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline xdcsr_scheme<P, C, ST, IT, L>::xdcsr_scheme(coordinate_type outer, position_type pos,
+                                                       coordinate_type coords, storage_type storage)
+        : m_outer(std::move(outer))
+        , m_pos(std::move(pos))
+        , m_coords(std::move(coords))
+        , m_storage(std::move(storage))
+    {
+        XTENSOR_ASSERT(m_pos.size() == m_outer.size() + 1);
+        XTENSOR_ASSERT(m_pos.back() == m_coords.size());
+        XTENSOR_ASSERT(m_coords.size() == m_storage.size());
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::outer_coordinate() const -> const coordinate_type&
+    {
+        return m_outer;
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::position() const -> const position_type&
+    {
+        return m_pos;
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::coordinate() const -> const coordinate_type&
+    {
+        return m_coords;
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::storage() -> storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(find_element_impl(index));
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::find_element(const index_type& index) const -> const_pointer
+    {
+        return find_element_impl(index);
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline void xdcsr_scheme<P, C, ST, IT, L>::insert_element(const index_type& index, const_reference value)
+    {
+        XTENSOR_ASSERT(index.size() == 2);
+
+        auto outer = static_cast<outer_type>(index[outer_axis]);
+        auto inner = static_cast<inner_type>(index[inner_axis]);
+        auto oit = std::lower_bound(m_outer.begin(), m_outer.end(), outer);
+        auto fiber = static_cast<std::size_t>(std::distance(m_outer.begin(), oit));
+        if (oit == m_outer.end() || *oit != outer)
+        {
+            m_outer.insert(oit, outer);
+            m_pos.insert(m_pos.begin() + static_cast<std::ptrdiff_t>(fiber) + 1, m_pos[fiber]);
+        }
+
+        auto first = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[fiber]);
+        auto last = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[fiber + 1]);
+        auto it = std::lower_bound(first, last, inner);
+        XTENSOR_ASSERT(it == last || *it != inner);
+        auto dst = std::distance(m_coords.begin(), it);
+        m_coords.insert(it, inner);
+        m_storage.insert(m_storage.begin() + dst, value);
+        for (std::size_t j = fiber + 1; j < m_pos.size(); ++j)
+        {
+            ++m_pos[j];
+        }
+    }
+
+    // Fibers that become empty are removed along with their last element.
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline void xdcsr_scheme<P, C, ST, IT, L>::remove_element(const index_type& index)
+    {
+        std::size_t fiber = find_fiber(index[outer_axis]);
+        if (fiber == m_outer.size())
+        {
+            return;
+        }
+
+        auto first = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[fiber]);
+        auto last = m_coords.begin() + static_cast<std::ptrdiff_t>(m_pos[fiber + 1]);
+        auto it = std::lower_bound(first, last, static_cast<inner_type>(index[inner_axis]));
+        if (it != last && *it == static_cast<inner_type>(index[inner_axis]))
+        {
+            auto dst = std::distance(m_coords.begin(), it);
+            m_coords.erase(it);
+            m_storage.erase(m_storage.begin() + dst);
+            for (std::size_t j = fiber + 1; j < m_pos.size(); ++j)
+            {
+                --m_pos[j];
+            }
+            if (m_pos[fiber] == m_pos[fiber + 1])
+            {
+                m_outer.erase(m_outer.begin() + static_cast<std::ptrdiff_t>(fiber));
+                m_pos.erase(m_pos.begin() + static_cast<std::ptrdiff_t>(fiber) + 1);
+            }
+        }
+    }
+
+    // Removes all the stored values whose magnitude is lower than or equal
+    // to tolerance, and the fibers left empty, in a single pass.
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline void xdcsr_scheme<P, C, ST, IT, L>::prune(value_type tolerance)
+    {
+        std::size_t dst = 0;
+        std::size_t nb_fibers = 0;
+        std::size_t begin = m_pos[0];
+        for (std::size_t i = 0; i < m_outer.size(); ++i)
+        {
+            std::size_t end = m_pos[i + 1];
+            std::size_t fiber_begin = dst;
+            for (std::size_t j = begin; j < end; ++j)
+            {
+                if (std::abs(m_storage[j]) > tolerance)
+                {
+                    m_coords[dst] = m_coords[j];
+                    m_storage[dst] = m_storage[j];
+                    ++dst;
+                }
+            }
+            begin = end;
+            if (dst != fiber_begin)
+            {
+                m_outer[nb_fibers] = m_outer[i];
+                m_pos[++nb_fibers] = detail::stored_cast<typename P::value_type>(dst);
+            }
+        }
+        m_outer.resize(nb_fibers);
+        m_pos.resize(nb_fibers + 1);
+        m_coords.resize(dst);
+        m_storage.resize(dst);
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    template <class strides_type, class shape_type>
+    inline void xdcsr_scheme<P, C, ST, IT, L>::update_entries(const strides_type& old_strides,
+                                                              const strides_type& new_strides,
+                                                              const shape_type& new_shape)
+    {
+        XTENSOR_ASSERT(new_shape.size() == 2);
+        (void)new_shape;
+
+        std::vector<entry_type> entries;
+        entries.reserve(m_storage.size());
+        std::array<std::size_t, 2> old_index;
+        for (std::size_t i = 0; i < m_outer.size(); ++i)
+        {
+            old_index[outer_axis] = static_cast<std::size_t>(m_outer[i]);
+            for (std::size_t j = m_pos[i]; j < m_pos[i + 1]; ++j)
+            {
+                old_index[inner_axis] = static_cast<std::size_t>(m_coords[j]);
+                std::size_t offset = element_offset<std::size_t>(old_strides, old_index.cbegin(), old_index.cend());
+                auto new_index = unravel_from_strides(offset, new_strides);
+                entries.emplace_back(static_cast<outer_type>(new_index[outer_axis]),
+                                     static_cast<inner_type>(new_index[inner_axis]),
+                                     m_storage[j]);
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const entry_type& lhs, const entry_type& rhs)
+        {
+            return std::tie(std::get<0>(lhs), std::get<1>(lhs)) < std::tie(std::get<0>(rhs), std::get<1>(rhs));
+        });
+        build(entries);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order. With DCSC,
+    // the elements are stably sorted by column, which keeps the rows sorted
+    // within each column.
+    template <class P, class C, class ST, class IT, layout_type L>
+    template <class It>
+    inline void xdcsr_scheme<P, C, ST, IT, L>::assign_nz(It first, It last)
+    {
+        std::vector<entry_type> entries;
+        for (; first != last; ++first)
+        {
+            const auto& index = first.index();
+            entries.emplace_back(static_cast<outer_type>(index[outer_axis]),
+                                 static_cast<inner_type>(index[inner_axis]),
+                                 *first);
+        }
+        if (L == layout_type::column_major)
+        {
+            std::stable_sort(entries.begin(), entries.end(), [](const entry_type& lhs, const entry_type& rhs)
+            {
+                return std::get<0>(lhs) < std::get<0>(rhs);
+            });
+        }
+        build(entries);
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, 0u, 0u);
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, m_outer.size(), m_coords.size());
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, 0u, 0u);
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_outer.size(), m_coords.size());
+    }
+
+    // Returns the position of the fiber with the given outer index in
+    // outer_coordinate(), or its size if the fiber is empty.
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline std::size_t xdcsr_scheme<P, C, ST, IT, L>::find_fiber(std::size_t outer) const
+    {
+        auto it = std::lower_bound(m_outer.cbegin(), m_outer.cend(), static_cast<outer_type>(outer));
+        if (it == m_outer.cend() || static_cast<std::size_t>(*it) != outer)
+        {
+            return m_outer.size();
+        }
+        return static_cast<std::size_t>(std::distance(m_outer.cbegin(), it));
+    }
+
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline auto xdcsr_scheme<P, C, ST, IT, L>::find_element_impl(const index_type& index) const -> const_pointer
+    {
+        std::size_t fiber = find_fiber(index[outer_axis]);
+        if (fiber == m_outer.size())
+        {
+            return nullptr;
+        }
+
+        auto first = m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[fiber]);
+        auto last = m_coords.cbegin() + static_cast<std::ptrdiff_t>(m_pos[fiber + 1]);
+        auto inner = static_cast<inner_type>(index[inner_axis]);
+        auto it = std::lower_bound(first, last, inner);
+        if (it != last && *it == inner)
+        {
+            return &m_storage[static_cast<std::size_t>(std::distance(m_coords.cbegin(), it))];
+        }
+        return nullptr;
+    }
+
+    // Builds the compressed arrays from entries sorted by outer index, and
+    // by inner index within each fiber.
+    template <class P, class C, class ST, class IT, layout_type L>
+    inline void xdcsr_scheme<P, C, ST, IT, L>::build(std::vector<entry_type>& entries)
+    {
+        using size_type = typename position_type::value_type;
+
+        m_outer.clear();
+        m_pos.assign(1, size_type(0));
+        m_coords.resize(entries.size());
+        m_storage.resize(entries.size());
+        for (std::size_t k = 0; k < entries.size(); ++k)
+        {
+            if (m_outer.empty() || m_outer.back() != std::get<0>(entries[k]))
+            {
+                m_outer.push_back(std::get<0>(entries[k]));
+                m_pos.push_back(m_pos.back());
+            }
+            m_coords[k] = std::get<1>(entries[k]);
+            m_storage[k] = std::get<2>(entries[k]);
+            ++m_pos.back();
+        }
+    }
+
+    /*******************************************
+     * xdcsr_scheme_nz_iterator implementation *
+     *******************************************/
+
+    template <class scheme>
+    inline xdcsr_scheme_nz_iterator<scheme>::xdcsr_scheme_nz_iterator(scheme& s, std::size_t fiber, std::size_t pos)
+        : p_scheme(&s)
+        , m_fiber(fiber)
+        , m_pos(pos)
+        , m_current_index(xtl::make_sequence<index_type>(2))
+    {
+        update_fiber_forward();
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::operator++() -> self_type&
+    {
+        ++m_pos;
+        update_fiber_forward();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::operator--() -> self_type&
+    {
+        --m_pos;
+        update_fiber_backward();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::operator+=(difference_type n) -> self_type&
+    {
+        m_pos = static_cast<std::size_t>(static_cast<difference_type>(m_pos) + n);
+        update_fiber();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::operator-=(difference_type n) -> self_type&
+    {
+        return *this += -n;
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return static_cast<difference_type>(m_pos) - static_cast<difference_type>(rhs.m_pos);
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::operator*() const -> reference
+    {
+        return p_scheme->m_storage[m_pos];
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::operator->() const -> pointer
+    {
+        return &(this->operator*());
+    }
+
+    template <class scheme>
+    inline auto xdcsr_scheme_nz_iterator<scheme>::index() const -> const index_type&
+    {
+        m_current_index[scheme::outer_axis] = static_cast<std::size_t>(p_scheme->m_outer[m_fiber]);
+        m_current_index[scheme::inner_axis] = static_cast<std::size_t>(p_scheme->m_coords[m_pos]);
+        return m_current_index;
+    }
+
+    // Moves m_fiber forward to the fiber containing m_pos; the past-the-end
+    // iterator has m_fiber equal to the number of fibers.
+    template <class scheme>
+    inline void xdcsr_scheme_nz_iterator<scheme>::update_fiber_forward()
+    {
+        const auto& pos = p_scheme->m_pos;
+        std::size_t nb_fibers = p_scheme->m_outer.size();
+        while (m_fiber != nb_fibers && m_pos >= static_cast<std::size_t>(pos[m_fiber + 1]))
+        {
+            ++m_fiber;
+        }
+    }
+
+    template <class scheme>
+    inline void xdcsr_scheme_nz_iterator<scheme>::update_fiber_backward()
+    {
+        const auto& pos = p_scheme->m_pos;
+        while (m_fiber != 0 && m_pos < static_cast<std::size_t>(pos[m_fiber]))
+        {
+            --m_fiber;
+        }
+    }
+
+    // Finds the fiber containing m_pos after a jump with a binary search in
+    // position(), where fibers are never empty.
+    template <class scheme>
+    inline void xdcsr_scheme_nz_iterator<scheme>::update_fiber()
+    {
+        const auto& pos = p_scheme->m_pos;
+        auto it = std::upper_bound(pos.cbegin(), pos.cend(), m_pos);
+        m_fiber = static_cast<std::size_t>(std::distance(pos.cbegin(), it)) - 1;
+    }
+
+    template <class scheme>
+    inline bool xdcsr_scheme_nz_iterator<scheme>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_pos == rhs.m_pos;
+    }
+
+    template <class scheme>
+    inline bool xdcsr_scheme_nz_iterator<scheme>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_pos < rhs.m_pos;
+    }
+
+    template <class scheme>
+    inline bool operator==(const xdcsr_scheme_nz_iterator<scheme>& lhs,
+                           const xdcsr_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class scheme>
+    inline bool operator<(const xdcsr_scheme_nz_iterator<scheme>& lhs,
+                          const xdcsr_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,647 @@
+#ifndef XSPARSE_DIA_SCHEME_HPP
+#define XSPARSE_DIA_SCHEME_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <xtl/xiterator_base.hpp>
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xlayout.hpp>
+#include <xtensor/xstorage.hpp>
+#include <xtensor/xstrides.hpp>
+
+namespace xt
+{
+    template <class scheme>
+    class xdia_scheme_nz_iterator;
+
+    /***************************
+     * xdia_scheme declaration *
+     ***************************/
+
+    // Diagonal scheme for banded matrices. offset() holds the sorted offsets
+    // col - row of the stored diagonals and storage() one dense array of
+    // rows values per diagonal: the element (i, i + offset()[d]) is stored
+    // at d * rows + i. Entries falling outside of the matrix (padding) and
+    // entries of a stored diagonal that are not set hold zeros; they are
+    // skipped by the nz_iterator.
+    template <class O, class ST, class IT = std::array<std::size_t, 2>>
+    class xdia_scheme
+    {
+    public:
+
+        using self_type = xdia_scheme<O, ST, IT>;
+        using offset_type = O;
+        using storage_type = ST;
+        using index_type = IT;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using nz_iterator = xdia_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xdia_scheme_nz_iterator<const self_type>;
+
+        static constexpr layout_type nz_layout = layout_type::row_major;
+
+        xdia_scheme();
+        xdia_scheme(std::size_t rows, std::size_t cols);
+        xdia_scheme(std::size_t rows, std::size_t cols, offset_type offsets, storage_type storage);
+
+        const std::array<std::size_t, 2>& shape() const;
+        const offset_type& offset() const;
+        const storage_type& storage() const;
+
+        storage_type& storage();
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+    private:
+
+        using offset_value_type = typename offset_type::value_type;
+        using entry_type = std::tuple<std::size_t, std::size_t, value_type>;
+
+        static offset_value_type diagonal(std::size_t row, std::size_t col);
+        std::size_t find_diagonal(offset_value_type k) const;
+        const_pointer find_element_impl(const index_type& index) const;
+        void erase_diagonal(std::size_t d);
+        void build(const std::vector<entry_type>& entries);
+
+        std::array<std::size_t, 2> m_shape;
+        offset_type m_offsets;
+        storage_type m_storage;
+
+        friend class xdia_scheme_nz_iterator<self_type>;
+        friend class xdia_scheme_nz_iterator<const self_type>;
+    };
+
+    /***********************
+     * xdefault_dia_scheme *
+     ***********************/
+
+    template <class T, class I>
+    struct xdefault_dia_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using storage_type = std::vector<value_type>;
+        using type = xdia_scheme<std::vector<std::ptrdiff_t>,
+                                 storage_type,
+                                 index_type>;
+    };
+
+    template <class T, class I>
+    using xdefault_dia_scheme_t = typename xdefault_dia_scheme<T, I>::type;
+
+    /***************************************
+     * xdia_scheme_nz_iterator declaration *
+     ***************************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xdia_scheme_nz_iterator_types
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::reference;
+            using pointer = typename storage_type::pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+
+        template <class scheme>
+        struct xdia_scheme_nz_iterator_types<const scheme>
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::const_reference;
+            using pointer = typename storage_type::const_pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+    }
+
+    // Iterates the rows, and the diagonals of each row in increasing
+    // offset order, hence the elements in row-major order.
+    template <class scheme>
+    class xdia_scheme_nz_iterator
+        : public xtl::xrandom_access_iterator_base3<xdia_scheme_nz_iterator<scheme>,
+                                                    detail::xdia_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xdia_scheme_nz_iterator<scheme>;
+        using scheme_type = scheme;
+        using iterator_types = detail::xdia_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+
+        xdia_scheme_nz_iterator(scheme& s, std::size_t row);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+    private:
+
+        bool is_stored(std::size_t row, std::size_t d) const;
+        void next();
+        void previous();
+
+        scheme_type* p_scheme;
+        std::size_t m_row;
+        std::size_t m_diagonal;
+        mutable index_type m_current_index;
+    };
+
+    template <class scheme>
+    bool operator==(const xdia_scheme_nz_iterator<scheme>& lhs,
+                    const xdia_scheme_nz_iterator<scheme>& rhs);
+
+    template <class scheme>
+    bool operator<(const xdia_scheme_nz_iterator<scheme>& lhs,
+                   const xdia_scheme_nz_iterator<scheme>& rhs);
+
+    /******************************
+     * xdia_scheme implementation *
+     ******************************/
+
+    template <class O, class ST, class IT>
+    inline xdia_scheme<O, ST, IT>::xdia_scheme()
+        : xdia_scheme(0u, 0u)
+    {
+    }
+
+    template <class O, class ST, class IT>
+    inline xdia_scheme<O, ST, IT>::xdia_scheme(std::size_t rows, std::size_t cols)
+        : m_shape({rows, cols})
+    {
+    }
+
+    // Builds the scheme from sorted diagonal offsets and rows values per
+    // diagonal.
+    template <class O, class ST, class IT>
+    inline xdia_scheme<O, ST, IT>::xdia_scheme(std::size_t rows, std::size_t cols, offset_type offsets, storage_type storage)
+        : m_shape({rows, cols})
+        , m_offsets(std::move(offsets))
+        , m_storage(std::move(storage))
+    {
+        XTENSOR_ASSERT(std::is_sorted(m_offsets.cbegin(), m_offsets.cend()));
+        XTENSOR_ASSERT(m_offsets.size() * rows == m_storage.size());
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::shape() const -> const std::array<std::size_t, 2>&
+    {
+        return m_shape;
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::offset() const -> const offset_type&
+    {
+        return m_offsets;
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::storage() -> storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(find_element_impl(index));
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::find_element(const index_type& index) const -> const_pointer
+    {
+        return find_element_impl(index);
+    }
+
+    // Inserting on a new diagonal adds rows values, the others being zero.
+    template <class O, class ST, class IT>
+    inline void xdia_scheme<O, ST, IT>::insert_element(const index_type& index, const_reference value)
+    {
+        XTENSOR_ASSERT(index.size() == 2);
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        XTENSOR_ASSERT(row < m_shape[0] && col < m_shape[1]);
+
+        offset_value_type k = diagonal(row, col);
+        auto it = std::lower_bound(m_offsets.begin(), m_offsets.end(), k);
+        std::size_t d = static_cast<std::size_t>(std::distance(m_offsets.begin(), it));
+        if (it == m_offsets.end() || *it != k)
+        {
+            m_offsets.insert(it, k);
+            m_storage.insert(m_storage.begin() + static_cast<std::ptrdiff_t>(d * m_shape[0]), m_shape[0], value_type(0));
+        }
+        m_storage[d * m_shape[0] + row] = value;
+    }
+
+    // The element is set to zero; its diagonal is removed when it holds no
+    // other non-zero.
+    template <class O, class ST, class IT>
+    inline void xdia_scheme<O, ST, IT>::remove_element(const index_type& index)
+    {
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        if (row >= m_shape[0] || col >= m_shape[1])
+        {
+            return;
+        }
+        std::size_t d = find_diagonal(diagonal(row, col));
+        if (d == m_offsets.size())
+        {
+            return;
+        }
+
+        auto first = m_storage.begin() + static_cast<std::ptrdiff_t>(d * m_shape[0]);
+        first[static_cast<std::ptrdiff_t>(row)] = value_type(0);
+        if (std::all_of(first, first + static_cast<std::ptrdiff_t>(m_shape[0]), [](const value_type& v) { return v == value_type(0); }))
+        {
+            erase_diagonal(d);
+        }
+    }
+
+    // Sets the stored values whose magnitude is lower than or equal to
+    // tolerance to zero, and removes the diagonals left empty.
+    template <class O, class ST, class IT>
+    inline void xdia_scheme<O, ST, IT>::prune(value_type tolerance)
+    {
+        std::size_t rows = m_shape[0];
+        std::size_t dst = 0;
+        for (std::size_t d = 0; d < m_offsets.size(); ++d)
+        {
+            bool empty = true;
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                value_type v = m_storage[d * rows + i];
+                bool keep = std::abs(v) > tolerance;
+                m_storage[dst * rows + i] = keep ? v : value_type(0);
+                empty = empty && !keep;
+            }
+            if (!empty)
+            {
+                m_offsets[dst] = m_offsets[d];
+                ++dst;
+            }
+        }
+        m_offsets.resize(dst);
+        m_storage.resize(dst * rows);
+    }
+
+    template <class O, class ST, class IT>
+    template <class strides_type, class shape_type>
+    inline void xdia_scheme<O, ST, IT>::update_entries(const strides_type& old_strides,
+                                                       const strides_type& new_strides,
+                                                       const shape_type& new_shape)
+    {
+        XTENSOR_ASSERT(new_shape.size() == 2);
+
+        std::vector<entry_type> entries;
+        std::array<std::size_t, 2> old_index;
+        for (auto it = nz_cbegin(); it != nz_cend(); ++it)
+        {
+            const auto& index = it.index();
+            old_index[0] = static_cast<std::size_t>(index[0]);
+            old_index[1] = static_cast<std::size_t>(index[1]);
+            std::size_t offset = element_offset<std::size_t>(old_strides, old_index.cbegin(), old_index.cend());
+            auto new_index = unravel_from_strides(offset, new_strides);
+            entries.emplace_back(new_index[0], new_index[1], *it);
+        }
+
+        m_shape = {static_cast<std::size_t>(new_shape[0]), static_cast<std::size_t>(new_shape[1])};
+        build(entries);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), in any order.
+    template <class O, class ST, class IT>
+    template <class It>
+    inline void xdia_scheme<O, ST, IT>::assign_nz(It first, It last)
+    {
+        std::vector<entry_type> entries;
+        for (; first != last; ++first)
+        {
+            const auto& index = first.index();
+            entries.emplace_back(static_cast<std::size_t>(index[0]), static_cast<std::size_t>(index[1]), *first);
+        }
+        build(entries);
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, 0u);
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, m_shape[0]);
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, 0u);
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_shape[0]);
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::diagonal(std::size_t row, std::size_t col) -> offset_value_type
+    {
+        return static_cast<offset_value_type>(col) - static_cast<offset_value_type>(row);
+    }
+
+    // Returns the position of the diagonal k in offset(), or the number of
+    // diagonals if it is not stored.
+    template <class O, class ST, class IT>
+    inline std::size_t xdia_scheme<O, ST, IT>::find_diagonal(offset_value_type k) const
+    {
+        auto it = std::lower_bound(m_offsets.cbegin(), m_offsets.cend(), k);
+        return it != m_offsets.cend() && *it == k ? static_cast<std::size_t>(std::distance(m_offsets.cbegin(), it))
+                                                  : m_offsets.size();
+    }
+
+    template <class O, class ST, class IT>
+    inline auto xdia_scheme<O, ST, IT>::find_element_impl(const index_type& index) const -> const_pointer
+    {
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        if (row >= m_shape[0] || col >= m_shape[1])
+        {
+            return nullptr;
+        }
+        std::size_t d = find_diagonal(diagonal(row, col));
+        return d == m_offsets.size() ? nullptr : &m_storage[d * m_shape[0] + row];
+    }
+
+    template <class O, class ST, class IT>
+    inline void xdia_scheme<O, ST, IT>::erase_diagonal(std::size_t d)
+    {
+        m_offsets.erase(m_offsets.begin() + static_cast<std::ptrdiff_t>(d));
+        auto first = m_storage.begin() + static_cast<std::ptrdiff_t>(d * m_shape[0]);
+        m_storage.erase(first, first + static_cast<std::ptrdiff_t>(m_shape[0]));
+    }
+
+    // The diagonals holding an entry are flagged in an array indexed by
+    // offset, so that the cost is linear in the number of non-zeros plus
+    // rows + cols.
+    template <class O, class ST, class IT>
+    inline void xdia_scheme<O, ST, IT>::build(const std::vector<entry_type>& entries)
+    {
+        constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        std::size_t rows = m_shape[0];
+        std::size_t cols = m_shape[1];
+        std::vector<std::size_t> slot(rows + cols, npos);
+        for (const auto& entry: entries)
+        {
+            XTENSOR_ASSERT(std::get<0>(entry) < rows && std::get<1>(entry) < cols);
+            slot[std::get<1>(entry) + rows - std::get<0>(entry)] = 0;
+        }
+
+        m_offsets.clear();
+        for (std::size_t s = 0; s < slot.size(); ++s)
+        {
+            if (slot[s] != npos)
+            {
+                slot[s] = m_offsets.size();
+                m_offsets.push_back(static_cast<offset_value_type>(s) - static_cast<offset_value_type>(rows));
+            }
+        }
+
+        m_storage.assign(m_offsets.size() * rows, value_type(0));
+        for (const auto& entry: entries)
+        {
+            std::size_t d = slot[std::get<1>(entry) + rows - std::get<0>(entry)];
+            m_storage[d * rows + std::get<0>(entry)] = std::get<2>(entry);
+        }
+    }
+
+    /******************************************
+     * xdia_scheme_nz_iterator implementation *
+     ******************************************/
+
+    template <class scheme>
+    inline xdia_scheme_nz_iterator<scheme>::xdia_scheme_nz_iterator(scheme& s, std::size_t row)
+        : p_scheme(&s)
+        , m_row(s.m_offsets.empty() ? s.m_shape[0] : row)
+        , m_diagonal(0)
+        , m_current_index(xtl::make_sequence<index_type>(2))
+    {
+        if (m_row < p_scheme->m_shape[0] && !is_stored(m_row, m_diagonal))
+        {
+            next();
+        }
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::operator++() -> self_type&
+    {
+        next();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::operator--() -> self_type&
+    {
+        previous();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::operator+=(difference_type n) -> self_type&
+    {
+        for (; n > 0; --n)
+        {
+            next();
+        }
+        for (; n < 0; ++n)
+        {
+            previous();
+        }
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::operator-=(difference_type n) -> self_type&
+    {
+        return *this += -n;
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::operator-(const self_type& rhs) const -> difference_type
+    {
+        self_type it = less_than(rhs) ? *this : rhs;
+        const self_type& last = less_than(rhs) ? rhs : *this;
+        difference_type count = 0;
+        for (; it.less_than(last); it.next())
+        {
+            ++count;
+        }
+        return less_than(rhs) ? -count : count;
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::operator*() const -> reference
+    {
+        return p_scheme->m_storage[m_diagonal * p_scheme->m_shape[0] + m_row];
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::operator->() const -> pointer
+    {
+        return &(this->operator*());
+    }
+
+    template <class scheme>
+    inline auto xdia_scheme_nz_iterator<scheme>::index() const -> const index_type&
+    {
+        m_current_index[0] = m_row;
+        m_current_index[1] = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(m_row) + static_cast<std::ptrdiff_t>(p_scheme->m_offsets[m_diagonal]));
+        return m_current_index;
+    }
+
+    template <class scheme>
+    inline bool xdia_scheme_nz_iterator<scheme>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_row == rhs.m_row && m_diagonal == rhs.m_diagonal;
+    }
+
+    template <class scheme>
+    inline bool xdia_scheme_nz_iterator<scheme>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && std::tie(m_row, m_diagonal) < std::tie(rhs.m_row, rhs.m_diagonal);
+    }
+
+    // Padding entries and entries that are not set are skipped.
+    template <class scheme>
+    inline bool xdia_scheme_nz_iterator<scheme>::is_stored(std::size_t row, std::size_t d) const
+    {
+        if (d >= p_scheme->m_offsets.size())
+        {
+            return false;
+        }
+        std::ptrdiff_t col = static_cast<std::ptrdiff_t>(row) + static_cast<std::ptrdiff_t>(p_scheme->m_offsets[d]);
+        return col >= 0 && col < static_cast<std::ptrdiff_t>(p_scheme->m_shape[1]) &&
+               p_scheme->m_storage[d * p_scheme->m_shape[0] + row] != value_type(0);
+    }
+
+    template <class scheme>
+    inline void xdia_scheme_nz_iterator<scheme>::next()
+    {
+        std::size_t rows = p_scheme->m_shape[0];
+        std::size_t nb_diagonals = p_scheme->m_offsets.size();
+        do
+        {
+            if (++m_diagonal >= nb_diagonals)
+            {
+                m_diagonal = 0;
+                ++m_row;
+            }
+        }
+        while (m_row < rows && !is_stored(m_row, m_diagonal));
+    }
+
+    template <class scheme>
+    inline void xdia_scheme_nz_iterator<scheme>::previous()
+    {
+        std::size_t nb_diagonals = p_scheme->m_offsets.size();
+        do
+        {
+            if (m_diagonal == 0)
+            {
+                m_diagonal = nb_diagonals;
+                --m_row;
+            }
+            --m_diagonal;
+        }
+        while (!is_stored(m_row, m_diagonal));
+    }
+
+    template <class scheme>
+    inline bool operator==(const xdia_scheme_nz_iterator<scheme>& lhs,
+                           const xdia_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class scheme>
+    inline bool operator<(const xdia_scheme_nz_iterator<scheme>& lhs,
+                          const xdia_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
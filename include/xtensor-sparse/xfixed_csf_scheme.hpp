@@ -0,0 +1,823 @@
+#ifndef XSPARSE_FIXED_CSF_SCHEME_HPP
+#define XSPARSE_FIXED_CSF_SCHEME_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xstorage.hpp>
+#include <xtensor/xstrides.hpp>
+
+#include "xcsf_scheme.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+    template <class scheme>
+    class xfixed_csf_scheme_nz_iterator;
+
+    /*********************************
+     * xfixed_csf_scheme declaration *
+     *********************************/
+
+    // CSF scheme whose number of levels N is known at compile time, as in
+    // xsparse_tensor. The levels are held in std::arrays of P (positions)
+    // and C (coordinates) containers, and the loops over the levels are
+    // unrolled. The level 0 always holds a single fiber, even when the
+    // scheme is empty: position()[0] is {0, number of level 0 coordinates}.
+    template <std::size_t N, class P, class C, class ST, class IT = std::array<std::size_t, N>>
+    class xfixed_csf_scheme
+    {
+    public:
+
+        static_assert(N != 0, "xfixed_csf_scheme requires at least one level");
+
+        using self_type = xfixed_csf_scheme<N, P, C, ST, IT>;
+        using level_position_type = P;
+        using level_coordinate_type = C;
+        using position_type = std::array<P, N>;
+        using coordinate_type = std::array<C, N>;
+        using storage_type = ST;
+        using index_type = IT;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using nz_iterator = xfixed_csf_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xfixed_csf_scheme_nz_iterator<const self_type>;
+
+        static constexpr std::size_t rank = N;
+
+        xfixed_csf_scheme();
+
+        const position_type& position() const;
+        const coordinate_type& coordinate() const;
+        const storage_type& storage() const;
+
+        storage_type& storage();
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class It>
+        void insert_elements(It first, It last);
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+    private:
+
+        using entry_type = std::pair<index_type, value_type>;
+        using path_type = std::array<std::size_t, N>;
+
+        void reset();
+        const_pointer find_element_impl(const index_type& index) const;
+        path_type end_path() const;
+
+        template <class I>
+        void push_back(const I& index, const_reference value);
+        void assign_sorted(const std::vector<entry_type>& entries);
+
+        position_type m_pos;
+        coordinate_type m_coords;
+        storage_type m_storage;
+
+        friend class xfixed_csf_scheme_nz_iterator<self_type>;
+        friend class xfixed_csf_scheme_nz_iterator<const self_type>;
+    };
+
+    /*****************************
+     * xdefault_fixed_csf_scheme *
+     *****************************/
+
+    // Only defined for std::array index types, whose size gives the number
+    // of levels.
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_fixed_csf_scheme;
+
+    template <class T, class X, std::size_t N, class C, class P>
+    struct xdefault_fixed_csf_scheme<T, std::array<X, N>, C, P>
+    {
+        using index_type = std::array<X, N>;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xfixed_csf_scheme<N,
+                                       std::vector<position_value_type>,
+                                       std::vector<coordinate_value_type>,
+                                       storage_type,
+                                       index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_fixed_csf_scheme_t = typename xdefault_fixed_csf_scheme<T, I, C, P>::type;
+
+    /*********************************************
+     * xfixed_csf_scheme_nz_iterator declaration *
+     *********************************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xfixed_csf_scheme_nz_iterator_types : xcsf_scheme_storage_type<scheme>
+        {
+            using base_type = xcsf_scheme_storage_type<scheme>;
+            using index_type = typename scheme::index_type;
+            using path_type = std::array<std::size_t, scheme::rank>;
+
+            using value_iterator = typename base_type::value_iterator;
+            using value_type = typename value_iterator::value_type;
+            using reference = typename value_iterator::reference;
+            using pointer = typename value_iterator::pointer;
+            using difference_type = typename value_iterator::difference_type;
+        };
+    }
+
+    // The iterator holds the position of the current node in each level;
+    // the leaf position is also the position of the value in the storage.
+    template <class scheme>
+    class xfixed_csf_scheme_nz_iterator: public xtl::xrandom_access_iterator_base3<xfixed_csf_scheme_nz_iterator<scheme>,
+                                                                                   detail::xfixed_csf_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xfixed_csf_scheme_nz_iterator;
+        using xcsf_scheme = scheme;
+        using iterator_types = detail::xfixed_csf_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using path_type = typename iterator_types::path_type;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+        xfixed_csf_scheme_nz_iterator(scheme& s, const path_type& path);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+        static const value_type ZERO;
+
+    private:
+
+        static constexpr std::size_t N = scheme::rank;
+
+        void update_path();
+
+        path_type m_path;
+        mutable index_type m_current_index;
+        xcsf_scheme* p_scheme;
+    };
+
+    template <class scheme>
+    bool operator==(const xfixed_csf_scheme_nz_iterator<scheme>& it1,
+                    const xfixed_csf_scheme_nz_iterator<scheme>& it2);
+
+    template <class scheme>
+    bool operator<(const xfixed_csf_scheme_nz_iterator<scheme>& it1,
+                   const xfixed_csf_scheme_nz_iterator<scheme>& it2);
+
+    /************************************
+     * xfixed_csf_scheme implementation *
+     ************************************/
+
+    namespace detail
+    {
+        namespace fixed_csf
+        {
+            // Calls f(std::integral_constant<std::size_t, N - 1 - I>()) for
+            // I in [0, N), i.e. walks the levels from the leaves to the root.
+            template <std::size_t N, class F>
+            inline void static_for_reverse(F&& f)
+            {
+                static_for<N>([&f](auto i) { f(std::integral_constant<std::size_t, N - 1 - decltype(i)::value>()); });
+            }
+
+            template <std::size_t D, std::size_t N, class Pos, class Coord, class Index, class Func>
+            inline std::enable_if_t<D + 1 == N, void>
+            for_each_impl(std::size_t fiber, const Pos& pos, const Coord& coords, Index& index, Func& f)
+            {
+                for (std::size_t p = pos[D][fiber]; p < pos[D][fiber + 1]; ++p)
+                {
+                    index[D] = coords[D][p];
+                    f(index, p);
+                }
+            }
+
+            template <std::size_t D, std::size_t N, class Pos, class Coord, class Index, class Func>
+            inline std::enable_if_t<(D + 1 < N), void>
+            for_each_impl(std::size_t fiber, const Pos& pos, const Coord& coords, Index& index, Func& f)
+            {
+                for (std::size_t p = pos[D][fiber]; p < pos[D][fiber + 1]; ++p)
+                {
+                    index[D] = coords[D][p];
+                    for_each_impl<D + 1, N>(p, pos, coords, index, f);
+                }
+            }
+
+            // Calls f(index, leaf) for every stored element in row-major
+            // order, leaf being the position of its value in the storage.
+            template <std::size_t N, class Pos, class Coord, class Func>
+            inline void for_each(const Pos& pos, const Coord& coords, Func&& f)
+            {
+                std::array<std::size_t, N> index;
+                for_each_impl<0, N>(0, pos, coords, index, f);
+            }
+        }
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    constexpr std::size_t xfixed_csf_scheme<N, P, C, ST, IT>::rank;
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline xfixed_csf_scheme<N, P, C, ST, IT>::xfixed_csf_scheme()
+    {
+        reset();
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::position() const -> const position_type&
+    {
+        return m_pos;
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::coordinate() const -> const coordinate_type&
+    {
+        return m_coords;
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::storage() -> storage_type&
+    {
+        return m_storage;
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(find_element_impl(index));
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::find_element(const index_type& index) const -> const_pointer
+    {
+        return find_element_impl(index);
+    }
+
+    // Once a coordinate is missing from its fiber, every level below gets
+    // a new fiber holding the single coordinate of index.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::insert_element(const index_type& index, const_reference value)
+    {
+        using coordinate_value_type = typename C::value_type;
+        XTENSOR_ASSERT(index.size() == N);
+
+        // ielem is the position of the node of the previous level, hence
+        // the fiber of the current level.
+        std::size_t ielem = 0;
+        bool found = true;
+        static_for<N>([&](auto d)
+        {
+            auto& pos = m_pos[d];
+            auto& coords = m_coords[d];
+            if (found)
+            {
+                auto res = detail::csf::search_fiber(coords, pos[ielem], pos[ielem + 1], index[d]);
+                if (!res.second)
+                {
+                    found = false;
+                    for (std::size_t j = ielem + 1; j < pos.size(); ++j)
+                    {
+                        ++pos[j];
+                    }
+                    coords.insert(coords.cbegin() + static_cast<std::ptrdiff_t>(res.first),
+                                  detail::stored_cast<coordinate_value_type>(index[d]));
+                }
+                ielem = res.first;
+            }
+            else
+            {
+                auto first = pos[ielem];
+                pos.insert(pos.cbegin() + static_cast<std::ptrdiff_t>(ielem + 1), first);
+                for (std::size_t j = ielem + 1; j < pos.size(); ++j)
+                {
+                    ++pos[j];
+                }
+                coords.insert(coords.cbegin() + static_cast<std::ptrdiff_t>(first),
+                              detail::stored_cast<coordinate_value_type>(index[d]));
+                ielem = static_cast<std::size_t>(first);
+            }
+        });
+
+        if (found)
+        {
+            m_storage[ielem] = value;
+        }
+        else
+        {
+            m_storage.insert(m_storage.cbegin() + static_cast<std::ptrdiff_t>(ielem), value);
+        }
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::remove_element(const index_type& index)
+    {
+        XTENSOR_ASSERT(index.size() == N);
+
+        // path[d] is the fiber of index[d] in the level d, i.e. the position
+        // of index[d - 1] in the level d - 1, and path[N] is the leaf.
+        std::array<std::size_t, N + 1> path;
+        path[0] = 0;
+        bool found = true;
+        static_for<N>([&](auto d)
+        {
+            if (found)
+            {
+                std::size_t fiber = path[d];
+                auto res = detail::csf::search_fiber(m_coords[d], m_pos[d][fiber], m_pos[d][fiber + 1], index[d]);
+                found = res.second;
+                path[d + 1] = res.first;
+            }
+        });
+        if (!found)
+        {
+            return;
+        }
+
+        m_storage.erase(m_storage.begin() + static_cast<std::ptrdiff_t>(path[N]));
+
+        // Remove the leaf, then every ancestor whose fiber becomes empty
+        bool done = false;
+        detail::fixed_csf::static_for_reverse<N>([&](auto d)
+        {
+            if (done)
+            {
+                return;
+            }
+            auto& pos = m_pos[d];
+            std::size_t fiber = path[d];
+            m_coords[d].erase(m_coords[d].begin() + static_cast<std::ptrdiff_t>(path[d + 1]));
+            for (std::size_t j = fiber + 1; j < pos.size(); ++j)
+            {
+                --pos[j];
+            }
+
+            if (d == 0 || pos[fiber] != pos[fiber + 1])
+            {
+                done = true;
+            }
+            else
+            {
+                pos.erase(pos.begin() + static_cast<std::ptrdiff_t>(fiber + 1));
+            }
+        });
+    }
+
+    // Removes all the stored values whose magnitude is lower than or equal
+    // to tolerance. Levels are compacted from the leaves to the root so that
+    // fibers left empty are dropped in the same pass.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::prune(value_type tolerance)
+    {
+        using position_value_type = typename P::value_type;
+
+        std::vector<char> keep(m_storage.size());
+        std::transform(m_storage.cbegin(), m_storage.cend(), keep.begin(),
+                       [tolerance](const auto& v) { return std::abs(v) > tolerance; });
+
+        detail::fixed_csf::static_for_reverse<N>([&](auto d)
+        {
+            auto& pos = m_pos[d];
+            auto& coords = m_coords[d];
+            std::size_t nb_fibers = pos.size() - 1;
+            std::vector<char> keep_parent(nb_fibers);
+
+            std::size_t dst = 0;
+            std::size_t begin = pos[0];
+            for (std::size_t f = 0; f < nb_fibers; ++f)
+            {
+                std::size_t end = pos[f + 1];
+                for (std::size_t k = begin; k < end; ++k)
+                {
+                    if (keep[k])
+                    {
+                        coords[dst] = coords[k];
+                        if (d + 1 == N)
+                        {
+                            m_storage[dst] = m_storage[k];
+                        }
+                        ++dst;
+                    }
+                }
+                begin = end;
+                pos[f + 1] = detail::stored_cast<position_value_type>(dst);
+                keep_parent[f] = pos[f + 1] != pos[f];
+            }
+            coords.resize(dst);
+            if (d + 1 == N)
+            {
+                m_storage.resize(dst);
+            }
+
+            // The single fiber of the level 0 is kept even when empty
+            if (d != 0)
+            {
+                std::size_t pdst = 1;
+                for (std::size_t f = 0; f < nb_fibers; ++f)
+                {
+                    if (keep_parent[f])
+                    {
+                        pos[pdst++] = pos[f + 1];
+                    }
+                }
+                pos.resize(pdst);
+            }
+            keep = std::move(keep_parent);
+        });
+    }
+
+    // Merges the (index, value) pairs of [first, last) with the stored
+    // elements, then rebuilds all the levels in a single pass. Values
+    // sharing the same index are summed, as in the COO scheme.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    template <class It>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::insert_elements(It first, It last)
+    {
+        std::vector<entry_type> entries;
+        entries.reserve(m_storage.size());
+        for (auto it = nz_cbegin(); it != nz_cend(); ++it)
+        {
+            entries.emplace_back(it.index(), *it);
+        }
+        std::size_t old_size = entries.size();
+        for (; first != last; ++first)
+        {
+            entries.emplace_back(detail::convert_index<index_type>(std::get<0>(*first)), std::get<1>(*first));
+        }
+
+        auto comp = [](const entry_type& lhs, const entry_type& rhs) { return lhs.first < rhs.first; };
+        auto middle = entries.begin() + static_cast<std::ptrdiff_t>(old_size);
+        std::stable_sort(middle, entries.end(), comp);
+        std::inplace_merge(entries.begin(), middle, entries.end(), comp);
+        assign_sorted(entries);
+    }
+
+    // The number of levels is fixed, only the coordinates change: the levels
+    // are rebuilt in a single pass, the entries being sorted first only if
+    // the strides are not row-major.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    template <class strides_type, class shape_type>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::update_entries(const strides_type& old_strides,
+                                                                   const strides_type& new_strides,
+                                                                   const shape_type&)
+    {
+        XTENSOR_ASSERT(new_strides.size() == N);
+
+        std::vector<entry_type> entries;
+        entries.reserve(m_storage.size());
+        detail::fixed_csf::for_each<N>(m_pos, m_coords, [&](const auto& index, std::size_t leaf)
+        {
+            std::size_t offset = element_offset<std::size_t>(old_strides, index.cbegin(), index.cend());
+            entries.emplace_back(detail::convert_index<index_type>(unravel_from_strides(offset, new_strides)), m_storage[leaf]);
+        });
+
+        auto comp = [](const entry_type& lhs, const entry_type& rhs) { return lhs.first < rhs.first; };
+        if (!std::is_sorted(entries.cbegin(), entries.cend(), comp))
+        {
+            std::stable_sort(entries.begin(), entries.end(), comp);
+        }
+        assign_sorted(entries);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    template <class It>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::assign_nz(It first, It last)
+    {
+        reset();
+        for (; first != last; ++first)
+        {
+            push_back(first.index(), *first);
+        }
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, path_type{});
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, end_path());
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, path_type{});
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, end_path());
+    }
+
+    // Empty levels: the level 0 holds one empty fiber, and the other ones
+    // no fiber at all.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::reset()
+    {
+        static_for<N>([this](auto d)
+        {
+            m_pos[d].assign(d == 0 ? 2u : 1u, 0);
+            m_coords[d].clear();
+        });
+        m_storage.clear();
+    }
+
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::find_element_impl(const index_type& index) const -> const_pointer
+    {
+        XTENSOR_ASSERT(index.size() == N);
+
+        std::size_t ielem = 0;
+        bool found = true;
+        static_for<N>([&](auto d)
+        {
+            if (found)
+            {
+                auto res = detail::csf::search_fiber(m_coords[d], m_pos[d][ielem], m_pos[d][ielem + 1], index[d]);
+                found = res.second;
+                ielem = res.first;
+            }
+        });
+        return found ? &m_storage[ielem] : nullptr;
+    }
+
+    // The end iterator points past the last node of every level.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline auto xfixed_csf_scheme<N, P, C, ST, IT>::end_path() const -> path_type
+    {
+        path_type res;
+        static_for<N>([&](auto d) { res[d] = m_coords[d].size(); });
+        return res;
+    }
+
+    // Appends an element greater than the stored ones in row-major order.
+    // It shares with the last element the fibers of the levels before the
+    // first coordinate that differs, and opens new fibers below it.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    template <class I>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::push_back(const I& index, const_reference value)
+    {
+        using coordinate_value_type = typename C::value_type;
+        using position_value_type = typename P::value_type;
+        XTENSOR_ASSERT(index.size() == N);
+
+        std::size_t k = 0;
+        if (!m_storage.empty())
+        {
+            bool shared = true;
+            static_for<N>([&](auto d)
+            {
+                shared = shared && m_coords[d].back() == index[d];
+                k += shared ? 1u : 0u;
+            });
+            XTENSOR_ASSERT(k < N);
+        }
+
+        static_for<N>([&](auto d)
+        {
+            if (d == k)
+            {
+                ++m_pos[d].back();
+            }
+            else if (d > k)
+            {
+                std::size_t end = m_pos[d].back();
+                m_pos[d].push_back(detail::stored_cast<position_value_type>(end + 1));
+            }
+
+            if (d >= k)
+            {
+                m_coords[d].push_back(detail::stored_cast<coordinate_value_type>(index[d]));
+            }
+        });
+        m_storage.push_back(value);
+    }
+
+    // Replaces the stored elements with entries, which must be sorted in
+    // row-major order; values of consecutive equal indices are summed.
+    template <std::size_t N, class P, class C, class ST, class IT>
+    inline void xfixed_csf_scheme<N, P, C, ST, IT>::assign_sorted(const std::vector<entry_type>& entries)
+    {
+        reset();
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            if (i != 0 && entries[i].first == entries[i - 1].first)
+            {
+                m_storage.back() += entries[i].second;
+            }
+            else
+            {
+                push_back(entries[i].first, entries[i].second);
+            }
+        }
+    }
+
+    /************************************************
+     * xfixed_csf_scheme_nz_iterator implementation *
+     ************************************************/
+
+    template <class scheme>
+    const typename xfixed_csf_scheme_nz_iterator<scheme>::value_type
+    xfixed_csf_scheme_nz_iterator<scheme>::ZERO = 0;
+
+    template <class scheme>
+    constexpr std::size_t xfixed_csf_scheme_nz_iterator<scheme>::N;
+
+    template <class scheme>
+    inline xfixed_csf_scheme_nz_iterator<scheme>::xfixed_csf_scheme_nz_iterator(scheme& s, const path_type& path)
+        : m_path(path)
+        , m_current_index(xtl::make_sequence<index_type>(N))
+        , p_scheme(&s)
+    {
+    }
+
+    // Fibers are contiguous and never empty: moving past the end of a fiber
+    // moves the parent node to the next one, whose fiber starts right there.
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::operator++() -> self_type&
+    {
+        const auto& pos = p_scheme->position();
+        ++m_path[N - 1];
+        bool carry = true;
+        detail::fixed_csf::static_for_reverse<N - 1>([&](auto i)
+        {
+            constexpr std::size_t d = decltype(i)::value + 1;
+            carry = carry && m_path[d] == pos[d][m_path[d - 1] + 1];
+            m_path[d - 1] += carry ? 1u : 0u;
+        });
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::operator--() -> self_type&
+    {
+        const auto& pos = p_scheme->position();
+        --m_path[N - 1];
+        bool borrow = true;
+        detail::fixed_csf::static_for_reverse<N - 1>([&](auto i)
+        {
+            constexpr std::size_t d = decltype(i)::value + 1;
+            borrow = borrow && m_path[d] < pos[d][m_path[d - 1]];
+            m_path[d - 1] -= borrow ? 1u : 0u;
+        });
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::operator+=(difference_type n) -> self_type&
+    {
+        m_path[N - 1] = static_cast<std::size_t>(static_cast<difference_type>(m_path[N - 1]) + n);
+        update_path();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::operator-=(difference_type n) -> self_type&
+    {
+        m_path[N - 1] = static_cast<std::size_t>(static_cast<difference_type>(m_path[N - 1]) - n);
+        update_path();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return static_cast<difference_type>(m_path[N - 1]) - static_cast<difference_type>(rhs.m_path[N - 1]);
+    }
+
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::operator*() const -> reference
+    {
+        return *(p_scheme->storage().begin() + static_cast<difference_type>(m_path[N - 1]));
+    }
+
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::operator->() const -> pointer
+    {
+        return &(this->operator*());
+    }
+
+    template <class scheme>
+    inline auto xfixed_csf_scheme_nz_iterator<scheme>::index() const -> const index_type&
+    {
+        const auto& coords = p_scheme->coordinate();
+        static_for<N>([&](auto d) { m_current_index[d] = coords[d][m_path[d]]; });
+        return m_current_index;
+    }
+
+    template <class scheme>
+    inline bool xfixed_csf_scheme_nz_iterator<scheme>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_path[N - 1] == rhs.m_path[N - 1];
+    }
+
+    template <class scheme>
+    inline bool xfixed_csf_scheme_nz_iterator<scheme>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_path[N - 1] < rhs.m_path[N - 1];
+    }
+
+    // Recomputes the ancestors of the leaf with a binary search per level,
+    // the parent of a node being the last fiber starting at or before it.
+    template <class scheme>
+    inline void xfixed_csf_scheme_nz_iterator<scheme>::update_path()
+    {
+        const auto& pos = p_scheme->position();
+        detail::fixed_csf::static_for_reverse<N - 1>([&](auto i)
+        {
+            constexpr std::size_t d = decltype(i)::value + 1;
+            auto it = std::upper_bound(pos[d].cbegin(), pos[d].cend(), m_path[d]);
+            m_path[d - 1] = static_cast<std::size_t>(it - pos[d].cbegin()) - 1;
+        });
+    }
+
+    template <class scheme>
+    inline bool operator==(const xfixed_csf_scheme_nz_iterator<scheme>& it1,
+                           const xfixed_csf_scheme_nz_iterator<scheme>& it2)
+    {
+        return it1.equal(it2);
+    }
+
+    template <class scheme>
+    inline bool operator<(const xfixed_csf_scheme_nz_iterator<scheme>& it1,
+                          const xfixed_csf_scheme_nz_iterator<scheme>& it2)
+    {
+        return it1.less_than(it2);
+    }
+}
+
+#endif
@@ -0,0 +1,759 @@
+#ifndef XSPARSE_HASH_SCHEME_HPP
+#define XSPARSE_HASH_SCHEME_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xiterator_base.hpp>
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xlayout.hpp>
+#include <xtensor/xstorage.hpp>
+
+namespace xt
+{
+    template <class scheme>
+    class xhash_scheme_nz_iterator;
+
+    /****************
+     * xhash_scheme *
+     ****************/
+
+    // Open addressing hash table with linear probing, keyed on the row-major
+    // offset of the elements. Keys and values are stored in two flat arrays
+    // of the same capacity (a power of two); empty slots hold the empty key
+    // and a zero value, so that the value array can be processed as a whole.
+    template <class K, class ST, class IT = svector<std::size_t>>
+    class xhash_scheme
+    {
+    public:
+
+        using self_type = xhash_scheme<K, ST, IT>;
+        using key_container_type = K;
+        using key_type = typename key_container_type::value_type;
+        using storage_type = ST;
+        using index_type = IT;
+        using size_type = typename key_container_type::size_type;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using order_type = std::vector<size_type>;
+
+        using nz_iterator = xhash_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xhash_scheme_nz_iterator<const self_type>;
+
+        // Non-zeros are iterated in slot order, see sorted_order.
+        static constexpr layout_type nz_layout = layout_type::dynamic;
+
+        xhash_scheme();
+
+        const key_container_type& keys() const;
+        const storage_type& storage() const;
+
+        size_type size() const;
+        size_type capacity() const;
+        void reserve(size_type n);
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class It>
+        void insert_elements(It first, It last);
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        order_type sorted_order() const;
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+        nz_iterator nz_begin(const order_type& order);
+        nz_iterator nz_end(const order_type& order);
+        const_nz_iterator nz_cbegin(const order_type& order) const;
+        const_nz_iterator nz_cend(const order_type& order) const;
+
+    private:
+
+        static constexpr key_type empty_key = std::numeric_limits<key_type>::max();
+        static constexpr size_type npos = std::numeric_limits<size_type>::max();
+        static constexpr size_type min_capacity = 8;
+
+        template <class I>
+        key_type linear_offset(const I& index) const;
+        void unravel(key_type key, index_type& index) const;
+
+        size_type home_slot(key_type key) const;
+        size_type find_slot(key_type key) const;
+        size_type insert_key(key_type key);
+        void erase_slot(size_type slot);
+
+        template <class F>
+        void rebuild(size_type capacity, F keep);
+
+        key_container_type m_keys;
+        storage_type m_storage;
+        size_type m_size;
+        std::size_t m_shift;
+        index_type m_shape;
+        index_type m_strides;
+
+        friend class xhash_scheme_nz_iterator<self_type>;
+        friend class xhash_scheme_nz_iterator<const self_type>;
+    };
+
+    /************************
+     * xdefault_hash_scheme *
+     ************************/
+
+    // The keys are linear offsets and are stored with the position type P,
+    // C is only accepted for consistency with the other schemes.
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_hash_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xhash_scheme<std::vector<position_value_type>, storage_type, index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_hash_scheme_t = typename xdefault_hash_scheme<T, I, C, P>::type;
+
+    /****************************
+     * xhash_scheme_nz_iterator *
+     ****************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xhash_scheme_nz_iterator_types
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using order_type = typename scheme::order_type;
+            using size_type = typename scheme::size_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::reference;
+            using pointer = typename storage_type::pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+
+        template <class scheme>
+        struct xhash_scheme_nz_iterator_types<const scheme>
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using order_type = typename scheme::order_type;
+            using size_type = typename scheme::size_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::const_reference;
+            using pointer = typename storage_type::const_pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+    }
+
+    // Iterates the occupied slots of the table, or the slots listed in an
+    // order returned by sorted_order when one is given.
+    template <class scheme>
+    class xhash_scheme_nz_iterator
+        : public xtl::xrandom_access_iterator_base3<xhash_scheme_nz_iterator<scheme>,
+                                                    detail::xhash_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xhash_scheme_nz_iterator<scheme>;
+        using scheme_type = scheme;
+        using iterator_types = detail::xhash_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using order_type = typename iterator_types::order_type;
+        using size_type = typename iterator_types::size_type;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+
+        xhash_scheme_nz_iterator();
+        xhash_scheme_nz_iterator(scheme& s, size_type pos, const order_type* order = nullptr);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+    private:
+
+        size_type slot() const;
+        bool is_empty(size_type slot) const;
+
+        scheme_type* p_scheme;
+        const order_type* p_order;
+        size_type m_pos;
+        mutable index_type m_index;
+    };
+
+    template <class S>
+    bool operator==(const xhash_scheme_nz_iterator<S>& lhs,
+                    const xhash_scheme_nz_iterator<S>& rhs);
+
+    template <class S>
+    bool operator<(const xhash_scheme_nz_iterator<S>& lhs,
+                   const xhash_scheme_nz_iterator<S>& rhs);
+
+    /*******************************
+     * xhash_scheme implementation *
+     *******************************/
+
+    template <class K, class ST, class IT>
+    constexpr typename xhash_scheme<K, ST, IT>::key_type xhash_scheme<K, ST, IT>::empty_key;
+
+    template <class K, class ST, class IT>
+    constexpr typename xhash_scheme<K, ST, IT>::size_type xhash_scheme<K, ST, IT>::npos;
+
+    template <class K, class ST, class IT>
+    constexpr typename xhash_scheme<K, ST, IT>::size_type xhash_scheme<K, ST, IT>::min_capacity;
+
+    template <class K, class ST, class IT>
+    inline xhash_scheme<K, ST, IT>::xhash_scheme()
+        : m_keys()
+        , m_storage()
+        , m_size(0)
+        , m_shift(64)
+        , m_shape(xtl::make_sequence<index_type>(0))
+        , m_strides(xtl::make_sequence<index_type>(0))
+    {
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::keys() const -> const key_container_type&
+    {
+        return m_keys;
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::size() const -> size_type
+    {
+        return m_size;
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::capacity() const -> size_type
+    {
+        return m_keys.size();
+    }
+
+    // Makes room for n elements without rehashing; the load factor is kept
+    // under 3/4.
+    template <class K, class ST, class IT>
+    inline void xhash_scheme<K, ST, IT>::reserve(size_type n)
+    {
+        size_type capacity = min_capacity;
+        while (capacity * 3 < n * 4)
+        {
+            capacity *= 2;
+        }
+        if (capacity > m_keys.size())
+        {
+            rebuild(capacity, [](value_type) { return true; });
+        }
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(static_cast<const self_type&>(*this).find_element(index));
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::find_element(const index_type& index) const -> const_pointer
+    {
+        size_type slot = find_slot(linear_offset(index));
+        return slot == npos ? nullptr : &m_storage[slot];
+    }
+
+    template <class K, class ST, class IT>
+    inline void xhash_scheme<K, ST, IT>::insert_element(const index_type& index, const_reference value)
+    {
+        m_storage[insert_key(linear_offset(index))] = value;
+    }
+
+    template <class K, class ST, class IT>
+    inline void xhash_scheme<K, ST, IT>::remove_element(const index_type& index)
+    {
+        size_type slot = find_slot(linear_offset(index));
+        if (slot != npos)
+        {
+            erase_slot(slot);
+        }
+    }
+
+    template <class K, class ST, class IT>
+    inline void xhash_scheme<K, ST, IT>::prune(value_type tolerance)
+    {
+        auto keep = [tolerance](value_type v) { return std::abs(v) > tolerance; };
+        size_type count = 0;
+        for (size_type i = 0; i < m_keys.size(); ++i)
+        {
+            if (m_keys[i] != empty_key && keep(m_storage[i]))
+            {
+                ++count;
+            }
+        }
+        size_type capacity = min_capacity;
+        while (capacity * 3 < count * 4)
+        {
+            capacity *= 2;
+        }
+        rebuild(capacity, keep);
+    }
+
+    // Values of duplicate indices are summed, as in the COO scheme.
+    template <class K, class ST, class IT>
+    template <class It>
+    inline void xhash_scheme<K, ST, IT>::insert_elements(It first, It last)
+    {
+        for (; first != last; ++first)
+        {
+            m_storage[insert_key(linear_offset(std::get<0>(*first)))] += std::get<1>(*first);
+        }
+    }
+
+    // The keys are offsets in a row-major layout, as the indices computed by
+    // the other schemes, hence they are not changed by a reshape or a
+    // resize; only the shape used to compute the indices is updated.
+    template <class K, class ST, class IT>
+    template <class strides_type, class shape_type>
+    inline void xhash_scheme<K, ST, IT>::update_entries(const strides_type&,
+                                                        const strides_type&,
+                                                        const shape_type& new_shape)
+    {
+        std::size_t dim = new_shape.size();
+        m_shape = xtl::make_sequence<index_type>(dim);
+        std::copy(new_shape.cbegin(), new_shape.cend(), m_shape.begin());
+        m_strides = xtl::make_sequence<index_type>(dim, 1u);
+        for (std::size_t d = dim; d > 1; --d)
+        {
+            m_strides[d - 2] = m_strides[d - 1] * m_shape[d - 1];
+        }
+        // Every offset must fit in key_type, which may be narrower than the
+        // value_type of index_type, and differ from empty_key.
+        XTENSOR_ASSERT(dim == 0 || static_cast<std::size_t>(m_strides[0] * m_shape[0]) <= static_cast<std::size_t>(empty_key));
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which can be iterated in any order.
+    template <class K, class ST, class IT>
+    template <class It>
+    inline void xhash_scheme<K, ST, IT>::assign_nz(It first, It last)
+    {
+        rebuild(std::max(min_capacity, size_type(m_keys.size())), [](value_type) { return false; });
+        for (; first != last; ++first)
+        {
+            m_storage[insert_key(linear_offset(first.index()))] = *first;
+        }
+    }
+
+    // Returns the occupied slots sorted by key, i.e. in row-major order. The
+    // order can be passed to the nz_begin and nz_end overloads and remains
+    // valid until the scheme is modified.
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::sorted_order() const -> order_type
+    {
+        order_type order;
+        order.reserve(m_size);
+        for (size_type i = 0; i < m_keys.size(); ++i)
+        {
+            if (m_keys[i] != empty_key)
+            {
+                order.push_back(i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [this](size_type lhs, size_type rhs) { return m_keys[lhs] < m_keys[rhs]; });
+        return order;
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, 0);
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, m_keys.size());
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, 0);
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_keys.size());
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_begin(const order_type& order) -> nz_iterator
+    {
+        return nz_iterator(*this, 0, &order);
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_end(const order_type& order) -> nz_iterator
+    {
+        return nz_iterator(*this, order.size(), &order);
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_cbegin(const order_type& order) const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, 0, &order);
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::nz_cend(const order_type& order) const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, order.size(), &order);
+    }
+
+    template <class K, class ST, class IT>
+    template <class I>
+    inline auto xhash_scheme<K, ST, IT>::linear_offset(const I& index) const -> key_type
+    {
+        XTENSOR_ASSERT(static_cast<std::size_t>(index.size()) == m_strides.size());
+        key_type res = 0;
+        for (std::size_t d = 0; d < m_strides.size(); ++d)
+        {
+            res += static_cast<key_type>(index[d]) * static_cast<key_type>(m_strides[d]);
+        }
+        return res;
+    }
+
+    template <class K, class ST, class IT>
+    inline void xhash_scheme<K, ST, IT>::unravel(key_type key, index_type& index) const
+    {
+        for (std::size_t d = 0; d < m_strides.size(); ++d)
+        {
+            index[d] = static_cast<typename index_type::value_type>(key / static_cast<key_type>(m_strides[d]));
+            key %= static_cast<key_type>(m_strides[d]);
+        }
+    }
+
+    // Fibonacci hashing: the high bits of the product spread consecutive
+    // offsets, e.g. the elements of a row, over the whole table.
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::home_slot(key_type key) const -> size_type
+    {
+        return static_cast<size_type>((static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> m_shift);
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::find_slot(key_type key) const -> size_type
+    {
+        if (m_keys.empty())
+        {
+            return npos;
+        }
+        size_type mask = m_keys.size() - 1;
+        for (size_type i = home_slot(key);; i = (i + 1) & mask)
+        {
+            if (m_keys[i] == key)
+            {
+                return i;
+            }
+            if (m_keys[i] == empty_key)
+            {
+                return npos;
+            }
+        }
+    }
+
+    // Returns the slot of key, inserting it with a zero value if it is not
+    // in the table yet.
+    template <class K, class ST, class IT>
+    inline auto xhash_scheme<K, ST, IT>::insert_key(key_type key) -> size_type
+    {
+        size_type slot = find_slot(key);
+        if (slot != npos)
+        {
+            return slot;
+        }
+        if ((m_size + 1) * 4 > m_keys.size() * 3)
+        {
+            rebuild(std::max(min_capacity, size_type(2 * m_keys.size())), [](value_type) { return true; });
+        }
+        size_type mask = m_keys.size() - 1;
+        slot = home_slot(key);
+        while (m_keys[slot] != empty_key)
+        {
+            slot = (slot + 1) & mask;
+        }
+        m_keys[slot] = key;
+        ++m_size;
+        return slot;
+    }
+
+    // Backward shift deletion: the following entries of the probe sequence
+    // are moved back when the freed slot lies between their home slot and
+    // their current slot, so that no tombstone is needed.
+    template <class K, class ST, class IT>
+    inline void xhash_scheme<K, ST, IT>::erase_slot(size_type slot)
+    {
+        size_type mask = m_keys.size() - 1;
+        size_type hole = slot;
+        for (size_type i = (hole + 1) & mask; m_keys[i] != empty_key; i = (i + 1) & mask)
+        {
+            size_type home = home_slot(m_keys[i]);
+            bool movable = hole <= i ? (home <= hole || home > i) : (home <= hole && home > i);
+            if (movable)
+            {
+                m_keys[hole] = m_keys[i];
+                m_storage[hole] = m_storage[i];
+                hole = i;
+            }
+        }
+        m_keys[hole] = empty_key;
+        m_storage[hole] = value_type(0);
+        --m_size;
+    }
+
+    // Reallocates the table with the given capacity (a power of two) and
+    // inserts back the entries whose value satisfies keep.
+    template <class K, class ST, class IT>
+    template <class F>
+    inline void xhash_scheme<K, ST, IT>::rebuild(size_type capacity, F keep)
+    {
+        key_container_type old_keys(capacity, empty_key);
+        storage_type old_storage(capacity, value_type(0));
+        using std::swap;
+        swap(m_keys, old_keys);
+        swap(m_storage, old_storage);
+        m_size = 0;
+        m_shift = 64;
+        for (size_type c = capacity; c > 1; c /= 2)
+        {
+            --m_shift;
+        }
+
+        size_type mask = capacity - 1;
+        for (size_type i = 0; i < old_keys.size(); ++i)
+        {
+            if (old_keys[i] != empty_key && keep(old_storage[i]))
+            {
+                size_type slot = home_slot(old_keys[i]);
+                while (m_keys[slot] != empty_key)
+                {
+                    slot = (slot + 1) & mask;
+                }
+                m_keys[slot] = old_keys[i];
+                m_storage[slot] = old_storage[i];
+                ++m_size;
+            }
+        }
+    }
+
+    /*******************************************
+     * xhash_scheme_nz_iterator implementation *
+     *******************************************/
+
+    template <class S>
+    inline xhash_scheme_nz_iterator<S>::xhash_scheme_nz_iterator()
+        : p_scheme(nullptr)
+        , p_order(nullptr)
+        , m_pos(0)
+    {
+    }
+
+    template <class S>
+    inline xhash_scheme_nz_iterator<S>::xhash_scheme_nz_iterator(S& s, size_type pos, const order_type* order)
+        : p_scheme(&s)
+        , p_order(order)
+        , m_pos(pos)
+        , m_index(xtl::make_sequence<index_type>(s.m_shape.size()))
+    {
+        while (p_order == nullptr && m_pos < p_scheme->m_keys.size() && is_empty(m_pos))
+        {
+            ++m_pos;
+        }
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::operator++() -> self_type&
+    {
+        do
+        {
+            ++m_pos;
+        }
+        while (p_order == nullptr && m_pos < p_scheme->m_keys.size() && is_empty(m_pos));
+        return *this;
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::operator--() -> self_type&
+    {
+        do
+        {
+            --m_pos;
+        }
+        while (p_order == nullptr && is_empty(m_pos));
+        return *this;
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::operator+=(difference_type n) -> self_type&
+    {
+        if (p_order != nullptr)
+        {
+            m_pos = static_cast<size_type>(static_cast<difference_type>(m_pos) + n);
+        }
+        else
+        {
+            for (; n > 0; --n)
+            {
+                ++(*this);
+            }
+            for (; n < 0; ++n)
+            {
+                --(*this);
+            }
+        }
+        return *this;
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::operator-=(difference_type n) -> self_type&
+    {
+        return *this += -n;
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::operator-(const self_type& rhs) const -> difference_type
+    {
+        if (p_order != nullptr)
+        {
+            return static_cast<difference_type>(m_pos) - static_cast<difference_type>(rhs.m_pos);
+        }
+        size_type first = std::min(m_pos, rhs.m_pos);
+        size_type last = std::max(m_pos, rhs.m_pos);
+        difference_type count = 0;
+        for (size_type i = first; i < last; ++i)
+        {
+            count += is_empty(i) ? 0 : 1;
+        }
+        return m_pos < rhs.m_pos ? -count : count;
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::operator*() const -> reference
+    {
+        return p_scheme->m_storage[slot()];
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::operator->() const -> pointer
+    {
+        return &(**this);
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::index() const -> const index_type&
+    {
+        p_scheme->unravel(p_scheme->m_keys[slot()], m_index);
+        return m_index;
+    }
+
+    template <class S>
+    inline bool xhash_scheme_nz_iterator<S>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && p_order == rhs.p_order && m_pos == rhs.m_pos;
+    }
+
+    template <class S>
+    inline bool xhash_scheme_nz_iterator<S>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && p_order == rhs.p_order && m_pos < rhs.m_pos;
+    }
+
+    template <class S>
+    inline auto xhash_scheme_nz_iterator<S>::slot() const -> size_type
+    {
+        return p_order == nullptr ? m_pos : (*p_order)[m_pos];
+    }
+
+    template <class S>
+    inline bool xhash_scheme_nz_iterator<S>::is_empty(size_type slot) const
+    {
+        return p_scheme->m_keys[slot] == S::empty_key;
+    }
+
+    template <class S>
+    inline bool operator==(const xhash_scheme_nz_iterator<S>& lhs,
+                           const xhash_scheme_nz_iterator<S>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class S>
+    inline bool operator<(const xhash_scheme_nz_iterator<S>& lhs,
+                          const xhash_scheme_nz_iterator<S>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
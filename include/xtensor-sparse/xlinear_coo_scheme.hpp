@@ -0,0 +1,544 @@
+#ifndef XSPARSE_LINEAR_COO_SCHEME_HPP
+#define XSPARSE_LINEAR_COO_SCHEME_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <xtl/xiterator_base.hpp>
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xstorage.hpp>
+
+#include "xutils.hpp"
+
+namespace xt
+{
+    template <class scheme>
+    class xlinear_coo_scheme_nz_iterator;
+
+    /**********************
+     * xlinear_coo_scheme *
+     **********************/
+
+    // COO scheme storing the row-major offset of each non-zero as a single
+    // integer key instead of its index. Keys are kept sorted, which is the
+    // row-major order of the elements: lookups are branchless binary searches
+    // over a flat array, batches of elements are sorted with a radix sort,
+    // and indices are only unravelled when requested by the nz_iterator.
+    // As for xhash_scheme, the shape is given by update_entries.
+    template <class K, class ST, class IT = svector<std::size_t>>
+    class xlinear_coo_scheme
+    {
+    public:
+
+        using self_type = xlinear_coo_scheme<K, ST, IT>;
+        using key_container_type = K;
+        using key_type = typename key_container_type::value_type;
+        using storage_type = ST;
+        using index_type = IT;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using nz_iterator = xlinear_coo_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xlinear_coo_scheme_nz_iterator<const self_type>;
+
+        xlinear_coo_scheme();
+
+        const key_container_type& keys() const;
+        const storage_type& storage() const;
+        const index_type& shape() const;
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class It>
+        void insert_elements(It first, It last);
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+    private:
+
+        template <class I>
+        key_type linear_offset(const I& index) const;
+        void unravel(key_type key, index_type& index) const;
+
+        std::size_t lower_bound(key_type key) const;
+
+        key_container_type m_keys;
+        storage_type m_storage;
+        index_type m_shape;
+        index_type m_strides;
+
+        friend class xlinear_coo_scheme_nz_iterator<self_type>;
+        friend class xlinear_coo_scheme_nz_iterator<const self_type>;
+    };
+
+    /******************************
+     * xdefault_linear_coo_scheme *
+     ******************************/
+
+    // The keys are linear offsets and are stored with the position type P,
+    // C is only accepted for consistency with the other schemes.
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    struct xdefault_linear_coo_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xlinear_coo_scheme<std::vector<position_value_type>, storage_type, index_type>;
+    };
+
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_linear_coo_scheme_t = typename xdefault_linear_coo_scheme<T, I, C, P>::type;
+
+    /**********************************
+     * xlinear_coo_scheme_nz_iterator *
+     **********************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xlinear_coo_scheme_storage_type
+        {
+            using storage_type = typename scheme::storage_type;
+            using value_iterator = typename storage_type::iterator;
+        };
+
+        template <class scheme>
+        struct xlinear_coo_scheme_storage_type<const scheme>
+        {
+            using storage_type = typename scheme::storage_type;
+            using value_iterator = typename storage_type::const_iterator;
+        };
+
+        template <class scheme>
+        struct xlinear_coo_scheme_nz_iterator_types : xlinear_coo_scheme_storage_type<scheme>
+        {
+            using base_type = xlinear_coo_scheme_storage_type<scheme>;
+            using index_type = typename scheme::index_type;
+            using value_iterator = typename base_type::value_iterator;
+            using value_type = typename value_iterator::value_type;
+            using reference = typename value_iterator::reference;
+            using pointer = typename value_iterator::pointer;
+            using difference_type = typename value_iterator::difference_type;
+        };
+    }
+
+    template <class scheme>
+    class xlinear_coo_scheme_nz_iterator
+        : public xtl::xrandom_access_iterator_base3<xlinear_coo_scheme_nz_iterator<scheme>,
+                                                    detail::xlinear_coo_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xlinear_coo_scheme_nz_iterator<scheme>;
+        using scheme_type = scheme;
+        using iterator_types = detail::xlinear_coo_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using value_iterator = typename iterator_types::value_iterator;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+        xlinear_coo_scheme_nz_iterator();
+        xlinear_coo_scheme_nz_iterator(scheme& s, value_iterator vit);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+    private:
+
+        scheme_type* p_scheme;
+        value_iterator m_vit;
+        mutable index_type m_index;
+    };
+
+    template <class S>
+    bool operator==(const xlinear_coo_scheme_nz_iterator<S>& lhs,
+                    const xlinear_coo_scheme_nz_iterator<S>& rhs);
+
+    template <class S>
+    bool operator<(const xlinear_coo_scheme_nz_iterator<S>& lhs,
+                   const xlinear_coo_scheme_nz_iterator<S>& rhs);
+
+    /*************************************
+     * xlinear_coo_scheme implementation *
+     *************************************/
+
+    template <class K, class ST, class IT>
+    inline xlinear_coo_scheme<K, ST, IT>::xlinear_coo_scheme()
+        : m_keys()
+        , m_storage()
+        , m_shape(xtl::make_sequence<index_type>(0))
+        , m_strides(xtl::make_sequence<index_type>(0))
+    {
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::keys() const -> const key_container_type&
+    {
+        return m_keys;
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::shape() const -> const index_type&
+    {
+        return m_shape;
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(static_cast<const self_type&>(*this).find_element(index));
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::find_element(const index_type& index) const -> const_pointer
+    {
+        key_type key = linear_offset(index);
+        std::size_t pos = lower_bound(key);
+        return (pos == m_keys.size() || m_keys[pos] != key) ? nullptr : &m_storage[pos];
+    }
+
+    template <class K, class ST, class IT>
+    inline void xlinear_coo_scheme<K, ST, IT>::insert_element(const index_type& index, const_reference value)
+    {
+        key_type key = linear_offset(index);
+        std::size_t pos = lower_bound(key);
+        if (pos != m_keys.size() && m_keys[pos] == key)
+        {
+            m_storage[pos] = value;
+        }
+        else
+        {
+            auto diff = static_cast<std::ptrdiff_t>(pos);
+            m_keys.insert(m_keys.cbegin() + diff, key);
+            m_storage.insert(m_storage.cbegin() + diff, value);
+        }
+    }
+
+    template <class K, class ST, class IT>
+    inline void xlinear_coo_scheme<K, ST, IT>::remove_element(const index_type& index)
+    {
+        key_type key = linear_offset(index);
+        std::size_t pos = lower_bound(key);
+        if (pos != m_keys.size() && m_keys[pos] == key)
+        {
+            auto diff = static_cast<std::ptrdiff_t>(pos);
+            m_keys.erase(m_keys.cbegin() + diff);
+            m_storage.erase(m_storage.cbegin() + diff);
+        }
+    }
+
+    template <class K, class ST, class IT>
+    inline void xlinear_coo_scheme<K, ST, IT>::prune(value_type tolerance)
+    {
+        std::size_t dst = 0;
+        for (std::size_t i = 0; i < m_storage.size(); ++i)
+        {
+            if (std::abs(m_storage[i]) > tolerance)
+            {
+                m_keys[dst] = m_keys[i];
+                m_storage[dst] = m_storage[i];
+                ++dst;
+            }
+        }
+        m_keys.resize(dst);
+        m_storage.resize(dst);
+    }
+
+    // The keys of [first, last) are radix sorted, then merged with the
+    // stored keys in a single linear pass. Values sharing the same index are
+    // summed, as in the COO scheme.
+    template <class K, class ST, class IT>
+    template <class It>
+    inline void xlinear_coo_scheme<K, ST, IT>::insert_elements(It first, It last)
+    {
+        key_container_type new_keys;
+        storage_type new_values;
+        for (; first != last; ++first)
+        {
+            new_keys.push_back(linear_offset(std::get<0>(*first)));
+            new_values.push_back(std::get<1>(*first));
+        }
+        detail::radix_sort(new_keys, new_values);
+
+        key_container_type keys;
+        storage_type values;
+        keys.reserve(m_keys.size() + new_keys.size());
+        values.reserve(m_keys.size() + new_keys.size());
+        std::size_t i = 0, j = 0;
+        while (i < m_keys.size() || j < new_keys.size())
+        {
+            bool take_old = j == new_keys.size() || (i < m_keys.size() && m_keys[i] <= new_keys[j]);
+            key_type key = take_old ? m_keys[i] : new_keys[j];
+            const value_type& value = take_old ? m_storage[i++] : new_values[j++];
+            if (!keys.empty() && keys.back() == key)
+            {
+                values.back() += value;
+            }
+            else
+            {
+                keys.push_back(key);
+                values.push_back(value);
+            }
+        }
+
+        using std::swap;
+        swap(m_keys, keys);
+        swap(m_storage, values);
+    }
+
+    // The keys are row-major offsets, which are preserved by a reshape or a
+    // resize; only the shape used to compute them is updated.
+    template <class K, class ST, class IT>
+    template <class strides_type, class shape_type>
+    inline void xlinear_coo_scheme<K, ST, IT>::update_entries(const strides_type&,
+                                                              const strides_type&,
+                                                              const shape_type& new_shape)
+    {
+        std::size_t dim = new_shape.size();
+        m_shape = xtl::make_sequence<index_type>(dim);
+        std::copy(new_shape.cbegin(), new_shape.cend(), m_shape.begin());
+        m_strides = xtl::make_sequence<index_type>(dim, 1u);
+        for (std::size_t d = dim; d > 1; --d)
+        {
+            m_strides[d - 2] = m_strides[d - 1] * m_shape[d - 1];
+        }
+        // Every offset must fit in key_type, which may be narrower than the
+        // value_type of index_type.
+        std::size_t size = dim == 0 ? 1u : static_cast<std::size_t>(m_strides[0] * m_shape[0]);
+        XTENSOR_ASSERT(size == 0 || size - 1u <= static_cast<std::size_t>(std::numeric_limits<key_type>::max()));
+        (void)size;
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order; the keys are
+    // then appended in increasing order, so the complexity is linear.
+    template <class K, class ST, class IT>
+    template <class It>
+    inline void xlinear_coo_scheme<K, ST, IT>::assign_nz(It first, It last)
+    {
+        m_keys.clear();
+        m_storage.clear();
+        for (; first != last; ++first)
+        {
+            m_keys.push_back(linear_offset(first.index()));
+            m_storage.push_back(*first);
+        }
+        XTENSOR_ASSERT(std::is_sorted(m_keys.cbegin(), m_keys.cend()));
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, m_storage.begin());
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, m_storage.end());
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_storage.cbegin());
+    }
+
+    template <class K, class ST, class IT>
+    inline auto xlinear_coo_scheme<K, ST, IT>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_storage.cend());
+    }
+
+    template <class K, class ST, class IT>
+    template <class I>
+    inline auto xlinear_coo_scheme<K, ST, IT>::linear_offset(const I& index) const -> key_type
+    {
+        XTENSOR_ASSERT(static_cast<std::size_t>(index.size()) == m_strides.size());
+        std::size_t res = 0;
+        for (std::size_t d = 0; d < m_strides.size(); ++d)
+        {
+            res += static_cast<std::size_t>(index[d]) * static_cast<std::size_t>(m_strides[d]);
+        }
+        return static_cast<key_type>(res);
+    }
+
+    template <class K, class ST, class IT>
+    inline void xlinear_coo_scheme<K, ST, IT>::unravel(key_type key, index_type& index) const
+    {
+        for (std::size_t d = 0; d < m_strides.size(); ++d)
+        {
+            index[d] = static_cast<typename index_type::value_type>(key / static_cast<key_type>(m_strides[d]));
+            key %= static_cast<key_type>(m_strides[d]);
+        }
+    }
+
+    template <class K, class ST, class IT>
+    inline std::size_t xlinear_coo_scheme<K, ST, IT>::lower_bound(key_type key) const
+    {
+        auto it = detail::branchless_lower_bound(m_keys.cbegin(), m_keys.size(), key);
+        return static_cast<std::size_t>(it - m_keys.cbegin());
+    }
+
+    /*************************************************
+     * xlinear_coo_scheme_nz_iterator implementation *
+     *************************************************/
+
+    template <class S>
+    inline xlinear_coo_scheme_nz_iterator<S>::xlinear_coo_scheme_nz_iterator()
+        : p_scheme(nullptr)
+    {
+    }
+
+    template <class S>
+    inline xlinear_coo_scheme_nz_iterator<S>::xlinear_coo_scheme_nz_iterator(S& s, value_iterator vit)
+        : p_scheme(&s)
+        , m_vit(vit)
+        , m_index(xtl::make_sequence<index_type>(s.m_shape.size()))
+    {
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::operator++() -> self_type&
+    {
+        ++m_vit;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::operator--() -> self_type&
+    {
+        --m_vit;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::operator+=(difference_type n) -> self_type&
+    {
+        m_vit += n;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::operator-=(difference_type n) -> self_type&
+    {
+        m_vit -= n;
+        return *this;
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return m_vit - rhs.m_vit;
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::operator*() const -> reference
+    {
+        return *m_vit;
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::operator->() const -> pointer
+    {
+        return &(*m_vit);
+    }
+
+    template <class S>
+    inline auto xlinear_coo_scheme_nz_iterator<S>::index() const -> const index_type&
+    {
+        auto pos = static_cast<std::size_t>(m_vit - p_scheme->m_storage.begin());
+        p_scheme->unravel(p_scheme->m_keys[pos], m_index);
+        return m_index;
+    }
+
+    template <class S>
+    inline bool xlinear_coo_scheme_nz_iterator<S>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_vit == rhs.m_vit;
+    }
+
+    template <class S>
+    inline bool xlinear_coo_scheme_nz_iterator<S>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_vit < rhs.m_vit;
+    }
+
+    template <class S>
+    inline bool operator==(const xlinear_coo_scheme_nz_iterator<S>& lhs,
+                           const xlinear_coo_scheme_nz_iterator<S>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class S>
+    inline bool operator<(const xlinear_coo_scheme_nz_iterator<S>& lhs,
+                          const xlinear_coo_scheme_nz_iterator<S>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
@@ -1,8 +1,14 @@
 #ifndef XSPARSE_MAP_SCHEME_HPP
 #define XSPARSE_MAP_SCHEME_HPP
 
+#include <cmath>
+
 #include <xtl/xiterator_base.hpp>
+#include <xtl/xsequence.hpp>
 #include <xtensor/xstrides.hpp>
+#include <xtensor/xutils.hpp>
+
+#include "xutils.hpp"
 
 namespace xt
 {
@@ -13,14 +19,16 @@ namespace xt
      * xmap_scheme *
      ***************/
 
-    template <class ST>
+    // The keys of the map may hold narrower integers than index_type.
+    template <class ST, class IT = typename ST::key_type>
     class xmap_scheme
     {
     public:
 
-        using self_type = xmap_scheme<ST>;
+        using self_type = xmap_scheme<ST, IT>;
         using storage_type = ST;
-        using index_type = typename storage_type::key_type;
+        using index_type = IT;
+        using stored_index_type = typename storage_type::key_type;
         using value_type = typename storage_type::mapped_type;
         using reference = value_type&;
         using const_reference = const value_type&;
@@ -36,12 +44,16 @@ namespace xt
         const_pointer find_element(const index_type& index) const;
         void insert_element(const index_type& index, const_reference value);
         void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
 
         template <class strides_type, class shape_type>
         void update_entries(const strides_type& old_strides,
                             const strides_type& new_strides,
                             const shape_type& new_shape);
 
+        template <class It>
+        void assign_nz(It first, It last);
+
         nz_iterator nz_begin();
         nz_iterator nz_end();
         const_nz_iterator nz_begin() const;
@@ -60,18 +72,19 @@ namespace xt
      * xdefault_map_scheme *
      ***********************/
 
-    template <class T, class I>
+    template <class T, class I, class C = typename I::value_type, class P = C>
     struct xdefault_map_scheme
     {
         using index_type = I;
         using value_type = T;
-        using size_type = typename index_type::value_type;
-        using storage_type = std::map<index_type, value_type>;
-        using type = xmap_scheme<storage_type>;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::map<rebind_container_t<coordinate_value_type, index_type>, value_type>;
+        using type = xmap_scheme<storage_type, index_type>;
     };
 
-    template <class T, class I>
-    using xdefault_map_scheme_t = typename xdefault_map_scheme<T, I>::type;
+    template <class T, class I, class C = typename I::value_type, class P = C>
+    using xdefault_map_scheme_t = typename xdefault_map_scheme<T, I, C, P>::type;
 
     /***************************
      * xmap_scheme_nz_iterator *
@@ -145,6 +158,7 @@ namespace xt
 
         scheme_type* p_scheme;
         subiterator m_it;
+        mutable index_type m_current_index;
     };
 
     template <class S>
@@ -159,39 +173,55 @@ namespace xt
      * xmap_scheme implementation *
      ******************************/
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::storage() const -> const storage_type&
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::storage() const -> const storage_type&
     {
         return m_storage;
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::find_element(const index_type& index) -> pointer
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::find_element(const index_type& index) -> pointer
     {
         return const_cast<pointer>(find_element_impl(index));
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::find_element(const index_type& index) const -> const_pointer
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::find_element(const index_type& index) const -> const_pointer
     {
         return find_element_impl(index);
     }
 
-    template <class ST>
-    inline void xmap_scheme<ST>::insert_element(const index_type& index, const_reference value)
+    template <class ST, class IT>
+    inline void xmap_scheme<ST, IT>::insert_element(const index_type& index, const_reference value)
     {
-        m_storage.insert(std::make_pair(index, value));
+        m_storage.insert(std::make_pair(detail::convert_index<stored_index_type>(index), value));
     }
 
-    template <class ST>
-    inline void xmap_scheme<ST>::remove_element(const index_type& index)
+    template <class ST, class IT>
+    inline void xmap_scheme<ST, IT>::remove_element(const index_type& index)
     {
-        m_storage.erase(m_storage.find(index));
+        m_storage.erase(m_storage.find(detail::convert_index<stored_index_type>(index)));
     }
 
-    template <class ST>
+    template <class ST, class IT>
+    inline void xmap_scheme<ST, IT>::prune(value_type tolerance)
+    {
+        for (auto it = m_storage.begin(); it != m_storage.end();)
+        {
+            if (std::abs(it->second) > tolerance)
+            {
+                ++it;
+            }
+            else
+            {
+                it = m_storage.erase(it);
+            }
+        }
+    }
+
+    template <class ST, class IT>
     template <class strides_type, class shape_type>
-    inline void xmap_scheme<ST>::update_entries(const strides_type& old_strides,
+    inline void xmap_scheme<ST, IT>::update_entries(const strides_type& old_strides,
                                                 const strides_type& new_strides,
                                                 const shape_type&)
     {
@@ -200,52 +230,66 @@ namespace xt
         {
             std::size_t offset = element_offset<std::size_t>(old_strides, old_entry.first.cbegin(), old_entry.first.cend());
             index_type new_index = unravel_from_strides(offset, new_strides);
-            new_storage.insert(std::make_pair(new_index, old_entry.second));
+            new_storage.insert(std::make_pair(detail::convert_index<stored_index_type>(new_index), old_entry.second));
         }
         using std::swap;
         swap(m_storage, new_storage);
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::nz_begin() -> nz_iterator
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order so that each
+    // insertion at the end of the map takes amortized constant time.
+    template <class ST, class IT>
+    template <class It>
+    inline void xmap_scheme<ST, IT>::assign_nz(It first, It last)
+    {
+        m_storage.clear();
+        for (; first != last; ++first)
+        {
+            m_storage.emplace_hint(m_storage.end(), detail::convert_index<stored_index_type>(first.index()), *first);
+        }
+    }
+
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::nz_begin() -> nz_iterator
     {
         return nz_iterator(*this, m_storage.begin());
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::nz_end() -> nz_iterator
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::nz_end() -> nz_iterator
     {
         return nz_iterator(*this, m_storage.end());
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::nz_begin() const -> const_nz_iterator
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::nz_begin() const -> const_nz_iterator
     {
         return nz_cbegin();
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::nz_end() const -> const_nz_iterator
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::nz_end() const -> const_nz_iterator
     {
         return nz_cend();
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::nz_cbegin() const -> const_nz_iterator
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::nz_cbegin() const -> const_nz_iterator
     {
         return const_nz_iterator(*this, m_storage.cbegin());
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::nz_cend() const -> const_nz_iterator
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::nz_cend() const -> const_nz_iterator
     {
         return const_nz_iterator(*this, m_storage.cend());
     }
 
-    template <class ST>
-    inline auto xmap_scheme<ST>::find_element_impl(const index_type& index) const -> const_pointer
+    template <class ST, class IT>
+    inline auto xmap_scheme<ST, IT>::find_element_impl(const index_type& index) const -> const_pointer
     {
-        auto it = m_storage.find(index);
+        auto it = m_storage.find(detail::convert_index<stored_index_type>(index));
         return it == m_storage.end() ? nullptr : &(it->second);
     }
 
@@ -298,10 +342,12 @@ namespace xt
         return *this;
     }
 
+    // std::distance only walks forward on the map, so the iterator that
+    // comes first is found from the keys.
     template <class S>
     inline auto xmap_scheme_nz_iterator<S>::operator-(const self_type& rhs) const -> difference_type
     {
-        return std::distance(m_it, rhs.m_it);
+        return rhs.less_than(*this) ? std::distance(rhs.m_it, m_it) : -std::distance(m_it, rhs.m_it);
     }
 
     template <class S>
@@ -319,7 +365,7 @@ namespace xt
     template <class S>
     inline auto xmap_scheme_nz_iterator<S>::index() const -> const index_type&
     {
-        return m_it->first;
+        return detail::convert_index(m_it->first, m_current_index);
     }
 
     template <class S>
@@ -331,7 +377,9 @@ namespace xt
     template <class S>
     inline bool xmap_scheme_nz_iterator<S>::less_than(const self_type& rhs) const
     {
-        return p_scheme == rhs.p_scheme && m_it < rhs.m_it;
+        const auto& storage = p_scheme->storage();
+        return p_scheme == rhs.p_scheme && m_it != storage.cend() &&
+               (rhs.m_it == storage.cend() || storage.key_comp()(m_it->first, rhs.m_it->first));
     }
 
     template <class S>
@@ -0,0 +1,739 @@
+#ifndef XSPARSE_SELL_SCHEME_HPP
+#define XSPARSE_SELL_SCHEME_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <xtl/xiterator_base.hpp>
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xlayout.hpp>
+#include <xtensor/xstorage.hpp>
+#include <xtensor/xstrides.hpp>
+
+namespace xt
+{
+    template <class scheme>
+    class xsell_scheme_nz_iterator;
+
+    /****************************
+     * xsell_scheme declaration *
+     ****************************/
+
+    // Sliced ELLPACK scheme (SELL-C-sigma) with chunks of CS rows and a
+    // sorting window of SW rows. Within each window, rows are sorted by
+    // decreasing length; permutation() maps the rows of the chunks back to
+    // the rows of the matrix. Each chunk is stored as a dense CS x width
+    // block in column-major order, width being its longest row, so that
+    // the j-th entries of its CS rows are contiguous in coordinate() and
+    // storage(); position() holds the offsets of the chunks. Shorter rows
+    // are padded with zeros in column 0.
+    //
+    // Rows are sorted when the scheme is built (assign_nz, update_entries,
+    // prune); insert_element keeps the current permutation and widens the
+    // chunk when needed.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT = std::array<std::size_t, 2>>
+    class xsell_scheme
+    {
+    public:
+
+        using self_type = xsell_scheme<CS, SW, P, C, ST, IT>;
+        using position_type = P;
+        using coordinate_type = C;
+        using storage_type = ST;
+        using index_type = IT;
+
+        using value_type = typename storage_type::value_type;
+        using reference = typename storage_type::reference;
+        using const_reference = typename storage_type::const_reference;
+        using pointer = typename storage_type::pointer;
+        using const_pointer = typename storage_type::const_pointer;
+
+        using nz_iterator = xsell_scheme_nz_iterator<self_type>;
+        using const_nz_iterator = xsell_scheme_nz_iterator<const self_type>;
+
+        static_assert(CS > 0 && SW > 0, "chunk size and sorting window must be positive");
+
+        static constexpr std::size_t chunk_size = CS;
+        static constexpr std::size_t sorting_window = SW;
+        static constexpr layout_type nz_layout = layout_type::row_major;
+
+        xsell_scheme();
+        xsell_scheme(std::size_t rows, std::size_t cols);
+
+        const std::array<std::size_t, 2>& shape() const;
+        const position_type& position() const;
+        const coordinate_type& coordinate() const;
+        const storage_type& storage() const;
+        const position_type& permutation() const;
+
+        storage_type& storage();
+
+        double fill_ratio() const;
+
+        pointer find_element(const index_type& index);
+        const_pointer find_element(const index_type& index) const;
+        void insert_element(const index_type& index, const_reference value);
+        void remove_element(const index_type& index);
+        void prune(value_type tolerance = value_type(0));
+
+        template <class strides_type, class shape_type>
+        void update_entries(const strides_type& old_strides,
+                            const strides_type& new_strides,
+                            const shape_type& new_shape);
+
+        template <class It>
+        void assign_nz(It first, It last);
+
+        nz_iterator nz_begin();
+        nz_iterator nz_end();
+        const_nz_iterator nz_begin() const;
+        const_nz_iterator nz_end() const;
+        const_nz_iterator nz_cbegin() const;
+        const_nz_iterator nz_cend() const;
+
+    private:
+
+        using size_type = typename position_type::value_type;
+        using entry_type = std::tuple<std::size_t, std::size_t, value_type>;
+
+        std::size_t entry_position(std::size_t row, std::size_t j) const;
+        std::size_t chunk_width(std::size_t chunk) const;
+        std::size_t lower_bound(std::size_t row, std::size_t col) const;
+        const_pointer find_element_impl(const index_type& index) const;
+        void build(const std::vector<entry_type>& entries);
+
+        std::array<std::size_t, 2> m_shape;
+        position_type m_pos;
+        coordinate_type m_coords;
+        storage_type m_storage;
+        position_type m_perm;
+        position_type m_slot;
+        position_type m_row_length;
+
+        friend class xsell_scheme_nz_iterator<self_type>;
+        friend class xsell_scheme_nz_iterator<const self_type>;
+    };
+
+    /************************
+     * xdefault_sell_scheme *
+     ************************/
+
+    // Chunks of 8 rows fill whole SIMD registers of double with SSE, AVX
+    // and AVX-512.
+    template <class T, class I, std::size_t CS = 8, std::size_t SW = 256, class C = typename I::value_type, class P = C>
+    struct xdefault_sell_scheme
+    {
+        using index_type = I;
+        using value_type = T;
+        using coordinate_value_type = C;
+        using position_value_type = P;
+        using storage_type = std::vector<value_type>;
+        using type = xsell_scheme<CS, SW,
+                                  std::vector<position_value_type>,
+                                  std::vector<coordinate_value_type>,
+                                  storage_type,
+                                  index_type>;
+    };
+
+    template <class T, class I, std::size_t CS = 8, std::size_t SW = 256, class C = typename I::value_type, class P = C>
+    using xdefault_sell_scheme_t = typename xdefault_sell_scheme<T, I, CS, SW, C, P>::type;
+
+    /****************************************
+     * xsell_scheme_nz_iterator declaration *
+     ****************************************/
+
+    namespace detail
+    {
+        template <class scheme>
+        struct xsell_scheme_nz_iterator_types
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::reference;
+            using pointer = typename storage_type::pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+
+        template <class scheme>
+        struct xsell_scheme_nz_iterator_types<const scheme>
+        {
+            using storage_type = typename scheme::storage_type;
+            using index_type = typename scheme::index_type;
+            using value_type = typename storage_type::value_type;
+            using reference = typename storage_type::const_reference;
+            using pointer = typename storage_type::const_pointer;
+            using difference_type = typename storage_type::difference_type;
+        };
+    }
+
+    // Iterates the non-zeros row by row in the order of the matrix, hence
+    // in row-major order; the padding is never visited.
+    template <class scheme>
+    class xsell_scheme_nz_iterator
+        : public xtl::xrandom_access_iterator_base3<xsell_scheme_nz_iterator<scheme>,
+                                                    detail::xsell_scheme_nz_iterator_types<scheme>>
+    {
+    public:
+
+        using self_type = xsell_scheme_nz_iterator<scheme>;
+        using scheme_type = scheme;
+        using iterator_types = detail::xsell_scheme_nz_iterator_types<scheme>;
+        using index_type = typename iterator_types::index_type;
+        using value_type = typename iterator_types::value_type;
+        using reference = typename iterator_types::reference;
+        using pointer = typename iterator_types::pointer;
+        using difference_type = typename iterator_types::difference_type;
+
+        xsell_scheme_nz_iterator(scheme& s, std::size_t row);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+        const index_type& index() const;
+
+        bool equal(const self_type& rhs) const;
+        bool less_than(const self_type& rhs) const;
+
+    private:
+
+        std::size_t row_length(std::size_t row) const;
+        void skip_empty_rows();
+
+        scheme_type* p_scheme;
+        std::size_t m_row;
+        std::size_t m_j;
+        mutable index_type m_current_index;
+    };
+
+    template <class scheme>
+    bool operator==(const xsell_scheme_nz_iterator<scheme>& lhs,
+                    const xsell_scheme_nz_iterator<scheme>& rhs);
+
+    template <class scheme>
+    bool operator<(const xsell_scheme_nz_iterator<scheme>& lhs,
+                   const xsell_scheme_nz_iterator<scheme>& rhs);
+
+    /*******************************
+     * xsell_scheme implementation *
+     *******************************/
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline xsell_scheme<CS, SW, P, C, ST, IT>::xsell_scheme()
+        : xsell_scheme(0u, 0u)
+    {
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline xsell_scheme<CS, SW, P, C, ST, IT>::xsell_scheme(std::size_t rows, std::size_t cols)
+        : m_shape({rows, cols})
+    {
+        build(std::vector<entry_type>());
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::shape() const -> const std::array<std::size_t, 2>&
+    {
+        return m_shape;
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::position() const -> const position_type&
+    {
+        return m_pos;
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::coordinate() const -> const coordinate_type&
+    {
+        return m_coords;
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::storage() const -> const storage_type&
+    {
+        return m_storage;
+    }
+
+    // permutation()[k] is the row of the matrix stored as the k-th row of
+    // the chunks.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::permutation() const -> const position_type&
+    {
+        return m_perm;
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::storage() -> storage_type&
+    {
+        return m_storage;
+    }
+
+    // Ratio of the number of stored values to the number of non-zeros, 1
+    // when all the rows of each chunk have the same length.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline double xsell_scheme<CS, SW, P, C, ST, IT>::fill_ratio() const
+    {
+        std::size_t nnz = static_cast<std::size_t>(std::accumulate(m_row_length.cbegin(), m_row_length.cend(), size_type(0)));
+        return nnz == 0 ? 1. : static_cast<double>(m_storage.size()) / static_cast<double>(nnz);
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::find_element(const index_type& index) -> pointer
+    {
+        return const_cast<pointer>(find_element_impl(index));
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::find_element(const index_type& index) const -> const_pointer
+    {
+        return find_element_impl(index);
+    }
+
+    // When the row is as long as its chunk, a column of CS entries is
+    // appended to the chunk.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline void xsell_scheme<CS, SW, P, C, ST, IT>::insert_element(const index_type& index, const_reference value)
+    {
+        XTENSOR_ASSERT(index.size() == 2);
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        XTENSOR_ASSERT(row < m_shape[0]);
+
+        std::size_t length = static_cast<std::size_t>(m_row_length[row]);
+        std::size_t j = lower_bound(row, col);
+        if (j != length && static_cast<std::size_t>(m_coords[entry_position(row, j)]) == col)
+        {
+            m_storage[entry_position(row, j)] = value;
+            return;
+        }
+
+        std::size_t chunk = static_cast<std::size_t>(m_slot[row]) / CS;
+        if (length == chunk_width(chunk))
+        {
+            auto offset = static_cast<std::ptrdiff_t>(m_pos[chunk + 1]);
+            m_coords.insert(m_coords.begin() + offset, CS, typename coordinate_type::value_type(0));
+            m_storage.insert(m_storage.begin() + offset, CS, value_type(0));
+            for (std::size_t c = chunk + 1; c < m_pos.size(); ++c)
+            {
+                m_pos[c] += static_cast<size_type>(CS);
+            }
+        }
+        for (std::size_t k = length; k > j; --k)
+        {
+            m_coords[entry_position(row, k)] = m_coords[entry_position(row, k - 1)];
+            m_storage[entry_position(row, k)] = m_storage[entry_position(row, k - 1)];
+        }
+        m_coords[entry_position(row, j)] = static_cast<typename coordinate_type::value_type>(col);
+        m_storage[entry_position(row, j)] = value;
+        ++m_row_length[row];
+    }
+
+    // The last column of the chunk is removed when no row fills it anymore.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline void xsell_scheme<CS, SW, P, C, ST, IT>::remove_element(const index_type& index)
+    {
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        if (row >= m_shape[0])
+        {
+            return;
+        }
+
+        std::size_t length = static_cast<std::size_t>(m_row_length[row]);
+        std::size_t j = lower_bound(row, col);
+        if (j == length || static_cast<std::size_t>(m_coords[entry_position(row, j)]) != col)
+        {
+            return;
+        }
+
+        for (std::size_t k = j; k + 1 < length; ++k)
+        {
+            m_coords[entry_position(row, k)] = m_coords[entry_position(row, k + 1)];
+            m_storage[entry_position(row, k)] = m_storage[entry_position(row, k + 1)];
+        }
+        m_coords[entry_position(row, length - 1)] = typename coordinate_type::value_type(0);
+        m_storage[entry_position(row, length - 1)] = value_type(0);
+        --m_row_length[row];
+
+        std::size_t chunk = static_cast<std::size_t>(m_slot[row]) / CS;
+        std::size_t width = chunk_width(chunk);
+        std::size_t last_slot = std::min((chunk + 1) * CS, m_shape[0]);
+        bool full = false;
+        for (std::size_t s = chunk * CS; s < last_slot && !full; ++s)
+        {
+            full = static_cast<std::size_t>(m_row_length[m_perm[s]]) == width;
+        }
+        if (!full)
+        {
+            auto last = static_cast<std::ptrdiff_t>(m_pos[chunk + 1]);
+            auto first = last - static_cast<std::ptrdiff_t>(CS);
+            m_coords.erase(m_coords.begin() + first, m_coords.begin() + last);
+            m_storage.erase(m_storage.begin() + first, m_storage.begin() + last);
+            for (std::size_t c = chunk + 1; c < m_pos.size(); ++c)
+            {
+                m_pos[c] -= static_cast<size_type>(CS);
+            }
+        }
+    }
+
+    // Removes the elements whose magnitude is lower than or equal to
+    // tolerance, and sorts the rows again.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline void xsell_scheme<CS, SW, P, C, ST, IT>::prune(value_type tolerance)
+    {
+        std::vector<entry_type> entries;
+        for (auto it = nz_cbegin(); it != nz_cend(); ++it)
+        {
+            if (std::abs(*it) > tolerance)
+            {
+                const auto& index = it.index();
+                entries.emplace_back(static_cast<std::size_t>(index[0]), static_cast<std::size_t>(index[1]), *it);
+            }
+        }
+        build(entries);
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    template <class strides_type, class shape_type>
+    inline void xsell_scheme<CS, SW, P, C, ST, IT>::update_entries(const strides_type& old_strides,
+                                                                   const strides_type& new_strides,
+                                                                   const shape_type& new_shape)
+    {
+        XTENSOR_ASSERT(new_shape.size() == 2);
+
+        std::vector<entry_type> entries;
+        std::array<std::size_t, 2> old_index;
+        for (auto it = nz_cbegin(); it != nz_cend(); ++it)
+        {
+            const auto& index = it.index();
+            old_index[0] = static_cast<std::size_t>(index[0]);
+            old_index[1] = static_cast<std::size_t>(index[1]);
+            std::size_t offset = element_offset<std::size_t>(old_strides, old_index.cbegin(), old_index.cend());
+            auto new_index = unravel_from_strides(offset, new_strides);
+            entries.emplace_back(new_index[0], new_index[1], *it);
+        }
+        std::sort(entries.begin(), entries.end(), [](const entry_type& lhs, const entry_type& rhs)
+        {
+            return std::tie(std::get<0>(lhs), std::get<1>(lhs)) < std::tie(std::get<0>(rhs), std::get<1>(rhs));
+        });
+
+        m_shape = {static_cast<std::size_t>(new_shape[0]), static_cast<std::size_t>(new_shape[1])};
+        build(entries);
+    }
+
+    // Replaces the stored elements with the ones of the nz_iterator range
+    // [first, last), which must be sorted in row-major order.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    template <class It>
+    inline void xsell_scheme<CS, SW, P, C, ST, IT>::assign_nz(It first, It last)
+    {
+        std::vector<entry_type> entries;
+        for (; first != last; ++first)
+        {
+            const auto& index = first.index();
+            entries.emplace_back(static_cast<std::size_t>(index[0]), static_cast<std::size_t>(index[1]), *first);
+        }
+        build(entries);
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::nz_begin() -> nz_iterator
+    {
+        return nz_iterator(*this, 0u);
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::nz_end() -> nz_iterator
+    {
+        return nz_iterator(*this, m_shape[0]);
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::nz_begin() const -> const_nz_iterator
+    {
+        return nz_cbegin();
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::nz_end() const -> const_nz_iterator
+    {
+        return nz_cend();
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::nz_cbegin() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, 0u);
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::nz_cend() const -> const_nz_iterator
+    {
+        return const_nz_iterator(*this, m_shape[0]);
+    }
+
+    // Position in coordinate() and storage() of the j-th entry of row.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline std::size_t xsell_scheme<CS, SW, P, C, ST, IT>::entry_position(std::size_t row, std::size_t j) const
+    {
+        std::size_t slot = static_cast<std::size_t>(m_slot[row]);
+        return static_cast<std::size_t>(m_pos[slot / CS]) + j * CS + slot % CS;
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline std::size_t xsell_scheme<CS, SW, P, C, ST, IT>::chunk_width(std::size_t chunk) const
+    {
+        return static_cast<std::size_t>(m_pos[chunk + 1] - m_pos[chunk]) / CS;
+    }
+
+    // Binary search of col among the entries of row, which are CS apart.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline std::size_t xsell_scheme<CS, SW, P, C, ST, IT>::lower_bound(std::size_t row, std::size_t col) const
+    {
+        std::size_t first = 0;
+        std::size_t count = static_cast<std::size_t>(m_row_length[row]);
+        while (count > 0)
+        {
+            std::size_t step = count / 2;
+            if (static_cast<std::size_t>(m_coords[entry_position(row, first + step)]) < col)
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline auto xsell_scheme<CS, SW, P, C, ST, IT>::find_element_impl(const index_type& index) const -> const_pointer
+    {
+        std::size_t row = static_cast<std::size_t>(index[0]);
+        std::size_t col = static_cast<std::size_t>(index[1]);
+        if (row >= m_shape[0])
+        {
+            return nullptr;
+        }
+        std::size_t j = lower_bound(row, col);
+        if (j == static_cast<std::size_t>(m_row_length[row]) || static_cast<std::size_t>(m_coords[entry_position(row, j)]) != col)
+        {
+            return nullptr;
+        }
+        return &m_storage[entry_position(row, j)];
+    }
+
+    // Builds the chunks from entries sorted in row-major order: rows are
+    // sorted by decreasing length within each window of SW rows (stable,
+    // so that rows of equal lengths keep their order), then each chunk is
+    // as wide as its first row.
+    template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT>
+    inline void xsell_scheme<CS, SW, P, C, ST, IT>::build(const std::vector<entry_type>& entries)
+    {
+        std::size_t rows = m_shape[0];
+        std::size_t nb_chunks = (rows + CS - 1) / CS;
+
+        m_row_length.assign(rows, size_type(0));
+        for (const auto& entry: entries)
+        {
+            XTENSOR_ASSERT(std::get<0>(entry) < rows);
+            ++m_row_length[std::get<0>(entry)];
+        }
+
+        m_perm.resize(rows);
+        std::iota(m_perm.begin(), m_perm.end(), size_type(0));
+        for (std::size_t first = 0; first < rows; first += SW)
+        {
+            auto last = m_perm.begin() + static_cast<std::ptrdiff_t>(std::min(first + SW, rows));
+            std::stable_sort(m_perm.begin() + static_cast<std::ptrdiff_t>(first), last, [this](size_type lhs, size_type rhs)
+            {
+                return m_row_length[lhs] > m_row_length[rhs];
+            });
+        }
+        m_slot.resize(rows);
+        for (std::size_t s = 0; s < rows; ++s)
+        {
+            m_slot[m_perm[s]] = static_cast<size_type>(s);
+        }
+
+        m_pos.assign(nb_chunks + 1, size_type(0));
+        for (std::size_t c = 0; c < nb_chunks; ++c)
+        {
+            size_type width = 0;
+            for (std::size_t s = c * CS; s < std::min((c + 1) * CS, rows); ++s)
+            {
+                width = std::max(width, m_row_length[m_perm[s]]);
+            }
+            m_pos[c + 1] = m_pos[c] + width * static_cast<size_type>(CS);
+        }
+
+        m_coords.assign(static_cast<std::size_t>(m_pos[nb_chunks]), typename coordinate_type::value_type(0));
+        m_storage.assign(static_cast<std::size_t>(m_pos[nb_chunks]), value_type(0));
+        std::size_t row = 0;
+        std::size_t j = 0;
+        for (const auto& entry: entries)
+        {
+            j = std::get<0>(entry) == row ? j : 0;
+            row = std::get<0>(entry);
+            std::size_t p = entry_position(row, j++);
+            m_coords[p] = static_cast<typename coordinate_type::value_type>(std::get<1>(entry));
+            m_storage[p] = std::get<2>(entry);
+        }
+    }
+
+    /*******************************************
+     * xsell_scheme_nz_iterator implementation *
+     *******************************************/
+
+    template <class scheme>
+    inline xsell_scheme_nz_iterator<scheme>::xsell_scheme_nz_iterator(scheme& s, std::size_t row)
+        : p_scheme(&s)
+        , m_row(row)
+        , m_j(0)
+        , m_current_index(xtl::make_sequence<index_type>(2))
+    {
+        skip_empty_rows();
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::operator++() -> self_type&
+    {
+        ++m_j;
+        skip_empty_rows();
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::operator--() -> self_type&
+    {
+        if (m_j != 0)
+        {
+            --m_j;
+            return *this;
+        }
+        do
+        {
+            --m_row;
+        }
+        while (row_length(m_row) == 0);
+        m_j = row_length(m_row) - 1;
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::operator+=(difference_type n) -> self_type&
+    {
+        for (; n > 0; --n)
+        {
+            ++(*this);
+        }
+        for (; n < 0; ++n)
+        {
+            --(*this);
+        }
+        return *this;
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::operator-=(difference_type n) -> self_type&
+    {
+        return *this += -n;
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::operator-(const self_type& rhs) const -> difference_type
+    {
+        const self_type& first = less_than(rhs) ? *this : rhs;
+        const self_type& last = less_than(rhs) ? rhs : *this;
+        std::size_t count = last.m_j;
+        for (std::size_t row = first.m_row; row < last.m_row; ++row)
+        {
+            count += row_length(row);
+        }
+        count -= first.m_j;
+        difference_type res = static_cast<difference_type>(count);
+        return less_than(rhs) ? -res : res;
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::operator*() const -> reference
+    {
+        return p_scheme->m_storage[p_scheme->entry_position(m_row, m_j)];
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::operator->() const -> pointer
+    {
+        return &(this->operator*());
+    }
+
+    template <class scheme>
+    inline auto xsell_scheme_nz_iterator<scheme>::index() const -> const index_type&
+    {
+        m_current_index[0] = m_row;
+        m_current_index[1] = static_cast<std::size_t>(p_scheme->m_coords[p_scheme->entry_position(m_row, m_j)]);
+        return m_current_index;
+    }
+
+    template <class scheme>
+    inline bool xsell_scheme_nz_iterator<scheme>::equal(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && m_row == rhs.m_row && m_j == rhs.m_j;
+    }
+
+    template <class scheme>
+    inline bool xsell_scheme_nz_iterator<scheme>::less_than(const self_type& rhs) const
+    {
+        return p_scheme == rhs.p_scheme && std::tie(m_row, m_j) < std::tie(rhs.m_row, rhs.m_j);
+    }
+
+    template <class scheme>
+    inline std::size_t xsell_scheme_nz_iterator<scheme>::row_length(std::size_t row) const
+    {
+        return static_cast<std::size_t>(p_scheme->m_row_length[row]);
+    }
+
+    template <class scheme>
+    inline void xsell_scheme_nz_iterator<scheme>::skip_empty_rows()
+    {
+        std::size_t rows = p_scheme->m_shape[0];
+        while (m_row < rows && m_j == row_length(m_row))
+        {
+            ++m_row;
+            m_j = 0;
+        }
+    }
+
+    template <class scheme>
+    inline bool operator==(const xsell_scheme_nz_iterator<scheme>& lhs,
+                           const xsell_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class scheme>
+    inline bool operator<(const xsell_scheme_nz_iterator<scheme>& lhs,
+                          const xsell_scheme_nz_iterator<scheme>& rhs)
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include "xcsr_scheme.hpp"
 #include "xmap_scheme.hpp"
 #include "xsparse_container.hpp"
+#include "xsparse_stepper.hpp"
 
 namespace xt
 {
@@ -47,7 +48,7 @@ namespace xt
     {
         using array_type = xsparse_array<T, S>;
         using inner_shape_type = typename xcontainer_inner_types<array_type>::shape_type;
-        using const_stepper = xindexed_stepper<array_type, true>;
+        using const_stepper = xsparse_const_stepper_t<array_type, S>;
         using stepper = xindexed_stepper<array_type, false>;
     };
 
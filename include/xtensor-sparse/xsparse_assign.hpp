@@ -1,12 +1,294 @@
 #ifndef XSPARSE_ASSIGN_HPP
 #define XSPARSE_ASSIGN_HPP
 
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+#include <xtl/xtype_traits.hpp>
+
 #include <xtensor/xassign.hpp>
+#include <xtensor/xbroadcast.hpp>
+#include <xtensor/xfunction.hpp>
+#include <xtensor/xlayout.hpp>
+#include <xtensor/xscalar.hpp>
+#include <xtensor/xutils.hpp>
 
 #include "xsparse_expression.hpp"
+#include "xutils.hpp"
 
 namespace xt
 {
+    namespace detail
+    {
+        /**********************
+         * xentry_nz_iterator *
+         **********************/
+
+        // Exposes a range of (index, value) pairs through the index() and
+        // operator* of nz_iterators, as expected by the assign_nz method
+        // of the schemes.
+        template <class It>
+        class xentry_nz_iterator
+        {
+        public:
+
+            using self_type = xentry_nz_iterator<It>;
+            using index_type = typename std::iterator_traits<It>::value_type::first_type;
+            using value_type = typename std::iterator_traits<It>::value_type::second_type;
+
+            explicit xentry_nz_iterator(It it);
+
+            const index_type& index() const;
+            const value_type& operator*() const;
+
+            self_type& operator++();
+
+            bool operator!=(const self_type& rhs) const;
+
+        private:
+
+            It m_it;
+        };
+
+        template <class It>
+        inline xentry_nz_iterator<It>::xentry_nz_iterator(It it)
+            : m_it(it)
+        {
+        }
+
+        template <class It>
+        inline auto xentry_nz_iterator<It>::index() const -> const index_type&
+        {
+            return m_it->first;
+        }
+
+        template <class It>
+        inline auto xentry_nz_iterator<It>::operator*() const -> const value_type&
+        {
+            return m_it->second;
+        }
+
+        template <class It>
+        inline auto xentry_nz_iterator<It>::operator++() -> self_type&
+        {
+            ++m_it;
+            return *this;
+        }
+
+        template <class It>
+        inline bool xentry_nz_iterator<It>::operator!=(const self_type& rhs) const
+        {
+            return m_it != rhs.m_it;
+        }
+
+        /*******************
+         * sparse_assigner *
+         *******************/
+
+        template <class E1, class E2, class = void_t<>>
+        struct has_same_scheme : std::false_type
+        {
+        };
+
+        template <class E1, class E2>
+        struct has_same_scheme<E1, E2, void_t<typename E1::scheme_type, typename E2::scheme_type>>
+            : std::is_same<typename E1::scheme_type, typename E2::scheme_type>
+        {
+        };
+
+        struct same_scheme_assign {};
+        struct sorted_nz_assign {};
+        struct unsorted_nz_assign {};
+
+        // Expressions whose nz_iterator is row-major can be appended as they
+        // are iterated; others (e.g. CSC) are gathered and sorted first.
+        template <class E1, class E2>
+        using sparse_assign_path_t = std::conditional_t<has_same_scheme<E1, E2>::value,
+                                                        same_scheme_assign,
+                                                        std::conditional_t<extension::get_nz_layout<E2>::value == layout_type::row_major,
+                                                                           sorted_nz_assign,
+                                                                           unsorted_nz_assign>>;
+
+        template <class E1, class E2>
+        inline void assign_sparse(E1& e1, const E2& e2, same_scheme_assign)
+        {
+            e1.scheme() = e2.scheme();
+        }
+
+        template <class E1, class E2>
+        inline void assign_sparse(E1& e1, const E2& e2, sorted_nz_assign)
+        {
+            e1.scheme().assign_nz(e2.nz_cbegin(), e2.nz_cend());
+        }
+
+        template <class E1, class E2>
+        inline void assign_sparse(E1& e1, const E2& e2, unsorted_nz_assign)
+        {
+            using index_type = typename E1::index_type;
+            using value_type = typename E1::value_type;
+            using entry_type = std::pair<index_type, value_type>;
+
+            std::vector<entry_type> entries;
+            for (auto it = e2.nz_cbegin(); it != e2.nz_cend(); ++it)
+            {
+                const auto& index = it.index();
+                entries.emplace_back(xtl::forward_sequence<index_type, decltype(index)>(index), *it);
+            }
+            std::sort(entries.begin(), entries.end(), [](const entry_type& lhs, const entry_type& rhs)
+            {
+                return std::lexicographical_compare(lhs.first.cbegin(), lhs.first.cend(),
+                                                    rhs.first.cbegin(), rhs.first.cend());
+            });
+
+            using iterator = xentry_nz_iterator<typename std::vector<entry_type>::const_iterator>;
+            e1.scheme().assign_nz(iterator(entries.cbegin()), iterator(entries.cend()));
+        }
+
+        /******************
+         * scatter_assign *
+         ******************/
+
+        // Expressions whose leaves are all sparse or scalars provide an
+        // nz_iterator. A product of sparse and dense operands is tagged as
+        // sparse, but cannot iterate the non-zeros of its dense operands.
+        template <class E>
+        struct has_nz_iterator : is_xsparse_expression<E>
+        {
+        };
+
+        template <class CT>
+        struct has_nz_iterator<xscalar<CT>> : std::true_type
+        {
+        };
+
+        template <class F, class... CT>
+        struct has_nz_iterator<xfunction<F, CT...>> : xtl::conjunction<has_nz_iterator<std::decay_t<CT>>...>
+        {
+        };
+
+        // Operands that are zero outside of their non-zeros.
+        template <class CT>
+        using is_zero_off_nz = std::integral_constant<bool,
+            has_nz_iterator<std::decay_t<CT>>::value &&
+            std::is_same<extension::get_assign_tag_t<CT>, extension::xsparse_assign_tag>::value>;
+
+        template <class E, class S>
+        inline const E& zero_operand(const E& e, const S& /*shape*/, std::false_type)
+        {
+            return e;
+        }
+
+        template <class E, class S>
+        inline auto zero_operand(const E& /*e*/, const S& shape, std::true_type)
+        {
+            return broadcast(typename E::value_type(0), shape);
+        }
+
+        template <class E, class S>
+        inline bool has_shape(const E& /*e*/, const S& /*shape*/, std::false_type)
+        {
+            return true;
+        }
+
+        template <class E, class S>
+        inline bool has_shape(const E& e, const S& shape, std::true_type)
+        {
+            return e.shape().size() == shape.size() &&
+                std::equal(e.shape().cbegin(), e.shape().cend(), shape.cbegin());
+        }
+
+        template <class E1, class E2, class E>
+        inline void scatter_nz(E1& /*e1*/, const E2& /*e2*/, const E& /*e*/, std::false_type)
+        {
+        }
+
+        template <class E1, class E2, class E>
+        inline void scatter_nz(E1& e1, const E2& e2, const E& e, std::true_type)
+        {
+            for (auto it = e.nz_cbegin(); it != e.nz_cend(); ++it)
+            {
+                const auto& index = it.index();
+                e1.element(index.cbegin(), index.cend()) = e2.element(index.cbegin(), index.cend());
+            }
+        }
+
+        template <class F, class... CT, class... E>
+        inline auto rebind_operands(const xfunction<F, CT...>& f, E&&... e)
+        {
+            using function_type = xfunction<F, const_xclosure_t<E>...>;
+            return function_type(f.functor(), std::forward<E>(e)...);
+        }
+
+        template <class E1, class F, class... CT, std::size_t... I>
+        inline void scatter_assign_impl(E1& e1, const xfunction<F, CT...>& e2, std::index_sequence<I...>)
+        {
+            const auto& shape = e2.shape();
+            bool same_shape = true;
+            static_for<sizeof...(CT)>([&](auto i)
+            {
+                using closure_type = std::tuple_element_t<decltype(i)::value, std::tuple<CT...>>;
+                same_shape = same_shape && has_shape(std::get<i>(e2.arguments()), shape, is_zero_off_nz<closure_type>());
+            });
+            // Broadcast sparse operands would have to be scattered along the
+            // broadcast dimensions; they keep the element-wise evaluation.
+            if (!same_shape)
+            {
+                xexpression_assigner<xtensor_expression_tag>::assign_xexpression(e1, e2);
+                return;
+            }
+
+            auto dense_part = rebind_operands(e2, zero_operand(std::get<I>(e2.arguments()), shape, is_zero_off_nz<CT>())...);
+            xexpression_assigner<xtensor_expression_tag>::assign_xexpression(e1, dense_part);
+            static_for<sizeof...(CT)>([&](auto i)
+            {
+                using closure_type = std::tuple_element_t<decltype(i)::value, std::tuple<CT...>>;
+                scatter_nz(e1, e2, std::get<i>(e2.arguments()), is_zero_off_nz<closure_type>());
+            });
+        }
+
+        // e1 is filled with zeros, then the non-zeros of e2 are scattered
+        // into it.
+        template <class E1, class E2>
+        inline void scatter_nz_assign(E1& e1, const E2& e2, std::true_type /* has_nz_iterator */)
+        {
+            using value_type = typename E2::value_type;
+
+            xexpression_assigner<xtensor_expression_tag>::assign_xexpression(e1, broadcast(value_type(0), e2.shape()));
+            for (auto it = e2.nz_cbegin(); it != e2.nz_cend(); ++it)
+            {
+                const auto& index = it.index();
+                e1.element(index.cbegin(), index.cend()) = *it;
+            }
+        }
+
+        template <class E1, class E2>
+        inline void scatter_nz_assign(E1& e1, const E2& e2, std::false_type /* has_nz_iterator */)
+        {
+            xexpression_assigner<xtensor_expression_tag>::assign_xexpression(e1, e2);
+        }
+
+        template <class E1, class E2>
+        inline void scatter_assign(E1& e1, const E2& e2)
+        {
+            xexpression_assigner<xtensor_expression_tag>::assign_xexpression(e1, e2);
+        }
+
+        // The function is first evaluated with its sparse operands replaced
+        // by zeros, which only involves dense operands and steppers; the
+        // elements at the non-zeros of the sparse operands are then
+        // recomputed. The complexity is O(size + nnz) lookups instead of a
+        // lookup per element.
+        template <class E1, class F, class... CT>
+        inline void scatter_assign(E1& e1, const xfunction<F, CT...>& e2)
+        {
+            scatter_assign_impl(e1, e2, std::make_index_sequence<sizeof...(CT)>());
+        }
+    }
+
     template <class T1, class T2>
     struct xsparse_assigner: public xexpression_assigner<xtensor_expression_tag>
     {};
@@ -14,17 +296,45 @@ namespace xt
     template <>
     struct xsparse_assigner<xsparse_expression_tag, extension::xsparse_assign_tag>
     {
+        // The stored elements of e1 are replaced in O(nnz) when e2 has the
+        // same scheme or iterates its non-zeros in row-major order, and in
+        // O(nnz log(nnz)) otherwise. The scheme of e1 is emptied before its
+        // shape is set, so that the elements about to be replaced are not
+        // remapped to the new shape.
         template <class E1, class E2>
         static void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
         {
+            using scheme_type = typename E1::scheme_type;
+
             E1& de1 = e1.derived_cast();
             const E2& de2 = e2.derived_cast();
 
-            de1.resize(de2.shape());
-            for(auto it = de2.nz_cbegin(); it != de2.nz_cend(); ++it)
-            {
-                de1.insert_element(it.index(), *it);
-            }
+            de1.scheme() = scheme_type();
+            de1.resize(de2.shape(), true);
+            detail::assign_sparse(de1, de2, detail::sparse_assign_path_t<E1, E2>());
+        }
+    };
+
+    template <>
+    struct xsparse_assigner<xtensor_expression_tag, extension::xsparse_assign_tag>
+    {
+        // The non-zeros of e2 are scattered into e1 when all the leaves of
+        // e2 are sparse; products with dense operands are evaluated element
+        // wise.
+        template <class E1, class E2>
+        static void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
+        {
+            detail::scatter_nz_assign(e1.derived_cast(), e2.derived_cast(), detail::has_nz_iterator<E2>());
+        }
+    };
+
+    template <>
+    struct xsparse_assigner<xtensor_expression_tag, extension::xdense_assign_tag>
+    {
+        template <class E1, class E2>
+        static void assign_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2)
+        {
+            detail::scatter_assign(e1.derived_cast(), e2.derived_cast());
         }
     };
 
@@ -43,4 +353,4 @@ namespace xt
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -5,11 +5,19 @@
 #define XTENSOR_SPARSE_VERSION_MINOR 0
 #define XTENSOR_SPARSE_VERSION_PATCH 1
 
+// C and P are the integer types used to store the coordinates and the
+// positions of the scheme, the index type of the API is always std::size_t.
+#define XSPARSE_ARRAY_SCHEME(SCHEME, T, C, P) \
+    xt::xdefault_##SCHEME##_scheme_t<T, svector<std::size_t>, C, P>
+
+#define XSPARSE_TENSOR_SCHEME(SCHEME, T, N, C, P) \
+    xt::xdefault_##SCHEME##_scheme_t<T, std::array<std::size_t, N>, C, P>
+
 #define XSPARSE_DEFAULT_ARRAY_SCHEME(SCHEME, T) \
-    xt::xdefault_##SCHEME##_scheme_t<T, svector<std::size_t>>
+    XSPARSE_ARRAY_SCHEME(SCHEME, T, std::size_t, std::size_t)
 
 #define XSPARSE_DEFAULT_TENSOR_SCHEME(SCHEME, T, N) \
-    xt::xdefault_##SCHEME##_scheme_t<T, std::array<std::size_t, N>>
+    XSPARSE_TENSOR_SCHEME(SCHEME, T, N, std::size_t, std::size_t)
 
 #define XSPARSE_DEFAULT_ARRAY(T) \
     xsparse_array<T, XSPARSE_DEFAULT_ARRAY_SCHEME(coo, T)>
@@ -12,6 +12,20 @@
 
 namespace xt
 {
+    namespace detail
+    {
+        template <class S, class It, class = void_t<>>
+        struct has_insert_elements : std::false_type
+        {
+        };
+
+        template <class S, class It>
+        struct has_insert_elements<S, It, void_t<decltype(std::declval<S&>().insert_elements(std::declval<It>(), std::declval<It>()))>>
+            : std::true_type
+        {
+        };
+    }
+
     /*********************
      * xsparse_container *
      *********************/
@@ -52,6 +66,7 @@ namespace xt
 
         static constexpr layout_type static_layout = layout_type::row_major;
         static constexpr bool contiguous_layout = false;
+        static constexpr layout_type nz_layout = extension::get_nz_layout<scheme_type>::value;
 
         using nz_iterator = typename scheme_type::nz_iterator;
         using const_nz_iterator = typename scheme_type::const_nz_iterator;
@@ -89,9 +104,15 @@ namespace xt
 
         void insert_element(const index_type& index, const_reference value);
 
+        template <class It>
+        void insert_elements(It first, It last);
+
+        void prune(value_type tolerance = value_type(0));
+
         template <class S>
         bool broadcast_shape(S& shape, bool reuse_cache = false) const;
 
+        scheme_type& scheme();
         const scheme_type& scheme() const;
 
         template <class S>
@@ -136,6 +157,11 @@ namespace xt
         template <class S = shape_type>
         void reshape_impl(S&& shape, std::true_type);
 
+        template <class It>
+        void insert_elements_impl(It first, It last, std::true_type);
+        template <class It>
+        void insert_elements_impl(It first, It last, std::false_type);
+
         index_type make_index() const;
 
         template <class Arg, class... Args>
@@ -267,6 +293,23 @@ namespace xt
         m_scheme.insert_element(index, value);
     }
 
+    // Inserts the (index, value) pairs in [first, last); values sharing the
+    // same index are summed with each other and with the existing element.
+    // Schemes with a batch insertion sort the pairs once, the others get
+    // them one at a time.
+    template <class D>
+    template <class It>
+    inline void xsparse_container<D>::insert_elements(It first, It last)
+    {
+        insert_elements_impl(first, last, detail::has_insert_elements<scheme_type, It>());
+    }
+
+    template <class D>
+    inline void xsparse_container<D>::prune(value_type tolerance)
+    {
+        m_scheme.prune(tolerance);
+    }
+
     template <class D>
     template <class S>
     inline bool xsparse_container<D>::broadcast_shape(S& shape, bool) const
@@ -274,6 +317,12 @@ namespace xt
         return xt::broadcast_shape(this->shape(), shape);
     }
 
+    template <class D>
+    inline auto xsparse_container<D>::scheme() -> scheme_type&
+    {
+        return m_scheme;
+    }
+
     template <class D>
     inline auto xsparse_container<D>::scheme() const -> const scheme_type&
     {
@@ -425,6 +474,31 @@ namespace xt
         m_scheme.update_entries(old_strides, m_strides, m_shape);
     }
 
+    template <class D>
+    template <class It>
+    inline void xsparse_container<D>::insert_elements_impl(It first, It last, std::true_type /* batch */)
+    {
+        m_scheme.insert_elements(first, last);
+    }
+
+    template <class D>
+    template <class It>
+    inline void xsparse_container<D>::insert_elements_impl(It first, It last, std::false_type /* batch */)
+    {
+        for (; first != last; ++first)
+        {
+            pointer p = m_scheme.find_element(first->first);
+            if (p != nullptr)
+            {
+                *p += first->second;
+            }
+            else
+            {
+                m_scheme.insert_element(first->first, first->second);
+            }
+        }
+    }
+
     template <class D>
     inline auto xsparse_container<D>::make_index() const -> index_type
     {
@@ -0,0 +1,511 @@
+#ifndef XSPARSE_CONVERT_HPP
+#define XSPARSE_CONVERT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xarray.hpp>
+#include <xtensor/xeval.hpp>
+#include <xtensor/xexception.hpp>
+#include <xtensor/xexpression.hpp>
+#include <xtensor/xlayout.hpp>
+
+#include "xcoo_scheme.hpp"
+#include "xcsr_scheme.hpp"
+#include "xsparse_array.hpp"
+#include "xsparse_assign.hpp"
+#include "xsparse_expression.hpp"
+#include "xsparse_linalg.hpp"
+#include "xsparse_tensor.hpp"
+
+namespace xt
+{
+    namespace sparse
+    {
+        /*****************
+         * rebind_scheme *
+         *****************/
+
+        template <class D, class S>
+        struct rebind_scheme;
+
+        template <class T, class S0, class S>
+        struct rebind_scheme<xsparse_array<T, S0>, S>
+        {
+            using type = xsparse_array<T, S>;
+        };
+
+        template <class T, std::size_t N, class S0, class S>
+        struct rebind_scheme<xsparse_tensor<T, N, S0>, S>
+        {
+            using type = xsparse_tensor<T, N, S>;
+        };
+
+        template <class D, class S>
+        using rebind_scheme_t = typename rebind_scheme<D, S>::type;
+
+        /***********
+         * convert *
+         ***********/
+
+        namespace detail
+        {
+            struct copy_convert {};
+            struct nz_convert {};
+            struct transpose_convert {};
+            struct sorted_convert {};
+
+            template <class SS>
+            using nz_convert_tag_t = std::conditional_t<extension::get_nz_layout<SS>::value == layout_type::row_major,
+                                                        nz_convert,
+                                                        std::conditional_t<extension::get_nz_layout<SS>::value == layout_type::column_major,
+                                                                           transpose_convert,
+                                                                           sorted_convert>>;
+
+            template <class SS, class TS>
+            using convert_tag_t = std::conditional_t<std::is_same<SS, TS>::value,
+                                                     copy_convert,
+                                                     nz_convert_tag_t<SS>>;
+
+            template <class S, class Sh>
+            inline void convert_scheme(const S& src, S& dst, const Sh& /*shape*/, copy_convert)
+            {
+                dst = src;
+            }
+
+            // The source is iterated in row-major order, which is what the
+            // assign_nz method of every scheme expects: COO and map are
+            // appended, CSR and CSC are built with a counting sort and CSF
+            // level by level.
+            template <class SS, class TS, class Sh>
+            inline void convert_scheme(const SS& src, TS& dst, const Sh& /*shape*/, nz_convert)
+            {
+                dst.assign_nz(src.nz_cbegin(), src.nz_cend());
+            }
+
+            // A CSC source holds the compressed arrays of the transpose, so
+            // a counting sort on its row coordinates gives the CSR arrays.
+            template <class P, class C, class ST, class IT, class P2, class C2, class ST2, class IT2, class Sh>
+            inline void convert_scheme(const xcsr_scheme<P, C, ST, IT, layout_type::column_major>& src,
+                                       xcsr_scheme<P2, C2, ST2, IT2, layout_type::row_major>& dst,
+                                       const Sh& shape,
+                                       transpose_convert)
+            {
+                transpose_compressed(src.position(), src.coordinate(), src.storage(), shape[0], dst);
+            }
+
+            template <class P, class C, class ST, class IT, class TS, class Sh>
+            inline void convert_scheme(const xcsr_scheme<P, C, ST, IT, layout_type::column_major>& src,
+                                       TS& dst,
+                                       const Sh& shape,
+                                       transpose_convert)
+            {
+                using size_type = typename P::value_type;
+                using csr_type = xcsr_scheme<std::vector<size_type>, std::vector<size_type>, ST, std::array<std::size_t, 2>>;
+
+                csr_type tmp;
+                transpose_compressed(src.position(), src.coordinate(), src.storage(), shape[0], tmp);
+                dst.assign_nz(tmp.nz_cbegin(), tmp.nz_cend());
+            }
+
+            // Gathers the non-zeros of src, sorts them in row-major order and
+            // assigns them to dst.
+            template <class SS, class TS>
+            inline void assign_sorted_nz(const SS& src, TS& dst)
+            {
+                using index_type = typename TS::index_type;
+                using value_type = typename TS::value_type;
+                using entry_type = std::pair<index_type, value_type>;
+
+                std::vector<entry_type> entries;
+                for (auto it = src.nz_cbegin(); it != src.nz_cend(); ++it)
+                {
+                    const auto& index = it.index();
+                    entries.emplace_back(xtl::forward_sequence<index_type, decltype(index)>(index), *it);
+                }
+                std::sort(entries.begin(), entries.end(), [](const entry_type& lhs, const entry_type& rhs)
+                {
+                    return std::lexicographical_compare(lhs.first.cbegin(), lhs.first.cend(),
+                                                        rhs.first.cbegin(), rhs.first.cend());
+                });
+
+                using iterator = xt::detail::xentry_nz_iterator<typename std::vector<entry_type>::const_iterator>;
+                dst.assign_nz(iterator(entries.cbegin()), iterator(entries.cend()));
+            }
+
+            // Other column-major schemes (DCSC) are gathered and sorted.
+            template <class SS, class TS, class Sh>
+            inline void convert_scheme(const SS& src, TS& dst, const Sh& /*shape*/, transpose_convert)
+            {
+                assign_sorted_nz(src, dst);
+            }
+
+            template <class S, class = void_t<>>
+            struct has_sorted_order : std::false_type
+            {
+            };
+
+            template <class S>
+            struct has_sorted_order<S, void_t<decltype(std::declval<const S&>().sorted_order())>> : std::true_type
+            {
+            };
+
+            // Schemes without a natural order (hash) provide the permutation
+            // of their non-zeros in row-major order; the others (BCSR) are
+            // gathered and sorted.
+            template <class SS, class TS>
+            inline void assign_unordered_nz(const SS& src, TS& dst, std::true_type /* has_sorted_order */)
+            {
+                auto order = src.sorted_order();
+                dst.assign_nz(src.nz_cbegin(order), src.nz_cend(order));
+            }
+
+            template <class SS, class TS>
+            inline void assign_unordered_nz(const SS& src, TS& dst, std::false_type /* has_sorted_order */)
+            {
+                assign_sorted_nz(src, dst);
+            }
+
+            template <class SS, class TS, class Sh>
+            inline void convert_scheme(const SS& src, TS& dst, const Sh& /*shape*/, sorted_convert)
+            {
+                assign_unordered_nz(src, dst, has_sorted_order<SS>());
+            }
+        }
+
+        // Returns a copy of e whose elements are stored with the scheme S, in
+        // O(nnz) (plus the size of the outer dimension for CSR and CSC).
+        template <class S, class D>
+        inline auto convert(const xsparse_container<D>& e) -> rebind_scheme_t<D, S>
+        {
+            using source_scheme = typename D::scheme_type;
+            using result_type = rebind_scheme_t<D, S>;
+
+            result_type res(e.shape());
+            detail::convert_scheme(e.scheme(), res.scheme(), e.shape(), detail::convert_tag_t<source_scheme, S>());
+            return res;
+        }
+
+        /********************
+         * block_fill_ratio *
+         ********************/
+
+        // Fill ratio (stored values over non-zeros) that a CSR matrix with
+        // cols columns would have once converted to BCSR with R x CB blocks,
+        // computed in O(nnz + cols / CB) without building the blocks. Use it
+        // to pick the block size before calling convert.
+        template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT>
+        inline double block_fill_ratio(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, std::size_t cols)
+        {
+            const auto& pos = a.position();
+            const auto& coords = a.coordinate();
+            std::size_t rows = pos.size() - 1;
+            std::size_t nnz = static_cast<std::size_t>(pos[rows]);
+            if (nnz == 0)
+            {
+                return 1.;
+            }
+
+            // Last block row seen in each block column; a block is counted
+            // the first time one of its non-zeros is met.
+            std::size_t nb_blocks = 0;
+            std::vector<std::size_t> last_seen((cols + CB - 1) / CB, rows);
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                for (std::size_t j = pos[i]; j < pos[i + 1]; ++j)
+                {
+                    std::size_t block_col = static_cast<std::size_t>(coords[j]) / CB;
+                    if (last_seen[block_col] != i / R)
+                    {
+                        last_seen[block_col] = i / R;
+                        ++nb_blocks;
+                    }
+                }
+            }
+            return static_cast<double>(nb_blocks * R * CB) / static_cast<double>(nnz);
+        }
+
+        template <std::size_t R, std::size_t CB, class D>
+        inline double block_fill_ratio(const xsparse_container<D>& a)
+        {
+            return block_fill_ratio<R, CB>(a.scheme(), a.shape()[1]);
+        }
+
+        /******************
+         * dia_fill_ratio *
+         ******************/
+
+        namespace detail
+        {
+            // Number of diagonals holding a non-zero of a CSR matrix with
+            // cols columns, in O(nnz + rows + cols).
+            template <class P, class C, class ST, class IT>
+            inline std::size_t count_diagonals(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, std::size_t cols)
+            {
+                const auto& pos = a.position();
+                const auto& coords = a.coordinate();
+                std::size_t rows = pos.size() - 1;
+                std::vector<bool> occupied(rows + cols, false);
+                std::size_t res = 0;
+                for (std::size_t i = 0; i < rows; ++i)
+                {
+                    for (std::size_t j = pos[i]; j < pos[i + 1]; ++j)
+                    {
+                        std::size_t d = static_cast<std::size_t>(coords[j]) + rows - i;
+                        res += occupied[d] ? 0u : 1u;
+                        occupied[d] = true;
+                    }
+                }
+                return res;
+            }
+        }
+
+        // Fill ratio (stored values over non-zeros) that a CSR matrix with
+        // cols columns would have once converted to DIA, padding included.
+        template <class P, class C, class ST, class IT>
+        inline double dia_fill_ratio(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, std::size_t cols)
+        {
+            const auto& pos = a.position();
+            std::size_t rows = pos.size() - 1;
+            std::size_t nnz = static_cast<std::size_t>(pos[rows]);
+            return nnz == 0 ? 1. : static_cast<double>(detail::count_diagonals(a, cols) * rows) / static_cast<double>(nnz);
+        }
+
+        template <class D>
+        inline double dia_fill_ratio(const xsparse_container<D>& a)
+        {
+            return dia_fill_ratio(a.scheme(), a.shape()[1]);
+        }
+
+        // Returns true if a CSR matrix with cols columns takes less memory in
+        // DIA form, where values are stored without coordinates but with
+        // padding. SpMV being memory bound with both schemes, the DIA kernel
+        // is then expected to be faster as well.
+        template <class P, class C, class ST, class IT>
+        inline bool prefer_dia(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, std::size_t cols)
+        {
+            using value_type = typename ST::value_type;
+
+            const auto& pos = a.position();
+            std::size_t rows = pos.size() - 1;
+            std::size_t nnz = static_cast<std::size_t>(pos[rows]);
+            std::size_t csr_bytes = nnz * (sizeof(value_type) + sizeof(typename C::value_type)) +
+                                    (rows + 1) * sizeof(typename P::value_type);
+            std::size_t dia_bytes = detail::count_diagonals(a, cols) * (rows * sizeof(value_type) + sizeof(std::ptrdiff_t));
+            return dia_bytes < csr_bytes;
+        }
+
+        template <class D>
+        inline bool prefer_dia(const xsparse_container<D>& a)
+        {
+            return prefer_dia(a.scheme(), a.shape()[1]);
+        }
+
+        /**************
+         * from_dense *
+         **************/
+
+        namespace detail
+        {
+            // Lower bound of the p-th of nb_parts ranges of (almost) equal
+            // sizes covering [0, size).
+            inline std::size_t part_bound(std::size_t size, std::size_t nb_parts, std::size_t p)
+            {
+                return size / nb_parts * p + size % nb_parts * p / nb_parts;
+            }
+
+            // Both functions below run two parallel passes over the dense
+            // data: the first one counts the kept elements of each part, the
+            // second one writes them at the offsets given by the prefix sum
+            // of the counts.
+            template <class T, class Sh, class C, class ST>
+            inline void dense_to_coo(const T* data, const Sh& shape, T tolerance, C& coords, ST& storage)
+            {
+                using index_type = typename C::value_type;
+                using value_type = typename ST::value_type;
+
+                std::size_t dim = shape.size();
+                std::vector<std::size_t> strides(dim);
+                std::size_t size = 1;
+                for (std::size_t d = dim; d != 0; --d)
+                {
+                    strides[d - 1] = size;
+                    size *= static_cast<std::size_t>(shape[d - 1]);
+                }
+
+                std::size_t nb_parts = std::max(std::size_t(1), std::min(default_nb_partitions(), size));
+                std::vector<std::size_t> offsets(nb_parts + 1, 0);
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    std::size_t first = part_bound(size, nb_parts, p);
+                    std::size_t last = part_bound(size, nb_parts, p + 1);
+                    std::size_t count = 0;
+                    for_each_above(data + first, last - first, tolerance, [&count](std::size_t) { ++count; });
+                    offsets[p + 1] = count;
+                });
+                std::partial_sum(offsets.cbegin(), offsets.cend(), offsets.begin());
+
+                coords.resize(offsets.back());
+                storage.resize(offsets.back());
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    std::size_t first = part_bound(size, nb_parts, p);
+                    std::size_t last = part_bound(size, nb_parts, p + 1);
+                    std::size_t dst = offsets[p];
+                    index_type index = xtl::make_sequence<index_type>(dim, 0u);
+                    for_each_above(data + first, last - first, tolerance, [&](std::size_t j)
+                    {
+                        std::size_t offset = first + j;
+                        for (std::size_t d = 0; d < dim; ++d)
+                        {
+                            index[d] = static_cast<typename index_type::value_type>(offset / strides[d]);
+                            offset %= strides[d];
+                        }
+                        coords[dst] = index;
+                        storage[dst] = static_cast<value_type>(data[first + j]);
+                        ++dst;
+                    });
+                });
+            }
+
+            template <class T, class Sh, class P, class C, class ST>
+            inline void dense_to_csr(const T* data, const Sh& shape, T tolerance, P& pos, C& coords, ST& storage)
+            {
+                using size_type = typename P::value_type;
+                using coordinate_type = typename C::value_type;
+                using value_type = typename ST::value_type;
+
+                std::size_t rows = static_cast<std::size_t>(shape[0]);
+                std::size_t cols = static_cast<std::size_t>(shape[1]);
+                std::size_t nb_parts = std::max(std::size_t(1), std::min(default_nb_partitions(), rows));
+
+                pos.resize(rows + 1);
+                pos[0] = 0;
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    for (std::size_t i = part_bound(rows, nb_parts, p); i < part_bound(rows, nb_parts, p + 1); ++i)
+                    {
+                        size_type count = 0;
+                        for_each_above(data + i * cols, cols, tolerance, [&count](std::size_t) { ++count; });
+                        pos[i + 1] = count;
+                    }
+                });
+                std::partial_sum(pos.cbegin(), pos.cend(), pos.begin());
+
+                coords.resize(static_cast<std::size_t>(pos[rows]));
+                storage.resize(static_cast<std::size_t>(pos[rows]));
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    for (std::size_t i = part_bound(rows, nb_parts, p); i < part_bound(rows, nb_parts, p + 1); ++i)
+                    {
+                        const T* row = data + i * cols;
+                        std::size_t dst = static_cast<std::size_t>(pos[i]);
+                        for_each_above(row, cols, tolerance, [&](std::size_t j)
+                        {
+                            coords[dst] = static_cast<coordinate_type>(j);
+                            storage[dst] = static_cast<value_type>(row[j]);
+                            ++dst;
+                        });
+                    }
+                });
+            }
+
+            template <class T, class Sh, class P, class C, class ST, class IT>
+            inline void from_dense_impl(const T* data, const Sh& shape, T tolerance, xcoo_scheme<P, C, ST, IT>& s)
+            {
+                C coords;
+                ST storage;
+                dense_to_coo(data, shape, tolerance, coords, storage);
+                s = xcoo_scheme<P, C, ST, IT>(std::move(coords), std::move(storage));
+            }
+
+            template <class T, class Sh, class P, class C, class ST, class IT>
+            inline void from_dense_impl(const T* data, const Sh& shape, T tolerance,
+                                        xcsr_scheme<P, C, ST, IT, layout_type::row_major>& s)
+            {
+                if (shape.size() != 2)
+                {
+                    XTENSOR_THROW(std::runtime_error, "from_dense: CSR scheme requires a 2-D expression");
+                }
+
+                P pos;
+                C coords;
+                ST storage;
+                dense_to_csr(data, shape, tolerance, pos, coords, storage);
+                s = xcsr_scheme<P, C, ST, IT, layout_type::row_major>(std::move(pos), std::move(coords), std::move(storage));
+            }
+
+            // Other schemes (CSC, CSF, map) are built with their linear
+            // assign_nz method from compacted COO arrays.
+            template <class T, class Sh, class S>
+            inline void from_dense_impl(const T* data, const Sh& shape, T tolerance, S& s)
+            {
+                using index_type = typename S::index_type;
+                using value_type = typename S::value_type;
+                using coo_type = xcoo_scheme<std::array<std::size_t, 2>,
+                                             std::vector<index_type>,
+                                             std::vector<value_type>,
+                                             index_type>;
+
+                std::vector<index_type> coords;
+                std::vector<value_type> storage;
+                dense_to_coo(data, shape, tolerance, coords, storage);
+                coo_type tmp(std::move(coords), std::move(storage));
+                s.assign_nz(tmp.nz_cbegin(), tmp.nz_cend());
+            }
+
+            template <class S, class E>
+            inline auto from_dense_eval(const E& e, typename E::value_type tolerance, std::true_type /* row_major */)
+            {
+                using result_type = xsparse_array<typename S::value_type, S>;
+                using shape_type = typename result_type::shape_type;
+
+                result_type res(shape_type(e.shape().cbegin(), e.shape().cend()));
+                from_dense_impl(e.data(), e.shape(), tolerance, res.scheme());
+                return res;
+            }
+
+            template <class S, class E>
+            inline auto from_dense_eval(const E& e, typename E::value_type tolerance, std::false_type /* row_major */)
+            {
+                if (e.layout() == layout_type::row_major)
+                {
+                    return from_dense_eval<S>(e, tolerance, std::true_type());
+                }
+                xarray<typename E::value_type, layout_type::row_major> tmp = e;
+                return from_dense_eval<S>(tmp, tolerance, std::true_type());
+            }
+        }
+
+        // Returns a sparse array with the scheme S holding the elements of the
+        // dense expression e whose magnitude is greater than tolerance. The
+        // expression is evaluated once; the compacted arrays of COO and CSR
+        // are then filled directly in two parallel passes (count, then fill)
+        // and other schemes are built from the COO arrays in O(nnz).
+        template <class S, class E>
+        inline auto from_dense(const xexpression<E>& e, typename E::value_type tolerance = typename E::value_type(0))
+            -> xsparse_array<typename S::value_type, S>
+        {
+            auto&& de = xt::eval(e.derived_cast());
+            using eval_type = std::decay_t<decltype(de)>;
+            return detail::from_dense_eval<S>(de, tolerance, std::integral_constant<bool, eval_type::static_layout == layout_type::row_major>());
+        }
+
+        template <class E>
+        inline auto from_dense(const xexpression<E>& e, typename E::value_type tolerance = typename E::value_type(0))
+            -> XSPARSE_DEFAULT_ARRAY(typename E::value_type)
+        {
+            return from_dense<XSPARSE_DEFAULT_ARRAY_SCHEME(coo, typename E::value_type)>(e, tolerance);
+        }
+    }
+}
+
+#endif
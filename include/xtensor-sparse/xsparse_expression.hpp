@@ -2,6 +2,7 @@
 #define XSPARSE_EXPRESSION_HPP
 
 #include <xtensor/xexpression.hpp>
+#include <xtensor/xlayout.hpp>
 
 namespace xt
 {
@@ -23,6 +24,67 @@ namespace xt
     {
     };
 
+    /***********************
+     * has_fast_nz_advance *
+     ***********************/
+
+    template <class scheme>
+    class xcoo_scheme_nz_iterator;
+
+    template <class scheme>
+    class xcoo_soa_scheme_nz_iterator;
+
+    template <class scheme>
+    class xlinear_coo_scheme_nz_iterator;
+
+    template <class scheme>
+    class xcsr_scheme_nz_iterator;
+
+    template <class scheme>
+    class xdcsr_scheme_nz_iterator;
+
+    template <class scheme>
+    class xfixed_csf_scheme_nz_iterator;
+
+    // Iterators that can move by n non-zeros, and measure the distance
+    // between two of them, in (almost) constant time; skipping ahead with a
+    // galloping search is only worth it for these. The other nz_iterators
+    // move one non-zero at a time, whatever the size of the jump.
+    template <class It>
+    struct has_fast_nz_advance : std::false_type
+    {
+    };
+
+    template <class scheme>
+    struct has_fast_nz_advance<xcoo_scheme_nz_iterator<scheme>> : std::true_type
+    {
+    };
+
+    template <class scheme>
+    struct has_fast_nz_advance<xcoo_soa_scheme_nz_iterator<scheme>> : std::true_type
+    {
+    };
+
+    template <class scheme>
+    struct has_fast_nz_advance<xlinear_coo_scheme_nz_iterator<scheme>> : std::true_type
+    {
+    };
+
+    template <class scheme>
+    struct has_fast_nz_advance<xcsr_scheme_nz_iterator<scheme>> : std::true_type
+    {
+    };
+
+    template <class scheme>
+    struct has_fast_nz_advance<xdcsr_scheme_nz_iterator<scheme>> : std::true_type
+    {
+    };
+
+    template <class scheme>
+    struct has_fast_nz_advance<xfixed_csf_scheme_nz_iterator<scheme>> : std::true_type
+    {
+    };
+
     namespace extension
     {
         /**********************
@@ -80,6 +142,23 @@ namespace xt
         template <class E>
         using get_assign_tag_t = typename get_assign_tag<E>::type;
 
+        /*****************
+         * get_nz_layout *
+         *****************/
+
+        // Order in which the non-zero elements of an expression are iterated;
+        // expressions that do not define nz_layout are iterated in row-major order.
+        template <class E, class = void_t<int>>
+        struct get_nz_layout : std::integral_constant<layout_type, layout_type::row_major>
+        {
+        };
+
+        template <class E>
+        struct get_nz_layout<E, xt::void_t<decltype(std::decay_t<E>::nz_layout)>>
+            : std::integral_constant<layout_type, std::decay_t<E>::nz_layout>
+        {
+        };
+
         /*********************************
          * xsparse_empty_base definition *
          *********************************/
@@ -2,6 +2,11 @@
 #define XSPARSE_FUNCTION_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <utility>
 
 #include <xtl/xmeta_utils.hpp>
 #include <xtl/xsequence.hpp>
@@ -29,6 +34,34 @@ namespace xt
     template<class T>
     using get_nz_iterator_t = typename get_nz_iterator_type<T>::type;
 
+    template <class It>
+    struct is_xscalar_nz_iterator : std::false_type
+    {
+    };
+
+    template <bool is_const, class CT>
+    struct is_xscalar_nz_iterator<xscalar_nz_iterator<is_const, CT>> : std::true_type
+    {
+    };
+
+    // Products and quotients only have non-zeros where all their operands
+    // have one, so their nz_iterator walks the intersection of the non-zeros
+    // of the operands instead of their union.
+    template <class F>
+    struct is_intersection_functor : std::false_type
+    {
+    };
+
+    template <>
+    struct is_intersection_functor<detail::multiplies> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_intersection_functor<detail::divides> : std::true_type
+    {
+    };
+
     /*********************
      * nz_begin / nz_end *
      *********************/
@@ -84,7 +117,7 @@ namespace xt
         using index_type = promote_shape_t<typename std::decay_t<CT>::shape_type...>;
 
         template <class... It>
-        xfunction_nz_iterator(const xfunction_type* func, bool use_min, const std::tuple<It...>& it, const std::tuple<It...>& sentinel);
+        xfunction_nz_iterator(const xfunction_type* func, const std::tuple<It...>& begins, const std::tuple<It...>& ends, bool end);
 
         self_type& operator++();
         self_type& operator--();
@@ -103,19 +136,84 @@ namespace xt
 
     private:
 
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+        static constexpr std::size_t nb_operands = sizeof...(CT);
+
+        using iterator_tuple = std::tuple<get_nz_iterator_t<std::decay_t<CT>>...>;
+        using offset_array = std::array<std::size_t, nb_operands>;
+        using intersection_type = is_intersection_functor<functor_type>;
+
+        void increment(std::false_type /*intersection*/);
+        void increment(std::true_type /*intersection*/);
+        void decrement(std::false_type /*intersection*/);
+        void decrement(std::true_type /*intersection*/);
+        void align_forward();
+
         template <std::size_t... Is>
         reference apply(std::index_sequence<Is...>) const;
 
-        void update_current_index_with_min();
-        void update_current_index_with_max();
+        template <class It>
+        std::size_t offset(const It& it) const;
+
+        template <class It>
+        std::size_t offset(const It& it, const It& end) const;
+
+        template <bool is_const, class T>
+        std::size_t offset(const xscalar_nz_iterator<is_const, T>& it,
+                           const xscalar_nz_iterator<is_const, T>& end) const;
+
+        template <class It>
+        std::size_t previous_offset(const It& it, const It& begin) const;
+
+        template <bool is_const, class T>
+        std::size_t previous_offset(const xscalar_nz_iterator<is_const, T>& it,
+                                    const xscalar_nz_iterator<is_const, T>& begin) const;
+
+        template <class It>
+        std::size_t step_forward(It& it, const It& end) const;
+
+        template <bool is_const, class T>
+        std::size_t step_forward(xscalar_nz_iterator<is_const, T>& it,
+                                 const xscalar_nz_iterator<is_const, T>& end) const;
+
+        template <class It>
+        std::size_t seek_forward(It& it, const It& end, std::size_t target) const;
+
+        template <bool is_const, class T>
+        std::size_t seek_forward(xscalar_nz_iterator<is_const, T>& it,
+                                 const xscalar_nz_iterator<is_const, T>& end,
+                                 std::size_t target) const;
+
+        template <class It>
+        void seek_forward(It& it, const It& end, std::size_t target, std::false_type /*fast_advance*/) const;
+
+        template <class It>
+        void seek_forward(It& it, const It& end, std::size_t target, std::true_type /*fast_advance*/) const;
+
+        template <class It>
+        std::size_t seek_backward(It& it, const It& begin, std::size_t target) const;
+
+        template <bool is_const, class T>
+        std::size_t seek_backward(xscalar_nz_iterator<is_const, T>& it,
+                                  const xscalar_nz_iterator<is_const, T>& begin,
+                                  std::size_t target) const;
+
+        void update_current_offset();
 
         const xfunction_type* p_f;
-        index_type m_current_index;
-        std::array<bool, sizeof...(CT)> m_is_valid;
-        std::tuple<get_nz_iterator_t<std::decay_t<CT>>...> m_nz_iterators;
-        std::tuple<get_nz_iterator_t<std::decay_t<CT>>...> m_nz_sentinels;
-        // Contains a pointer to the iterator in m_nz_iterators or nullptr
-        std::tuple<get_nz_iterator_t<std::decay_t<CT>>*...> m_nz_current_iterators;
+        // Row-major strides of the function shape, used to linearize the
+        // indices of the operands so that merging them only compares integers.
+        index_type m_strides;
+        iterator_tuple m_nz_iterators;
+        iterator_tuple m_nz_begins;
+        iterator_tuple m_nz_ends;
+        // Linearized offset of each operand, npos if the operand is exhausted
+        // or is a scalar.
+        offset_array m_offsets;
+        std::size_t m_current_offset;
+        // The index is only unraveled when requested.
+        mutable index_type m_current_index;
+        mutable bool m_index_dirty;
     };
 
     template <class F, class... CT>
@@ -188,8 +286,16 @@ namespace xt
             {
             };
 
+            // The nz_iterator of xfunction merges its operands in row-major
+            // order; operands iterating their non-zeros in another order
+            // (e.g. CSC) are evaluated through the dense assignment.
+            template <class... CT>
+            using is_row_major_nz = xtl::conjunction<std::integral_constant<bool, get_nz_layout<CT>::value == layout_type::row_major>...>;
+
             template <class F, class... CT>
-            using get_function_assign_tag_t = typename get_function_assign_tag<F, CT...>::type;
+            using get_function_assign_tag_t = std::conditional_t<is_row_major_nz<CT...>::value,
+                                                                 typename get_function_assign_tag<F, CT...>::type,
+                                                                 xdense_assign_tag>;
         }
 
         /*************************
@@ -211,8 +317,8 @@ namespace xt
 
         private:
 
-            template<class Func, class Func_s, std::size_t... I>
-            const_nz_iterator build_nz_iterator(Func&& f_it, Func_s&& f_sentinel, bool end, std::index_sequence<I...>) const noexcept;
+            template <std::size_t... I>
+            const_nz_iterator build_nz_iterator(bool end, std::index_sequence<I...>) const noexcept;
 
         };
 
@@ -227,31 +333,18 @@ namespace xt
         };
     }
 
-    template <class Index, class It>
-    bool check_nz_iterator(const Index& current_index, const It& it)
-    {
-        return (it.index() == current_index);
-    }
-
-    template<class Index, bool is_const, class T>
-    bool check_nz_iterator(const Index& /*current_index*/, const xscalar_nz_iterator<is_const, T>& /*it*/)
-    {
-        return true;
-    }
-
-    template <class Index, class It>
-    auto get_nz_iterator_value(const Index& /*current_index*/, const It& it, It* p_it) -> typename It::reference
+    template <class It>
+    auto get_nz_iterator_value(const It& it, bool is_current) -> typename It::reference
     {
-        return (p_it == nullptr) ? It::ZERO : *it;
+        return is_current ? *it : It::ZERO;
     }
 
-    template<class Index, bool is_const, class T>
-    auto get_nz_iterator_value(const Index& /*current_index*/, const xscalar_nz_iterator<is_const, T>& it, xscalar_nz_iterator<is_const, T>* /*p_it*/) -> typename xscalar_nz_iterator<is_const, T>::reference
+    template<bool is_const, class T>
+    auto get_nz_iterator_value(const xscalar_nz_iterator<is_const, T>& it, bool /*is_current*/) -> typename xscalar_nz_iterator<is_const, T>::reference
     {
         return *it;
     }
 
-
     /***************************************
     * xfunction_nz_iterator implementation *
     ****************************************/
@@ -260,74 +353,53 @@ namespace xt
     const typename xfunction_nz_iterator<F, CT...>::value_type
     xfunction_nz_iterator<F, CT...>::ZERO = 0;
 
+    template <class F, class... CT>
+    constexpr std::size_t xfunction_nz_iterator<F, CT...>::npos;
+
+
     template <class F, class... CT>
     template <class... It>
-    inline xfunction_nz_iterator<F, CT...>::xfunction_nz_iterator(const xfunction_type* func, bool end, const std::tuple<It...>& it, const std::tuple<It...>& sentinel)
+    inline xfunction_nz_iterator<F, CT...>::xfunction_nz_iterator(const xfunction_type* func, const std::tuple<It...>& begins, const std::tuple<It...>& ends, bool end)
         : p_f(func),
-          m_nz_iterators(it),
-          m_nz_sentinels(sentinel)
+          m_strides(xtl::make_sequence<index_type>(func->dimension(), std::size_t(1))),
+          m_nz_iterators(end ? ends : begins),
+          m_nz_begins(begins),
+          m_nz_ends(ends),
+          m_current_offset(npos),
+          m_current_index(xtl::make_sequence<index_type>(func->dimension(), std::size_t(0))),
+          m_index_dirty(true)
     {
-        m_is_valid.fill(true);
-        if (end)
+        const auto& shape = p_f->shape();
+        for (std::size_t k = m_strides.size(); k > 1; --k)
         {
-            auto ft1 = [](const auto /*i*/, auto& it){return &it;};
-            transform(ft1, m_nz_iterators, m_nz_current_iterators);
-            m_current_index = p_f->shape();
+            m_strides[k - 2] = m_strides[k - 1] * static_cast<std::size_t>(shape[k - 1]);
+        }
+
+        static_for<nb_operands>([this](auto i)
+        {
+            m_offsets[i] = offset(std::get<i>(m_nz_iterators), std::get<i>(m_nz_ends));
+        });
+        if (intersection_type::value && !end)
+        {
+            align_forward();
         }
         else
         {
-            update_current_index_with_min();
-
-            auto ft = [this](const auto /*i*/, auto& it){return (check_nz_iterator(m_current_index, it))? &it: nullptr;};
-            transform(ft, m_nz_iterators, m_nz_current_iterators);
+            update_current_offset();
         }
     }
 
     template <class F, class... CT>
     inline auto xfunction_nz_iterator<F, CT...>::operator++() -> self_type&
     {
-        auto f = [this](const auto i, auto& it, auto& sentinel, auto& p_it){
-            if (check_nz_iterator(m_current_index, it))
-            {
-                ++it;
-            }
-            if (it == sentinel)
-            {
-                m_is_valid[i] = false;
-            }
-            p_it = nullptr;
-        };
-        update_it(f, m_nz_iterators, m_nz_sentinels, m_nz_current_iterators);
-        // auto ft1 = [this](const auto, auto& it){if (check_nz_iterator(m_current_index, it)) ++it; return nullptr;};
-        // transform(ft1, m_nz_iterators, m_nz_current_iterators);
-
-        update_current_index_with_min();
-
-        auto ft2 = [this](const auto i, auto& it){return (m_is_valid[i] && check_nz_iterator(m_current_index, it))? &it: nullptr;};
-        transform(ft2, m_nz_iterators, m_nz_current_iterators);
+        increment(intersection_type());
         return *this;
     }
 
     template <class F, class... CT>
     inline auto xfunction_nz_iterator<F, CT...>::operator--() -> self_type&
     {
-        auto f = [this](const auto i, auto& it, auto& sentinel, auto& p_it){
-            if (it == sentinel)
-            {
-                m_is_valid[i] = false;
-            }
-            else if (p_it != nullptr)
-            {
-                --it;
-            }
-            p_it = nullptr;
-        };
-        update_it(f, m_nz_iterators, m_nz_sentinels, m_nz_current_iterators);
-
-        update_current_index_with_max();
-
-        auto ft2 = [this](const auto i, auto& it){return (m_is_valid[i] && check_nz_iterator(m_current_index, it))? &it: nullptr;};
-        transform(ft2, m_nz_iterators, m_nz_current_iterators);
+        decrement(intersection_type());
         return *this;
     }
 
@@ -354,7 +426,7 @@ namespace xt
     template <class F, class... CT>
     inline auto xfunction_nz_iterator<F, CT...>::operator*() const -> reference
     {
-        return apply(std::make_index_sequence<sizeof...(CT)>{});
+        return apply(std::make_index_sequence<nb_operands>{});
     }
 
     template <class F, class... CT>
@@ -366,18 +438,36 @@ namespace xt
     template <class F, class... CT>
     inline bool xfunction_nz_iterator<F, CT...>::equal(const self_type& rhs) const
     {
-        return m_nz_iterators == rhs.m_nz_iterators;
+        return p_f == rhs.p_f && m_current_offset == rhs.m_current_offset;
     }
 
     template <class F, class... CT>
     inline bool xfunction_nz_iterator<F, CT...>::less_than(const self_type& rhs) const
     {
-        return m_nz_iterators < rhs.m_nz_iterators;
+        return m_current_offset < rhs.m_current_offset;
     }
 
     template <class F, class... CT>
     inline auto xfunction_nz_iterator<F, CT...>::index() const -> const index_type&
     {
+        if (m_index_dirty)
+        {
+            if (m_current_offset == npos)
+            {
+                const auto& shape = p_f->shape();
+                std::copy(shape.cbegin(), shape.cend(), m_current_index.begin());
+            }
+            else
+            {
+                std::size_t offset = m_current_offset;
+                for (std::size_t k = 0; k < m_strides.size(); ++k)
+                {
+                    m_current_index[k] = offset / m_strides[k];
+                    offset -= m_current_index[k] * m_strides[k];
+                }
+            }
+            m_index_dirty = false;
+        }
         return m_current_index;
     }
 
@@ -385,47 +475,302 @@ namespace xt
     template <std::size_t... Is>
     inline auto xfunction_nz_iterator<F, CT...>::apply(std::index_sequence<Is...>) const -> reference
     {
-        return (p_f->functor())(get_nz_iterator_value(m_current_index, std::get<Is>(m_nz_iterators), std::get<Is>(m_nz_current_iterators))...);
+        return (p_f->functor())(get_nz_iterator_value(std::get<Is>(m_nz_iterators), m_offsets[Is] == m_current_offset)...);
+    }
+
+    template <class F, class... CT>
+    template <class It>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::offset(const It& it) const
+    {
+        // Operands with fewer dimensions are aligned on the trailing ones
+        const auto& idx = it.index();
+        std::size_t shift = m_strides.size() - idx.size();
+        std::size_t res = 0;
+        for (std::size_t k = 0; k < idx.size(); ++k)
+        {
+            res += static_cast<std::size_t>(idx[k]) * m_strides[k + shift];
+        }
+        return res;
+    }
+
+    template <class F, class... CT>
+    template <class It>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::offset(const It& it, const It& end) const
+    {
+        return it == end ? npos : offset(it);
+    }
+
+    template <class F, class... CT>
+    template <bool is_const, class T>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::offset(const xscalar_nz_iterator<is_const, T>& /*it*/,
+                                                               const xscalar_nz_iterator<is_const, T>& /*end*/) const
+    {
+        return npos;
     }
 
     template <class F, class... CT>
-    inline void xfunction_nz_iterator<F, CT...>::update_current_index_with_min()
+    template <class It>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::previous_offset(const It& it, const It& begin) const
     {
-        auto min = [](const auto& init, const auto& iter, const auto& is_valid)
+        if (it == begin)
         {
-            using init_type = std::decay_t<decltype(init)>;
-            using iter_type = decltype(iter.index());
+            return npos;
+        }
+        It previous = it;
+        --previous;
+        return offset(previous);
+    }
+
+    template <class F, class... CT>
+    template <bool is_const, class T>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::previous_offset(const xscalar_nz_iterator<is_const, T>& /*it*/,
+                                                                        const xscalar_nz_iterator<is_const, T>& /*begin*/) const
+    {
+        return npos;
+    }
 
-            if (is_valid && !iter.index().empty())
+    template <class F, class... CT>
+    template <class It>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::step_forward(It& it, const It& end) const
+    {
+        ++it;
+        return offset(it, end);
+    }
+
+    template <class F, class... CT>
+    template <bool is_const, class T>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::step_forward(xscalar_nz_iterator<is_const, T>& /*it*/,
+                                                                     const xscalar_nz_iterator<is_const, T>& /*end*/) const
+    {
+        return npos;
+    }
+
+    template <class F, class... CT>
+    template <class It>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::seek_forward(It& it, const It& end, std::size_t target) const
+    {
+        seek_forward(it, end, target, has_fast_nz_advance<It>());
+        return offset(it, end);
+    }
+
+    template <class F, class... CT>
+    template <bool is_const, class T>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::seek_forward(xscalar_nz_iterator<is_const, T>& /*it*/,
+                                                                     const xscalar_nz_iterator<is_const, T>& /*end*/,
+                                                                     std::size_t /*target*/) const
+    {
+        return npos;
+    }
+
+    template <class F, class... CT>
+    template <class It>
+    inline void xfunction_nz_iterator<F, CT...>::seek_forward(It& it, const It& end, std::size_t target, std::false_type) const
+    {
+        do
+        {
+            ++it;
+        }
+        while (it != end && offset(it) < target);
+    }
+
+    template <class F, class... CT>
+    template <class It>
+    inline void xfunction_nz_iterator<F, CT...>::seek_forward(It& it, const It& end, std::size_t target, std::true_type) const
+    {
+        // Galloping search: doubles the step until an element at or past
+        // target is found, then bisects the last step. Elements in
+        // (it + lo, it + hi] are the candidates; it + lo is before target.
+        using diff_type = typename It::difference_type;
+        auto offset_at = [this, &it](diff_type n)
+        {
+            It probe = it;
+            probe += n;
+            return offset(probe);
+        };
+
+        diff_type remaining = end - it;
+        diff_type lo = 0;
+        diff_type hi = 1;
+        while (hi < remaining && offset_at(hi) < target)
+        {
+            lo = hi;
+            hi *= 2;
+        }
+        hi = std::min(hi, remaining);
+        while (hi - lo > 1)
+        {
+            diff_type mid = lo + (hi - lo) / 2;
+            if (offset_at(mid) < target)
             {
-                return std::lexicographical_compare(init.cbegin(), init.cend(), iter.index().cbegin(), iter.index().cend()) ?
-                    init :
-                    xtl::forward_sequence<init_type, iter_type>(iter.index());
+                lo = mid;
             }
-            return init;
-        };
-        auto init = xtl::make_sequence<index_type>(p_f->dimension(), std::size_t(-1));
-        m_current_index = xt::accumulate(min, init, m_nz_iterators, m_is_valid);
+            else
+            {
+                hi = mid;
+            }
+        }
+        it += hi;
+    }
+
+    template <class F, class... CT>
+    template <class It>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::seek_backward(It& it, const It& begin, std::size_t target) const
+    {
+        std::size_t res = npos;
+        do
+        {
+            --it;
+            res = offset(it);
+        }
+        while (res > target && it != begin);
+        return res;
+    }
+
+    template <class F, class... CT>
+    template <bool is_const, class T>
+    inline std::size_t xfunction_nz_iterator<F, CT...>::seek_backward(xscalar_nz_iterator<is_const, T>& /*it*/,
+                                                                      const xscalar_nz_iterator<is_const, T>& /*begin*/,
+                                                                      std::size_t /*target*/) const
+    {
+        return npos;
     }
 
     template <class F, class... CT>
-    inline void xfunction_nz_iterator<F, CT...>::update_current_index_with_max()
+    inline void xfunction_nz_iterator<F, CT...>::increment(std::false_type)
     {
-        auto max = [](const auto& init, const auto& iter, const auto& is_valid)
+        // Only the operands sitting at the current position move forward
+        static_for<nb_operands>([this](auto i)
         {
-            using init_type = std::decay_t<decltype(init)>;
-            using iter_type = decltype(iter.index());
+            if (m_offsets[i] == m_current_offset && m_offsets[i] != npos)
+            {
+                auto& it = std::get<i>(m_nz_iterators);
+                ++it;
+                m_offsets[i] = offset(it, std::get<i>(m_nz_ends));
+            }
+        });
+        update_current_offset();
+    }
+
+    template <class F, class... CT>
+    inline void xfunction_nz_iterator<F, CT...>::increment(std::true_type)
+    {
+        static_for<nb_operands>([this](auto i)
+        {
+            m_offsets[i] = step_forward(std::get<i>(m_nz_iterators), std::get<i>(m_nz_ends));
+        });
+        align_forward();
+    }
+
+    template <class F, class... CT>
+    inline void xfunction_nz_iterator<F, CT...>::decrement(std::false_type)
+    {
+        // The previous position is the greatest offset among the elements
+        // preceding the operand iterators; only the operands having their
+        // previous element at that position move backward.
+        offset_array previous;
+        static_for<nb_operands>([this, &previous](auto i)
+        {
+            previous[i] = previous_offset(std::get<i>(m_nz_iterators), std::get<i>(m_nz_begins));
+        });
 
-            if (is_valid && !iter.index().empty())
+        m_current_offset = 0;
+        for (std::size_t i = 0; i < nb_operands; ++i)
+        {
+            if (previous[i] != npos)
             {
-                return std::lexicographical_compare(init.cbegin(), init.cend(), iter.index().cbegin(), iter.index().cend()) ?
-                    xtl::forward_sequence<init_type, iter_type>(iter.index()) :
-                    init;
+                m_current_offset = std::max(m_current_offset, previous[i]);
             }
-            return init;
-        };
-        auto init = xtl::make_sequence<index_type>(p_f->dimension(), std::numeric_limits<std::size_t>::min());
-        m_current_index = xt::accumulate(max, init, m_nz_iterators, m_is_valid);
+        }
+
+        static_for<nb_operands>([this, &previous](auto i)
+        {
+            if (previous[i] == m_current_offset)
+            {
+                --std::get<i>(m_nz_iterators);
+                m_offsets[i] = m_current_offset;
+            }
+        });
+        m_index_dirty = true;
+    }
+
+    template <class F, class... CT>
+    inline void xfunction_nz_iterator<F, CT...>::decrement(std::true_type)
+    {
+        // Mirror of align_forward: every operand steps back, then moves
+        // backward until all of them agree on the same position. The
+        // operands are past the previous common position, whether this
+        // iterator is at a common position or at the end.
+        std::size_t target = npos;
+        static_for<nb_operands>([this, &target](auto i)
+        {
+            m_offsets[i] = seek_backward(std::get<i>(m_nz_iterators), std::get<i>(m_nz_begins), npos);
+            target = std::min(target, m_offsets[i]);
+        });
+
+        bool aligned = false;
+        while (!aligned)
+        {
+            aligned = true;
+            static_for<nb_operands>([this, &target, &aligned](auto i)
+            {
+                // Scalars have a npos offset and never move
+                if (m_offsets[i] > target && m_offsets[i] != npos)
+                {
+                    m_offsets[i] = seek_backward(std::get<i>(m_nz_iterators), std::get<i>(m_nz_begins), target);
+                    if (m_offsets[i] < target)
+                    {
+                        target = m_offsets[i];
+                        aligned = false;
+                    }
+                }
+            });
+        }
+        m_current_offset = target;
+        m_index_dirty = true;
+    }
+
+    template <class F, class... CT>
+    inline void xfunction_nz_iterator<F, CT...>::align_forward()
+    {
+        // Leapfrog join: the operands behind the greatest offset reached so
+        // far seek it, until they all agree or one of them is exhausted.
+        std::size_t target = 0;
+        static_for<nb_operands>([this, &target](auto i)
+        {
+            using iterator_type = std::tuple_element_t<decltype(i)::value, iterator_tuple>;
+            if (!is_xscalar_nz_iterator<iterator_type>::value)
+            {
+                target = std::max(target, m_offsets[i]);
+            }
+        });
+
+        bool aligned = false;
+        while (!aligned && target != npos)
+        {
+            aligned = true;
+            static_for<nb_operands>([this, &target, &aligned](auto i)
+            {
+                // Scalars have a npos offset and never move
+                if (m_offsets[i] < target)
+                {
+                    m_offsets[i] = seek_forward(std::get<i>(m_nz_iterators), std::get<i>(m_nz_ends), target);
+                    if (m_offsets[i] > target)
+                    {
+                        target = m_offsets[i];
+                        aligned = false;
+                    }
+                }
+            });
+        }
+        m_current_offset = target;
+        m_index_dirty = true;
+    }
+
+    template <class F, class... CT>
+    inline void xfunction_nz_iterator<F, CT...>::update_current_offset()
+    {
+        m_current_offset = *std::min_element(m_offsets.cbegin(), m_offsets.cend());
+        m_index_dirty = true;
     }
 
     template <class F, class... CT>
@@ -457,11 +802,7 @@ namespace xt
         template<class F, class... CT>
         inline auto xfunction_sparse_base<F, CT...>::nz_cbegin() const -> const_nz_iterator
         {
-            // auto f_it = [](auto& e){return get_nz_begin(e);};
-            // auto f_sentinel = [](auto& e){return get_nz_end(e);};
-            auto f_it = [](auto& e){return get_nz_begin(e);};
-            auto f_sentinel = [](auto& e){return get_nz_end(e);};
-            return build_nz_iterator(f_it, f_sentinel, false, std::make_index_sequence<sizeof...(CT)>());
+            return build_nz_iterator(false, std::make_index_sequence<sizeof...(CT)>());
         }
 
         template<class F, class... CT>
@@ -473,19 +814,18 @@ namespace xt
         template<class F, class... CT>
         inline auto xfunction_sparse_base<F, CT...>::nz_cend() const -> const_nz_iterator
         {
-            auto f_it = [](auto& e){return get_nz_end(e);};
-            auto f_sentinel = [](auto& e){return get_nz_begin(e);};
-            return build_nz_iterator(f_it, f_sentinel, true, std::make_index_sequence<sizeof...(CT)>());
+            return build_nz_iterator(true, std::make_index_sequence<sizeof...(CT)>());
         }
 
         template<class F, class... CT>
-        template<class Func, class Func_s, std::size_t... I>
-        inline auto xfunction_sparse_base<F, CT...>::build_nz_iterator(Func&& f_it, Func_s&& f_sentinel, bool end, std::index_sequence<I...>) const noexcept -> const_nz_iterator
+        template <std::size_t... I>
+        inline auto xfunction_sparse_base<F, CT...>::build_nz_iterator(bool end, std::index_sequence<I...>) const noexcept -> const_nz_iterator
         {
             auto& args = this->derived_cast().arguments();
-            return const_nz_iterator(&(this->derived_cast()), end,
-                                     std::make_tuple(f_it(std::get<I>(args))...),
-                                     std::make_tuple(f_sentinel(std::get<I>(args))...));
+            return const_nz_iterator(&(this->derived_cast()),
+                                     std::make_tuple(get_nz_begin(std::get<I>(args))...),
+                                     std::make_tuple(get_nz_end(std::get<I>(args))...),
+                                     end);
         }
 
         template <class F, class... CT>
@@ -0,0 +1,852 @@
+#ifndef XSPARSE_LINALG_HPP
+#define XSPARSE_LINALG_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/tbb.h>
+#endif
+
+#if defined(XTENSOR_USE_OPENMP)
+#include <omp.h>
+#endif
+
+#include <xtensor/xeval.hpp>
+#include <xtensor/xexception.hpp>
+#include <xtensor/xlayout.hpp>
+#include <xtensor/xtensor.hpp>
+
+#include "xbcsr_scheme.hpp"
+#include "xcoo_soa_scheme.hpp"
+#include "xcsr_scheme.hpp"
+#include "xdcsr_scheme.hpp"
+#include "xdia_scheme.hpp"
+#include "xlinear_coo_scheme.hpp"
+#include "xsparse_array.hpp"
+#include "xsell_scheme.hpp"
+#include "xsparse_container.hpp"
+#include "xsparse_simd.hpp"
+
+namespace xt
+{
+    namespace sparse
+    {
+        /********
+         * spmv *
+         ********/
+
+        namespace detail
+        {
+            // Generic fallback for schemes without a compressed layout:
+            // scatters every non-zero into y.
+            template <class S, class XIt, class YIt>
+            inline void spmv_impl(const S& a, XIt x, YIt y)
+            {
+                for (auto it = a.nz_cbegin(); it != a.nz_cend(); ++it)
+                {
+                    const auto& index = it.index();
+                    y[index[0]] += *it * x[index[1]];
+                }
+            }
+
+            template <class S, class XIt, class YIt>
+            inline void spmv_rows(const S& a, XIt x, YIt y, std::size_t first_row, std::size_t last_row, std::false_type /* simd */)
+            {
+                const auto& pos = a.position();
+                const auto& coords = a.coordinate();
+                const auto& values = a.storage();
+                for (std::size_t i = first_row; i < last_row; ++i)
+                {
+                    auto sum = y[i];
+                    for (std::size_t j = pos[i]; j < pos[i + 1]; ++j)
+                    {
+                        sum += values[j] * x[coords[j]];
+                    }
+                    y[i] = sum;
+                }
+            }
+
+            template <class S, class XIt, class YIt>
+            inline void spmv_rows(const S& a, XIt x, YIt y, std::size_t first_row, std::size_t last_row, std::true_type /* simd */)
+            {
+                const auto& pos = a.position();
+                const auto* coords = a.coordinate().data();
+                const auto* values = a.storage().data();
+                for (std::size_t i = first_row; i < last_row; ++i)
+                {
+                    y[i] += gather_dot(values + pos[i], coords + pos[i], x, pos[i + 1] - pos[i]);
+                }
+            }
+
+            // The SIMD row kernel requires contiguous coordinates and values,
+            // and a dense operand of the same value type as the matrix.
+            template <class S, class XIt>
+            using use_simd_spmv = std::integral_constant<bool,
+                is_simd_vectorizable<typename S::value_type>::value &&
+                has_contiguous_storage<typename S::storage_type>::value &&
+                has_contiguous_storage<typename S::coordinate_type>::value &&
+                std::is_same<typename std::iterator_traits<XIt>::value_type, typename S::value_type>::value>;
+
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_rows(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, XIt x, YIt y,
+                                  std::size_t first_row, std::size_t last_row)
+            {
+                using scheme_type = xcsr_scheme<P, C, ST, IT, layout_type::row_major>;
+                spmv_rows(a, x, y, first_row, last_row, use_simd_spmv<scheme_type, XIt>());
+            }
+
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, XIt x, YIt y)
+            {
+                spmv_rows(a, x, y, 0u, a.position().size() - 1);
+            }
+
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xcsr_scheme<P, C, ST, IT, layout_type::column_major>& a, XIt x, YIt y)
+            {
+                const auto& pos = a.position();
+                const auto& coords = a.coordinate();
+                const auto& values = a.storage();
+                std::size_t cols = pos.size() - 1;
+                for (std::size_t i = 0; i < cols; ++i)
+                {
+                    auto xi = x[i];
+                    for (std::size_t j = pos[i]; j < pos[i + 1]; ++j)
+                    {
+                        y[coords[j]] += values[j] * xi;
+                    }
+                }
+            }
+
+            // BCSR kernel on the block rows [first_block_row, last_block_row):
+            // the loops over a block have compile-time bounds, so that they
+            // are unrolled and vectorized by the compiler, and the R partial
+            // sums of a block row stay in registers. Blocks crossing the last
+            // column take a bounds-checked loop; rows past the last one are
+            // zero padding and are not written back.
+            template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_block_rows(const xbcsr_scheme<R, CB, P, C, ST, IT>& a, XIt x, YIt y,
+                                        std::size_t first_block_row, std::size_t last_block_row)
+            {
+                using value_type = typename ST::value_type;
+
+                const auto& pos = a.position();
+                const auto& coords = a.coordinate();
+                const value_type* values = a.storage().data();
+                std::size_t rows = a.shape()[0];
+                std::size_t cols = a.shape()[1];
+                for (std::size_t i = first_block_row; i < last_block_row; ++i)
+                {
+                    std::array<value_type, R> sums;
+                    sums.fill(value_type(0));
+                    for (std::size_t b = pos[i]; b < pos[i + 1]; ++b)
+                    {
+                        const value_type* block = values + b * R * CB;
+                        std::size_t col = static_cast<std::size_t>(coords[b]) * CB;
+                        if (col + CB <= cols)
+                        {
+                            for (std::size_t r = 0; r < R; ++r)
+                            {
+                                for (std::size_t c = 0; c < CB; ++c)
+                                {
+                                    sums[r] += block[r * CB + c] * x[col + c];
+                                }
+                            }
+                        }
+                        else
+                        {
+                            for (std::size_t r = 0; r < R; ++r)
+                            {
+                                for (std::size_t c = 0; col + c < cols; ++c)
+                                {
+                                    sums[r] += block[r * CB + c] * x[col + c];
+                                }
+                            }
+                        }
+                    }
+                    for (std::size_t r = 0; r < R && i * R + r < rows; ++r)
+                    {
+                        y[i * R + r] += sums[r];
+                    }
+                }
+            }
+
+            template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xbcsr_scheme<R, CB, P, C, ST, IT>& a, XIt x, YIt y)
+            {
+                spmv_block_rows(a, x, y, 0u, a.position().size() - 1);
+            }
+
+            // SELL kernels on the chunks [first_chunk, last_chunk): the CS
+            // rows of a chunk are processed together, the padding holding
+            // zeros; the sums are then scattered to the rows of the matrix.
+            template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_chunks(const xsell_scheme<CS, SW, P, C, ST, IT>& a, XIt x, YIt y,
+                                    std::size_t first_chunk, std::size_t last_chunk, std::false_type /* simd */)
+            {
+                using value_type = typename ST::value_type;
+
+                const auto& pos = a.position();
+                const auto& coords = a.coordinate();
+                const auto& values = a.storage();
+                const auto& perm = a.permutation();
+                std::size_t rows = a.shape()[0];
+                for (std::size_t c = first_chunk; c < last_chunk; ++c)
+                {
+                    std::array<value_type, CS> sums;
+                    sums.fill(value_type(0));
+                    for (std::size_t j = pos[c]; j < pos[c + 1]; j += CS)
+                    {
+                        for (std::size_t l = 0; l < CS; ++l)
+                        {
+                            sums[l] += values[j + l] * x[coords[j + l]];
+                        }
+                    }
+                    for (std::size_t l = 0; l < CS && c * CS + l < rows; ++l)
+                    {
+                        y[perm[c * CS + l]] += sums[l];
+                    }
+                }
+            }
+
+            template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_chunks(const xsell_scheme<CS, SW, P, C, ST, IT>& a, XIt x, YIt y,
+                                    std::size_t first_chunk, std::size_t last_chunk, std::true_type /* simd */)
+            {
+                using value_type = typename ST::value_type;
+
+                const auto& pos = a.position();
+                const auto* coords = a.coordinate().data();
+                const auto* values = a.storage().data();
+                const auto& perm = a.permutation();
+                std::size_t rows = a.shape()[0];
+                std::array<value_type, CS> sums;
+                for (std::size_t c = first_chunk; c < last_chunk; ++c)
+                {
+                    chunk_dot<CS>(values + pos[c], coords + pos[c], x, (pos[c + 1] - pos[c]) / CS, sums.data());
+                    for (std::size_t l = 0; l < CS && c * CS + l < rows; ++l)
+                    {
+                        y[perm[c * CS + l]] += sums[l];
+                    }
+                }
+            }
+
+            template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_chunks(const xsell_scheme<CS, SW, P, C, ST, IT>& a, XIt x, YIt y,
+                                    std::size_t first_chunk, std::size_t last_chunk)
+            {
+                using scheme_type = xsell_scheme<CS, SW, P, C, ST, IT>;
+                spmv_chunks(a, x, y, first_chunk, last_chunk, use_simd_spmv<scheme_type, XIt>());
+            }
+
+            template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xsell_scheme<CS, SW, P, C, ST, IT>& a, XIt x, YIt y)
+            {
+                spmv_chunks(a, x, y, 0u, a.position().size() - 1);
+            }
+
+            // DIA kernel on the rows [first_row, last_row): each diagonal is
+            // streamed with unit stride through storage(), x and y, without
+            // loading any index, so that the loop is vectorized by the
+            // compiler.
+            template <class O, class ST, class IT, class XIt, class YIt>
+            inline void spmv_diagonals(const xdia_scheme<O, ST, IT>& a, XIt x, YIt y,
+                                       std::size_t first_row, std::size_t last_row)
+            {
+                const auto& offsets = a.offset();
+                const auto& values = a.storage();
+                std::size_t rows = a.shape()[0];
+                std::ptrdiff_t cols = static_cast<std::ptrdiff_t>(a.shape()[1]);
+                for (std::size_t d = 0; d < offsets.size(); ++d)
+                {
+                    // Rows i such that 0 <= i + k < cols
+                    std::ptrdiff_t k = static_cast<std::ptrdiff_t>(offsets[d]);
+                    std::ptrdiff_t first = std::max(static_cast<std::ptrdiff_t>(first_row), -k);
+                    std::ptrdiff_t last = std::min(static_cast<std::ptrdiff_t>(last_row), cols - k);
+                    std::ptrdiff_t base = static_cast<std::ptrdiff_t>(d * rows);
+                    for (std::ptrdiff_t i = first; i < last; ++i)
+                    {
+                        y[i] += values[static_cast<std::size_t>(base + i)] * x[i + k];
+                    }
+                }
+            }
+
+            template <class O, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xdia_scheme<O, ST, IT>& a, XIt x, YIt y)
+            {
+                spmv_diagonals(a, x, y, 0u, a.shape()[0]);
+            }
+
+            // DCSR kernels iterate the non-empty rows only, so that their
+            // cost does not depend on the number of rows.
+            template <class S, class XIt, class YIt>
+            inline void spmv_fibers(const S& a, XIt x, YIt y, std::size_t first_fiber, std::size_t last_fiber, std::false_type /* simd */)
+            {
+                const auto& rows = a.outer_coordinate();
+                const auto& pos = a.position();
+                const auto& coords = a.coordinate();
+                const auto& values = a.storage();
+                for (std::size_t f = first_fiber; f < last_fiber; ++f)
+                {
+                    auto sum = y[rows[f]];
+                    for (std::size_t j = pos[f]; j < pos[f + 1]; ++j)
+                    {
+                        sum += values[j] * x[coords[j]];
+                    }
+                    y[rows[f]] = sum;
+                }
+            }
+
+            template <class S, class XIt, class YIt>
+            inline void spmv_fibers(const S& a, XIt x, YIt y, std::size_t first_fiber, std::size_t last_fiber, std::true_type /* simd */)
+            {
+                const auto& rows = a.outer_coordinate();
+                const auto& pos = a.position();
+                const auto* coords = a.coordinate().data();
+                const auto* values = a.storage().data();
+                for (std::size_t f = first_fiber; f < last_fiber; ++f)
+                {
+                    y[rows[f]] += gather_dot(values + pos[f], coords + pos[f], x, pos[f + 1] - pos[f]);
+                }
+            }
+
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_fibers(const xdcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, XIt x, YIt y,
+                                    std::size_t first_fiber, std::size_t last_fiber)
+            {
+                using scheme_type = xdcsr_scheme<P, C, ST, IT, layout_type::row_major>;
+                spmv_fibers(a, x, y, first_fiber, last_fiber, use_simd_spmv<scheme_type, XIt>());
+            }
+
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xdcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, XIt x, YIt y)
+            {
+                spmv_fibers(a, x, y, 0u, a.outer_coordinate().size());
+            }
+
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xdcsr_scheme<P, C, ST, IT, layout_type::column_major>& a, XIt x, YIt y)
+            {
+                const auto& cols = a.outer_coordinate();
+                const auto& pos = a.position();
+                const auto& coords = a.coordinate();
+                const auto& values = a.storage();
+                for (std::size_t f = 0; f < cols.size(); ++f)
+                {
+                    auto xi = x[cols[f]];
+                    for (std::size_t j = pos[f]; j < pos[f + 1]; ++j)
+                    {
+                        y[coords[j]] += values[j] * xi;
+                    }
+                }
+            }
+
+            // The rows and the columns of COO-SoA are read from two flat
+            // arrays, without going through the nz_iterator.
+            template <class C, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xcoo_soa_scheme<C, ST, IT>& a, XIt x, YIt y)
+            {
+                const auto& values = a.storage();
+                if (values.empty())
+                {
+                    return;
+                }
+                const auto& rows = a.coordinate()[0];
+                const auto& cols = a.coordinate()[1];
+                for (std::size_t k = 0; k < values.size(); ++k)
+                {
+                    y[rows[k]] += values[k] * x[cols[k]];
+                }
+            }
+
+            // Keys are sorted, the row is recomputed by a division only when
+            // a key goes past the end of the current row, i.e. once per
+            // non-empty row.
+            template <class K, class ST, class IT, class XIt, class YIt>
+            inline void spmv_impl(const xlinear_coo_scheme<K, ST, IT>& a, XIt x, YIt y)
+            {
+                const auto& keys = a.keys();
+                const auto& values = a.storage();
+                if (keys.empty())
+                {
+                    return;
+                }
+                std::size_t cols = static_cast<std::size_t>(a.shape()[1]);
+                std::size_t row = 0;
+                std::size_t row_begin = 0;
+                std::size_t row_end = cols;
+                for (std::size_t k = 0; k < keys.size(); ++k)
+                {
+                    std::size_t key = static_cast<std::size_t>(keys[k]);
+                    if (key >= row_end)
+                    {
+                        row = key / cols;
+                        row_begin = row * cols;
+                        row_end = row_begin + cols;
+                    }
+                    y[row] += values[k] * x[key - row_begin];
+                }
+            }
+        }
+
+        // Computes y += A * x where A is given by its scheme, x and y are
+        // random access iterators on dense vectors of adequate sizes.
+        template <class S, class XIt, class YIt>
+        inline void spmv(const S& a, XIt x, YIt y)
+        {
+            detail::spmv_impl(a, x, y);
+        }
+
+        /*****************
+         * parallel_spmv *
+         *****************/
+
+        namespace detail
+        {
+            inline std::size_t default_nb_partitions()
+            {
+#if defined(XTENSOR_USE_TBB)
+                return static_cast<std::size_t>(tbb::this_task_arena::max_concurrency());
+#elif defined(XTENSOR_USE_OPENMP)
+                return static_cast<std::size_t>(omp_get_max_threads());
+#else
+                return 1u;
+#endif
+            }
+
+            // Calls f(p) for p in [0, nb_parts), concurrently when TBB or
+            // OpenMP is enabled.
+            template <class F>
+            inline void parallel_for(std::size_t nb_parts, F&& f)
+            {
+#if defined(XTENSOR_USE_TBB)
+                tbb::parallel_for(std::size_t(0), nb_parts, [&f](std::size_t p) { f(p); });
+#elif defined(XTENSOR_USE_OPENMP)
+                std::ptrdiff_t nb = static_cast<std::ptrdiff_t>(nb_parts);
+                #pragma omp parallel for schedule(static, 1)
+                for (std::ptrdiff_t p = 0; p < nb; ++p)
+                {
+                    f(static_cast<std::size_t>(p));
+                }
+#else
+                for (std::size_t p = 0; p < nb_parts; ++p)
+                {
+                    f(p);
+                }
+#endif
+            }
+
+            // Splits the rows into nb_parts contiguous ranges of equal cost,
+            // the cost of a row being 1 + its number of non-zeros (row-granular
+            // merge path over the rows and the non-zeros). Returns the
+            // nb_parts + 1 row boundaries.
+            template <class Pos>
+            inline std::vector<std::size_t> partition_rows(const Pos& pos, std::size_t nb_parts)
+            {
+                std::size_t rows = pos.size() - 1;
+                std::size_t total = rows + pos[rows];
+                std::vector<std::size_t> bounds(nb_parts + 1, rows);
+                bounds[0] = 0;
+                for (std::size_t p = 1; p < nb_parts; ++p)
+                {
+                    std::size_t diagonal = total / nb_parts * p + total % nb_parts * p / nb_parts;
+                    // First row i such that i + pos[i] > diagonal
+                    std::size_t low = bounds[p - 1];
+                    std::size_t high = rows;
+                    while (low < high)
+                    {
+                        std::size_t mid = low + (high - low) / 2;
+                        if (mid + pos[mid] <= diagonal)
+                        {
+                            low = mid + 1;
+                        }
+                        else
+                        {
+                            high = mid;
+                        }
+                    }
+                    bounds[p] = low;
+                }
+                return bounds;
+            }
+
+            template <class S, class XIt, class YIt>
+            inline void parallel_spmv_impl(const S& a, XIt x, YIt y, std::size_t /*nb_parts*/)
+            {
+                spmv_impl(a, x, y);
+            }
+
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void parallel_spmv_impl(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a,
+                                           XIt x, YIt y, std::size_t nb_parts)
+            {
+                if (nb_parts < 2)
+                {
+                    spmv_impl(a, x, y);
+                    return;
+                }
+
+                auto bounds = partition_rows(a.position(), nb_parts);
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    spmv_rows(a, x, y, bounds[p], bounds[p + 1]);
+                });
+            }
+
+            template <std::size_t R, std::size_t CB, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void parallel_spmv_impl(const xbcsr_scheme<R, CB, P, C, ST, IT>& a,
+                                           XIt x, YIt y, std::size_t nb_parts)
+            {
+                if (nb_parts < 2)
+                {
+                    spmv_impl(a, x, y);
+                    return;
+                }
+
+                auto bounds = partition_rows(a.position(), nb_parts);
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    spmv_block_rows(a, x, y, bounds[p], bounds[p + 1]);
+                });
+            }
+
+            // Chunks of SELL are split like the rows of CSR, on the number of
+            // stored values, padding included.
+            template <std::size_t CS, std::size_t SW, class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void parallel_spmv_impl(const xsell_scheme<CS, SW, P, C, ST, IT>& a,
+                                           XIt x, YIt y, std::size_t nb_parts)
+            {
+                if (nb_parts < 2)
+                {
+                    spmv_impl(a, x, y);
+                    return;
+                }
+
+                auto bounds = partition_rows(a.position(), nb_parts);
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    spmv_chunks(a, x, y, bounds[p], bounds[p + 1]);
+                });
+            }
+
+            // All the rows of DIA hold the same number of stored values, they
+            // are split into ranges of equal sizes.
+            template <class O, class ST, class IT, class XIt, class YIt>
+            inline void parallel_spmv_impl(const xdia_scheme<O, ST, IT>& a,
+                                           XIt x, YIt y, std::size_t nb_parts)
+            {
+                if (nb_parts < 2)
+                {
+                    spmv_impl(a, x, y);
+                    return;
+                }
+
+                std::size_t rows = a.shape()[0];
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    spmv_diagonals(a, x, y, rows * p / nb_parts, rows * (p + 1) / nb_parts);
+                });
+            }
+
+            // The fibers of DCSR are split like the rows of CSR; each row
+            // belongs to a single fiber, hence to a single partition.
+            template <class P, class C, class ST, class IT, class XIt, class YIt>
+            inline void parallel_spmv_impl(const xdcsr_scheme<P, C, ST, IT, layout_type::row_major>& a,
+                                           XIt x, YIt y, std::size_t nb_parts)
+            {
+                if (nb_parts < 2)
+                {
+                    spmv_impl(a, x, y);
+                    return;
+                }
+
+                auto bounds = partition_rows(a.position(), nb_parts);
+                parallel_for(nb_parts, [&](std::size_t p)
+                {
+                    spmv_fibers(a, x, y, bounds[p], bounds[p + 1]);
+                });
+            }
+        }
+
+        // Multi-threaded version of spmv, using TBB or OpenMP depending on
+        // XTENSOR_USE_TBB / XTENSOR_USE_OPENMP. CSR rows (the non-empty rows
+        // of DCSR, the block rows of BCSR, the chunks of SELL) are split into
+        // nb_parts contiguous ranges of about the same estimated cost, the
+        // cost of a row being 1 + its number of stored entries (blocks for
+        // BCSR, padded values for SELL), so that long runs of empty rows are
+        // spread as well. DIA rows are split into nb_parts ranges of equal
+        // sizes; other schemes and builds without threading support run the
+        // serial kernel.
+        template <class S, class XIt, class YIt>
+        inline void parallel_spmv(const S& a, XIt x, YIt y, std::size_t nb_parts = detail::default_nb_partitions())
+        {
+            detail::parallel_spmv_impl(a, x, y, nb_parts);
+        }
+
+        /*******
+         * dot *
+         *******/
+
+        // Sparse matrix - dense vector product, returns a dense vector.
+        template <class D, class E>
+        inline auto dot(const xsparse_container<D>& a, const xexpression<E>& x)
+        {
+            using value_type = std::common_type_t<typename D::value_type, typename E::value_type>;
+            using result_type = xtensor<value_type, 1>;
+
+            const E& de = x.derived_cast();
+            if (a.dimension() != 2 || de.dimension() != 1 || a.shape()[1] != de.shape()[0])
+            {
+                XTENSOR_THROW(std::runtime_error, "dot: incompatible shapes for sparse matrix - vector product");
+            }
+
+            auto&& xv = xt::eval(de);
+            result_type res = result_type::from_shape({a.shape()[0]});
+            res.fill(value_type(0));
+            parallel_spmv(a.scheme(), xv.data(), res.data());
+            return res;
+        }
+
+        /*************
+         * transpose *
+         *************/
+
+        namespace detail
+        {
+            // Transposes the compressed arrays (pos, coords, values) whose
+            // inner dimension has size inner, with a counting sort on the
+            // inner coordinates; the result is stored in res.
+            template <class P, class C, class ST, class R>
+            inline void transpose_compressed(const P& pos, const C& coords, const ST& values, std::size_t inner, R& res)
+            {
+                using position_type = typename R::position_type;
+                using coordinate_type = typename R::coordinate_type;
+                using storage_type = typename R::storage_type;
+
+                std::size_t outer = pos.size() - 1;
+                std::size_t nnz = pos[outer];
+
+                position_type tpos(inner + 1, 0);
+                for (std::size_t j = 0; j < nnz; ++j)
+                {
+                    ++tpos[coords[j] + 1];
+                }
+                std::partial_sum(tpos.begin(), tpos.end(), tpos.begin());
+
+                coordinate_type tcoords(nnz);
+                storage_type tvalues(nnz);
+                std::vector<std::size_t> next(tpos.cbegin(), tpos.cend() - 1);
+                for (std::size_t i = 0; i < outer; ++i)
+                {
+                    for (std::size_t j = pos[i]; j < pos[i + 1]; ++j)
+                    {
+                        std::size_t dst = next[coords[j]]++;
+                        tcoords[dst] = static_cast<typename coordinate_type::value_type>(i);
+                        tvalues[dst] = values[j];
+                    }
+                }
+                res = R(std::move(tpos), std::move(tcoords), std::move(tvalues));
+            }
+        }
+
+        // Transpose of a CSR matrix with cols columns, computed with a
+        // counting sort on the column indices; the result is stored in res.
+        template <class P, class C, class ST, class IT, class R>
+        inline void transpose(const xcsr_scheme<P, C, ST, IT, layout_type::row_major>& a, std::size_t cols, R& res)
+        {
+            detail::transpose_compressed(a.position(), a.coordinate(), a.storage(), cols, res);
+        }
+
+        // Returns the transpose of a CSR-backed matrix as an xcsr_array.
+        template <class D>
+        inline auto transpose(const xsparse_container<D>& a)
+        {
+            using result_type = xcsr_array<typename D::value_type>;
+            if (a.dimension() != 2)
+            {
+                XTENSOR_THROW(std::runtime_error, "transpose: sparse matrix expected");
+            }
+
+            result_type res(std::vector<std::size_t>{a.shape()[1], a.shape()[0]});
+            transpose(a.scheme(), a.shape()[1], res.scheme());
+            return res;
+        }
+
+        /**********
+         * spgemm *
+         **********/
+
+        namespace detail
+        {
+            // Prefix sum of the number of multiplications required by each
+            // row of A * B, used to balance the work between threads.
+            template <class SA, class SB>
+            inline std::vector<std::size_t> spgemm_flops(const SA& a, const SB& b)
+            {
+                const auto& apos = a.position();
+                const auto& acoords = a.coordinate();
+                const auto& bpos = b.position();
+                std::size_t rows = apos.size() - 1;
+
+                std::vector<std::size_t> flops(rows + 1, 0);
+                for (std::size_t i = 0; i < rows; ++i)
+                {
+                    std::size_t row_flops = 0;
+                    for (std::size_t ja = apos[i]; ja < apos[i + 1]; ++ja)
+                    {
+                        row_flops += bpos[acoords[ja] + 1] - bpos[acoords[ja]];
+                    }
+                    flops[i + 1] = flops[i] + row_flops;
+                }
+                return flops;
+            }
+
+            // Symbolic phase: stores the exact number of non-zeros of the
+            // rows [first_row, last_row) of A * B in row_nnz[i + 1].
+            template <class SA, class SB, class Pos>
+            inline void spgemm_symbolic(const SA& a, const SB& b, std::vector<std::size_t>& marker,
+                                        std::size_t first_row, std::size_t last_row, Pos& row_nnz)
+            {
+                const auto& apos = a.position();
+                const auto& acoords = a.coordinate();
+                const auto& bpos = b.position();
+                const auto& bcoords = b.coordinate();
+
+                for (std::size_t i = first_row; i < last_row; ++i)
+                {
+                    std::size_t count = 0;
+                    for (std::size_t ja = apos[i]; ja < apos[i + 1]; ++ja)
+                    {
+                        std::size_t k = acoords[ja];
+                        for (std::size_t jb = bpos[k]; jb < bpos[k + 1]; ++jb)
+                        {
+                            std::size_t col = bcoords[jb];
+                            if (marker[col] != i)
+                            {
+                                marker[col] = i;
+                                ++count;
+                            }
+                        }
+                    }
+                    row_nnz[i + 1] = static_cast<typename Pos::value_type>(count);
+                }
+            }
+
+            // Numeric phase with a dense accumulator: the products of row i
+            // are accumulated in accumulator, indexed by column, then written
+            // to the preallocated range of the row with sorted columns.
+            template <class SA, class SB, class Pos, class C, class ST>
+            inline void spgemm_numeric(const SA& a, const SB& b, std::vector<std::size_t>& marker,
+                                       std::vector<typename ST::value_type>& accumulator,
+                                       std::size_t first_row, std::size_t last_row,
+                                       const Pos& cpos, C& ccoords, ST& cvalues)
+            {
+                const auto& apos = a.position();
+                const auto& acoords = a.coordinate();
+                const auto& avalues = a.storage();
+                const auto& bpos = b.position();
+                const auto& bcoords = b.coordinate();
+                const auto& bvalues = b.storage();
+
+                for (std::size_t i = first_row; i < last_row; ++i)
+                {
+                    std::size_t end = cpos[i];
+                    for (std::size_t ja = apos[i]; ja < apos[i + 1]; ++ja)
+                    {
+                        std::size_t k = acoords[ja];
+                        auto av = avalues[ja];
+                        for (std::size_t jb = bpos[k]; jb < bpos[k + 1]; ++jb)
+                        {
+                            std::size_t col = bcoords[jb];
+                            if (marker[col] != i)
+                            {
+                                marker[col] = i;
+                                ccoords[end++] = static_cast<typename C::value_type>(col);
+                                accumulator[col] = av * bvalues[jb];
+                            }
+                            else
+                            {
+                                accumulator[col] += av * bvalues[jb];
+                            }
+                        }
+                    }
+
+                    auto first = ccoords.begin() + static_cast<std::ptrdiff_t>(cpos[i]);
+                    std::sort(first, first + static_cast<std::ptrdiff_t>(end - cpos[i]));
+                    for (std::size_t j = cpos[i]; j < end; ++j)
+                    {
+                        cvalues[j] = accumulator[ccoords[j]];
+                    }
+                }
+            }
+        }
+
+        // Gustavson sparse matrix - sparse matrix product C = A * B on CSR
+        // schemes, b_cols being the number of columns of B. A symbolic phase
+        // computes the exact size of C before the numeric phase fills it.
+        // Rows are split into nb_parts ranges with the same number of
+        // multiplications, processed concurrently when TBB or OpenMP is
+        // enabled.
+        template <class PA, class CA, class STA, class ITA,
+                  class PB, class CB, class STB, class ITB, class R>
+        inline void spgemm(const xcsr_scheme<PA, CA, STA, ITA, layout_type::row_major>& a,
+                           const xcsr_scheme<PB, CB, STB, ITB, layout_type::row_major>& b,
+                           std::size_t b_cols, R& c, std::size_t nb_parts = detail::default_nb_partitions())
+        {
+            using position_type = typename R::position_type;
+            using coordinate_type = typename R::coordinate_type;
+            using storage_type = typename R::storage_type;
+            using value_type = typename storage_type::value_type;
+            constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+            std::size_t rows = a.position().size() - 1;
+            nb_parts = std::max(nb_parts, std::size_t(1));
+            auto bounds = detail::partition_rows(detail::spgemm_flops(a, b), nb_parts);
+
+            position_type cpos(rows + 1, 0);
+            detail::parallel_for(nb_parts, [&](std::size_t p)
+            {
+                std::vector<std::size_t> marker(b_cols, npos);
+                detail::spgemm_symbolic(a, b, marker, bounds[p], bounds[p + 1], cpos);
+            });
+            std::partial_sum(cpos.begin(), cpos.end(), cpos.begin());
+
+            coordinate_type ccoords(cpos[rows]);
+            storage_type cvalues(cpos[rows]);
+            detail::parallel_for(nb_parts, [&](std::size_t p)
+            {
+                std::vector<std::size_t> marker(b_cols, npos);
+                std::vector<value_type> accumulator(b_cols);
+                detail::spgemm_numeric(a, b, marker, accumulator, bounds[p], bounds[p + 1], cpos, ccoords, cvalues);
+            });
+
+            c = R(std::move(cpos), std::move(ccoords), std::move(cvalues));
+        }
+
+        // Product of two CSR-backed matrices, returns an xcsr_array.
+        template <class D1, class D2>
+        inline auto spgemm(const xsparse_container<D1>& a, const xsparse_container<D2>& b)
+        {
+            using value_type = std::common_type_t<typename D1::value_type, typename D2::value_type>;
+            using result_type = xcsr_array<value_type>;
+            if (a.dimension() != 2 || b.dimension() != 2 || a.shape()[1] != b.shape()[0])
+            {
+                XTENSOR_THROW(std::runtime_error, "spgemm: incompatible shapes for sparse matrix product");
+            }
+
+            result_type res(std::vector<std::size_t>{a.shape()[0], b.shape()[1]});
+            spgemm(a.scheme(), b.scheme(), b.shape()[1], res.scheme());
+            return res;
+        }
+    }
+}
+
+#endif
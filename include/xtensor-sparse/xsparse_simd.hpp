@@ -0,0 +1,376 @@
+#ifndef XSPARSE_SIMD_HPP
+#define XSPARSE_SIMD_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#if defined(XTENSOR_USE_XSIMD)
+#include <xsimd/xsimd.hpp>
+#endif
+
+#include <xtensor/xutils.hpp>
+
+namespace xt
+{
+    namespace sparse
+    {
+        namespace detail
+        {
+            /**************
+             * simd types *
+             **************/
+
+            // Without XTENSOR_USE_XSIMD, or for value types xsimd cannot
+            // vectorize, simd_size is 1 and the kernels below run their
+            // scalar loops.
+#if defined(XTENSOR_USE_XSIMD)
+            template <class T>
+            using simd_type = xsimd::simd_type<T>;
+
+            template <class T>
+            struct simd_size : std::integral_constant<std::size_t, xsimd::simd_traits<T>::size>
+            {
+            };
+#else
+            template <class T>
+            using simd_type = T;
+
+            template <class T>
+            struct simd_size : std::integral_constant<std::size_t, 1>
+            {
+            };
+#endif
+
+            template <class T>
+            using is_simd_vectorizable = std::integral_constant<bool, (simd_size<T>::value > 1)>;
+
+            /******************
+             * scalar kernels *
+             ******************/
+
+            template <class T, class I, class X>
+            inline T gather_dot(const T* values, const I* coords, X x, std::size_t size, std::false_type)
+            {
+                T sum = T(0);
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    sum += values[j] * x[coords[j]];
+                }
+                return sum;
+            }
+
+            // Products of the CS rows of a SELL chunk of the given width with a
+            // dense vector: res[l] is the sum over j of values[j * CS + l] *
+            // x[coords[j * CS + l]].
+            template <std::size_t CS, class T, class I, class X>
+            inline void chunk_dot(const T* values, const I* coords, X x, std::size_t width, T* res, std::false_type)
+            {
+                std::fill(res, res + CS, T(0));
+                for (std::size_t j = 0; j < width; ++j)
+                {
+                    for (std::size_t l = 0; l < CS; ++l)
+                    {
+                        res[l] += values[j * CS + l] * x[coords[j * CS + l]];
+                    }
+                }
+            }
+
+            template <class T>
+            inline void scale(T* values, std::size_t size, T factor, std::false_type)
+            {
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    values[j] *= factor;
+                }
+            }
+
+            template <class T>
+            inline T sum(const T* values, std::size_t size, std::false_type)
+            {
+                T res = T(0);
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    res += values[j];
+                }
+                return res;
+            }
+
+            template <class T, class F>
+            inline void for_each_above(const T* values, std::size_t size, T tolerance, F&& f, std::false_type)
+            {
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    if (std::abs(values[j]) > tolerance)
+                    {
+                        f(j);
+                    }
+                }
+            }
+
+            /*****************
+             * xsimd kernels *
+             *****************/
+
+#if defined(XTENSOR_USE_XSIMD)
+            // Dot product of a compressed row with a dense vector; the dense
+            // operand is gathered through an aligned buffer since xsimd has
+            // no portable gather instruction.
+            template <class T, class I, class X>
+            inline T gather_dot(const T* values, const I* coords, X x, std::size_t size, std::true_type)
+            {
+                using batch_type = simd_type<T>;
+                constexpr std::size_t N = simd_size<T>::value;
+                alignas(batch_type) T buffer[N];
+
+                std::size_t simd_end = size - size % N;
+                batch_type acc(T(0));
+                for (std::size_t j = 0; j < simd_end; j += N)
+                {
+                    for (std::size_t k = 0; k < N; ++k)
+                    {
+                        buffer[k] = x[coords[j + k]];
+                    }
+                    acc = xsimd::fma(xsimd::load_unaligned(values + j), xsimd::load_aligned(buffer), acc);
+                }
+                T res = xsimd::hadd(acc);
+                for (std::size_t j = simd_end; j < size; ++j)
+                {
+                    res += values[j] * x[coords[j]];
+                }
+                return res;
+            }
+
+            // The values of a column of the chunk are contiguous: they are
+            // loaded CS / N batches at a time, x is gathered through an
+            // aligned buffer and each batch of rows keeps its own
+            // accumulator, so that no horizontal add is needed.
+            template <std::size_t CS, class T, class I, class X>
+            inline void chunk_dot(const T* values, const I* coords, X x, std::size_t width, T* res, std::true_type)
+            {
+                using batch_type = simd_type<T>;
+                constexpr std::size_t N = simd_size<T>::value;
+                constexpr std::size_t nb_batches = CS / N;
+                alignas(batch_type) T buffer[N];
+
+                batch_type acc[nb_batches];
+                for (std::size_t b = 0; b < nb_batches; ++b)
+                {
+                    acc[b] = batch_type(T(0));
+                }
+                for (std::size_t j = 0; j < width; ++j)
+                {
+                    for (std::size_t b = 0; b < nb_batches; ++b)
+                    {
+                        std::size_t offset = j * CS + b * N;
+                        for (std::size_t k = 0; k < N; ++k)
+                        {
+                            buffer[k] = x[coords[offset + k]];
+                        }
+                        acc[b] = xsimd::fma(xsimd::load_unaligned(values + offset), xsimd::load_aligned(buffer), acc[b]);
+                    }
+                }
+                for (std::size_t b = 0; b < nb_batches; ++b)
+                {
+                    xsimd::store_unaligned(res + b * N, acc[b]);
+                }
+            }
+
+            template <class T>
+            inline void scale(T* values, std::size_t size, T factor, std::true_type)
+            {
+                using batch_type = simd_type<T>;
+                constexpr std::size_t N = simd_size<T>::value;
+
+                std::size_t simd_end = size - size % N;
+                batch_type bfactor(factor);
+                for (std::size_t j = 0; j < simd_end; j += N)
+                {
+                    xsimd::store_unaligned(values + j, xsimd::load_unaligned(values + j) * bfactor);
+                }
+                for (std::size_t j = simd_end; j < size; ++j)
+                {
+                    values[j] *= factor;
+                }
+            }
+
+            template <class T>
+            inline T sum(const T* values, std::size_t size, std::true_type)
+            {
+                using batch_type = simd_type<T>;
+                constexpr std::size_t N = simd_size<T>::value;
+
+                std::size_t simd_end = size - size % N;
+                batch_type acc(T(0));
+                for (std::size_t j = 0; j < simd_end; j += N)
+                {
+                    acc += xsimd::load_unaligned(values + j);
+                }
+                T res = xsimd::hadd(acc);
+                for (std::size_t j = simd_end; j < size; ++j)
+                {
+                    res += values[j];
+                }
+                return res;
+            }
+
+            // Calls f(j) for the indices j of the values whose magnitude is
+            // greater than tolerance; batches holding no such value are
+            // skipped with a single comparison.
+            template <class T, class F>
+            inline void for_each_above(const T* values, std::size_t size, T tolerance, F&& f, std::true_type)
+            {
+                using batch_type = simd_type<T>;
+                constexpr std::size_t N = simd_size<T>::value;
+
+                std::size_t simd_end = size - size % N;
+                batch_type btolerance(tolerance);
+                for (std::size_t j = 0; j < simd_end; j += N)
+                {
+                    if (xsimd::any(xsimd::abs(xsimd::load_unaligned(values + j)) > btolerance))
+                    {
+                        for (std::size_t k = j; k < j + N; ++k)
+                        {
+                            if (std::abs(values[k]) > tolerance)
+                            {
+                                f(k);
+                            }
+                        }
+                    }
+                }
+                for (std::size_t j = simd_end; j < size; ++j)
+                {
+                    if (std::abs(values[j]) > tolerance)
+                    {
+                        f(j);
+                    }
+                }
+            }
+#endif
+
+            /**********************
+             * kernel dispatching *
+             **********************/
+
+            template <class T, class I, class X>
+            inline T gather_dot(const T* values, const I* coords, X x, std::size_t size)
+            {
+                return gather_dot(values, coords, x, size, is_simd_vectorizable<T>());
+            }
+
+            // The SIMD kernel requires CS to be a multiple of the batch size.
+            template <std::size_t CS, class T, class I, class X>
+            inline void chunk_dot(const T* values, const I* coords, X x, std::size_t width, T* res)
+            {
+                using use_simd = std::integral_constant<bool, is_simd_vectorizable<T>::value && CS % simd_size<T>::value == 0>;
+                chunk_dot<CS>(values, coords, x, width, res, use_simd());
+            }
+
+            template <class T>
+            inline void scale(T* values, std::size_t size, T factor)
+            {
+                scale(values, size, factor, is_simd_vectorizable<T>());
+            }
+
+            template <class T>
+            inline T sum(const T* values, std::size_t size)
+            {
+                return sum(values, size, is_simd_vectorizable<T>());
+            }
+
+            template <class T>
+            using use_simd_threshold = std::integral_constant<bool,
+                std::is_floating_point<T>::value && is_simd_vectorizable<T>::value>;
+
+            template <class T, class F>
+            inline void for_each_above(const T* values, std::size_t size, T tolerance, F&& f)
+            {
+                for_each_above(values, size, tolerance, std::forward<F>(f), use_simd_threshold<T>());
+            }
+
+            template <class ST, class = void_t<>>
+            struct has_contiguous_storage : std::false_type
+            {
+            };
+
+            template <class ST>
+            struct has_contiguous_storage<ST, void_t<decltype(std::declval<ST&>().data())>>
+                : std::true_type
+            {
+            };
+
+            // Only some schemes give write access to their values through
+            // storage(); the others are scaled through their nz_iterator.
+            template <class S, class = void_t<>>
+            struct has_mutable_storage : std::false_type
+            {
+            };
+
+            template <class S>
+            struct has_mutable_storage<S, void_t<decltype(std::declval<S&>().storage().data())>>
+                : std::integral_constant<bool, !std::is_const<std::remove_pointer_t<decltype(std::declval<S&>().storage().data())>>::value>
+            {
+            };
+
+            template <class S, class T>
+            inline void scale_scheme(S& s, T factor, std::true_type /* contiguous */)
+            {
+                auto& storage = s.storage();
+                scale(storage.data(), storage.size(), static_cast<typename S::value_type>(factor));
+            }
+
+            template <class S, class T>
+            inline void scale_scheme(S& s, T factor, std::false_type /* contiguous */)
+            {
+                for (auto it = s.nz_begin(); it != s.nz_end(); ++it)
+                {
+                    *it *= factor;
+                }
+            }
+
+            template <class S>
+            inline auto sum_scheme(const S& s, std::true_type /* contiguous */)
+            {
+                const auto& storage = s.storage();
+                return sum(storage.data(), storage.size());
+            }
+
+            template <class S>
+            inline auto sum_scheme(const S& s, std::false_type /* contiguous */)
+            {
+                typename S::value_type res(0);
+                for (auto it = s.nz_cbegin(); it != s.nz_cend(); ++it)
+                {
+                    res += *it;
+                }
+                return res;
+            }
+        }
+
+        /*********
+         * scale *
+         *********/
+
+        // Multiplies all the stored values of the scheme by factor, in place.
+        template <class S, class T>
+        inline void scale(S& s, T factor)
+        {
+            detail::scale_scheme(s, factor, detail::has_mutable_storage<S>());
+        }
+
+        /*******
+         * sum *
+         *******/
+
+        // Sum of the stored values of the scheme.
+        template <class S>
+        inline auto sum(const S& s)
+        {
+            return detail::sum_scheme(s, detail::has_contiguous_storage<typename S::storage_type>());
+        }
+    }
+}
+
+#endif
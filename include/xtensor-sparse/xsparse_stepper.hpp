@@ -0,0 +1,284 @@
+#ifndef XSPARSE_STEPPER_HPP
+#define XSPARSE_STEPPER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xiterator.hpp>
+#include <xtensor/xlayout.hpp>
+
+#include "xsparse_expression.hpp"
+
+namespace xt
+{
+    /*******************
+     * xsparse_stepper *
+     *******************/
+
+    // Read-only stepper over a sparse container whose non-zeros are iterated
+    // in row-major order. A cursor on the non-zeros is moved in lockstep
+    // with the dense index instead of looking up each element, so that a
+    // full row-major traversal costs O(size + nnz), and a traversal in any
+    // other order O(size log(nnz)).
+    template <class C>
+    class xsparse_stepper
+    {
+    public:
+
+        using self_type = xsparse_stepper<C>;
+        using xexpression_type = const C;
+
+        using value_type = typename C::value_type;
+        using reference = typename C::const_reference;
+        using pointer = typename C::const_pointer;
+        using size_type = typename C::size_type;
+        using difference_type = typename C::difference_type;
+
+        using shape_type = typename C::shape_type;
+        using index_type = shape_type;
+        using nz_iterator = typename C::const_nz_iterator;
+
+        xsparse_stepper(xexpression_type* e, size_type offset, bool end = false, layout_type l = XTENSOR_DEFAULT_TRAVERSAL);
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+        void reset_back(size_type dim);
+
+        void to_begin();
+        void to_end(layout_type l);
+
+    private:
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        std::size_t nz_offset(const nz_iterator& it) const;
+        nz_iterator lower_bound(nz_iterator first, nz_iterator last) const;
+        void update_linear_offset();
+        void sync() const;
+
+        xexpression_type* p_e;
+        index_type m_index;
+        index_type m_strides;
+        size_type m_offset;
+        std::size_t m_linear_offset;
+
+        nz_iterator m_nz_begin;
+        nz_iterator m_nz_end;
+        mutable nz_iterator m_nz_it;
+        mutable std::size_t m_nz_offset;
+        mutable std::size_t m_synced_offset;
+    };
+
+    // The cursor is repositioned with jumps over the non-zeros, so schemes
+    // whose nz_iterator moves one non-zero at a time, such as the map scheme,
+    // keep the indexed stepper, as does CSC, which iterates its non-zeros in
+    // column-major order.
+    template <class C, class S>
+    using xsparse_const_stepper_t = std::conditional_t<extension::get_nz_layout<S>::value == layout_type::row_major &&
+                                                           has_fast_nz_advance<typename S::const_nz_iterator>::value,
+                                                       xsparse_stepper<C>,
+                                                       xindexed_stepper<C, true>>;
+
+    /**********************************
+     * xsparse_stepper implementation *
+     **********************************/
+
+    template <class C>
+    constexpr std::size_t xsparse_stepper<C>::npos;
+
+    template <class C>
+    inline xsparse_stepper<C>::xsparse_stepper(xexpression_type* e, size_type offset, bool end, layout_type l)
+        : p_e(e)
+        , m_index(xtl::make_sequence<index_type>(e->shape().size(), size_type(0)))
+        , m_strides(xtl::make_sequence<index_type>(e->shape().size(), size_type(1)))
+        , m_offset(offset)
+        , m_linear_offset(0)
+        , m_nz_begin(e->nz_cbegin())
+        , m_nz_end(e->nz_cend())
+        , m_nz_it(m_nz_begin)
+        , m_nz_offset(npos)
+        , m_synced_offset(0)
+    {
+        const auto& shape = p_e->shape();
+        for (std::size_t d = m_strides.size(); d > 1; --d)
+        {
+            m_strides[d - 2] = m_strides[d - 1] * shape[d - 1];
+        }
+        m_nz_offset = nz_offset(m_nz_it);
+
+        if (end)
+        {
+            to_end(l);
+        }
+    }
+
+    template <class C>
+    inline auto xsparse_stepper<C>::operator*() const -> reference
+    {
+        sync();
+        return m_nz_offset == m_linear_offset ? *m_nz_it : C::ZERO;
+    }
+
+    template <class C>
+    inline void xsparse_stepper<C>::step(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            m_index[dim - m_offset] += n;
+            m_linear_offset += n * m_strides[dim - m_offset];
+        }
+    }
+
+    template <class C>
+    inline void xsparse_stepper<C>::step_back(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            m_index[dim - m_offset] -= n;
+            m_linear_offset -= n * m_strides[dim - m_offset];
+        }
+    }
+
+    template <class C>
+    inline void xsparse_stepper<C>::reset(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            m_linear_offset -= m_index[dim - m_offset] * m_strides[dim - m_offset];
+            m_index[dim - m_offset] = 0;
+        }
+    }
+
+    template <class C>
+    inline void xsparse_stepper<C>::reset_back(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            size_type last = p_e->shape()[dim - m_offset] - 1;
+            m_linear_offset += (last - m_index[dim - m_offset]) * m_strides[dim - m_offset];
+            m_index[dim - m_offset] = last;
+        }
+    }
+
+    template <class C>
+    inline void xsparse_stepper<C>::to_begin()
+    {
+        std::fill(m_index.begin(), m_index.end(), size_type(0));
+        m_linear_offset = 0;
+    }
+
+    template <class C>
+    inline void xsparse_stepper<C>::to_end(layout_type l)
+    {
+        const auto& shape = p_e->shape();
+        if (shape.size() != 0)
+        {
+            std::transform(shape.cbegin(), shape.cend(), m_index.begin(), [](const auto& v) { return v - 1; });
+            size_type l_dim = (l == layout_type::row_major) ? shape.size() - 1 : 0;
+            m_index[l_dim] = shape[l_dim];
+        }
+        update_linear_offset();
+    }
+
+    template <class C>
+    inline std::size_t xsparse_stepper<C>::nz_offset(const nz_iterator& it) const
+    {
+        if (it == m_nz_end)
+        {
+            return npos;
+        }
+        const auto& index = it.index();
+        std::size_t res = 0;
+        for (std::size_t d = 0; d < m_strides.size(); ++d)
+        {
+            res += static_cast<std::size_t>(index[d]) * m_strides[d];
+        }
+        return res;
+    }
+
+    template <class C>
+    inline void xsparse_stepper<C>::update_linear_offset()
+    {
+        m_linear_offset = 0;
+        for (std::size_t d = 0; d < m_strides.size(); ++d)
+        {
+            m_linear_offset += m_index[d] * m_strides[d];
+        }
+    }
+
+    // Returns the first non-zero of [first, last) whose offset is not less
+    // than the current one, last if there is none.
+    template <class C>
+    inline auto xsparse_stepper<C>::lower_bound(nz_iterator first, nz_iterator last) const -> nz_iterator
+    {
+        while (first != last)
+        {
+            nz_iterator mid = first + static_cast<difference_type>(last - first) / 2;
+            if (nz_offset(mid) < m_linear_offset)
+            {
+                first = mid + 1;
+            }
+            else
+            {
+                last = mid;
+            }
+        }
+        return first;
+    }
+
+    // Moves the cursor to the first non-zero whose offset is not less than
+    // the current one. The target is bracketed with steps of doubling size
+    // from the cursor, then searched by bisection, so that a move over k
+    // non-zeros costs O(log(k)). Row-major traversals only move forward by
+    // a few non-zeros; broadcast dimensions and column-major traversals
+    // also jump back and over whole rows.
+    template <class C>
+    inline void xsparse_stepper<C>::sync() const
+    {
+        nz_iterator first = m_nz_it;
+        nz_iterator last = m_nz_it;
+        difference_type n = 1;
+        if (m_linear_offset < m_synced_offset)
+        {
+            while (first != m_nz_begin)
+            {
+                first -= std::min(n, static_cast<difference_type>(first - m_nz_begin));
+                if (nz_offset(first) < m_linear_offset)
+                {
+                    break;
+                }
+                last = first;
+                n *= 2;
+            }
+        }
+        else if (m_nz_offset < m_linear_offset)
+        {
+            while (last != m_nz_end)
+            {
+                last += std::min(n, static_cast<difference_type>(m_nz_end - last));
+                if (nz_offset(last) >= m_linear_offset)
+                {
+                    break;
+                }
+                first = last;
+                n *= 2;
+            }
+        }
+        nz_iterator it = lower_bound(first, last);
+        if (it != m_nz_it)
+        {
+            m_nz_it = it;
+            m_nz_offset = nz_offset(m_nz_it);
+        }
+        m_synced_offset = m_linear_offset;
+    }
+}
+
+#endif
@@ -9,8 +9,10 @@
 #include "xcoo_scheme.hpp"
 #include "xcsf_scheme.hpp"
 #include "xcsr_scheme.hpp"
+#include "xfixed_csf_scheme.hpp"
 #include "xmap_scheme.hpp"
 #include "xsparse_container.hpp"
+#include "xsparse_stepper.hpp"
 
 namespace xt
 {
@@ -47,7 +49,7 @@ namespace xt
     {
         using tensor_type = xsparse_tensor<T, N, S>;
         using inner_shape_type = typename xcontainer_inner_types<tensor_type>::shape_type;
-        using const_stepper = xindexed_stepper<tensor_type, true>;
+        using const_stepper = xsparse_const_stepper_t<tensor_type, S>;
         using stepper = xindexed_stepper<tensor_type, false>;
     };
 
@@ -1,9 +1,18 @@
 #ifndef XSPARSE_TYPES_HPP
 #define XSPARSE_TYPES_HPP
 
+#include "xbcsr_scheme.hpp"
 #include "xcoo_scheme.hpp"
+#include "xcoo_soa_scheme.hpp"
 #include "xcsf_scheme.hpp"
+#include "xcsr_scheme.hpp"
+#include "xdcsr_scheme.hpp"
+#include "xdia_scheme.hpp"
+#include "xfixed_csf_scheme.hpp"
+#include "xhash_scheme.hpp"
+#include "xlinear_coo_scheme.hpp"
 #include "xmap_scheme.hpp"
+#include "xsell_scheme.hpp"
 #include "xsparse_config.hpp"
 
 namespace xt
@@ -19,26 +28,93 @@ namespace xt
      * Common sparse array types *
      *****************************/
 
-    template <class T>
-    using xcoo_array = xsparse_array<T, XSPARSE_DEFAULT_ARRAY_SCHEME(coo, T)>;
+    // C and P select the integer types storing the coordinates and the
+    // positions of the scheme, e.g. xcsr_array<double, std::uint32_t> halves
+    // the index memory of a matrix with less than 2^32 non-zeros. DIA stores
+    // no coordinate per element and has no such parameters.
 
-    template <class T>
-    using xcsf_array = xsparse_array<T, XSPARSE_DEFAULT_ARRAY_SCHEME(csf, T)>;
+    template <class T, class C = std::size_t, class P = C>
+    using xcoo_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(coo, T, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xcoo_soa_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(coo_soa, T, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xlinear_coo_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(linear_coo, T, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xcsr_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(csr, T, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xcsc_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(csc, T, C, P)>;
+
+    template <class T, std::size_t R, std::size_t CB = R, class C = std::size_t, class P = C>
+    using xbcsr_array = xsparse_array<T, xdefault_bcsr_scheme_t<T, svector<std::size_t>, R, CB, C, P>>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xdcsr_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(dcsr, T, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xdcsc_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(dcsc, T, C, P)>;
 
     template <class T>
-    using xmap_array = xsparse_array<T, XSPARSE_DEFAULT_ARRAY_SCHEME(map, T)>;
+    using xdia_array = xsparse_array<T, XSPARSE_DEFAULT_ARRAY_SCHEME(dia, T)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xcsf_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(csf, T, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xmap_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(map, T, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xhash_array = xsparse_array<T, XSPARSE_ARRAY_SCHEME(hash, T, C, P)>;
+
+    template <class T, std::size_t CS = 8, std::size_t SW = 256, class C = std::size_t, class P = C>
+    using xsell_array = xsparse_array<T, xdefault_sell_scheme_t<T, svector<std::size_t>, CS, SW, C, P>>;
 
     /******************************
      * Common sparse tensor types *
      ******************************/
 
-    template <class T, std::size_t N>
-    using xcoo_tensor = xsparse_tensor<T, N, XSPARSE_DEFAULT_TENSOR_SCHEME(coo, T, N)>;
+    template <class T, std::size_t N, class C = std::size_t, class P = C>
+    using xcoo_tensor = xsparse_tensor<T, N, XSPARSE_TENSOR_SCHEME(coo, T, N, C, P)>;
+
+    template <class T, std::size_t N, class C = std::size_t, class P = C>
+    using xcoo_soa_tensor = xsparse_tensor<T, N, XSPARSE_TENSOR_SCHEME(coo_soa, T, N, C, P)>;
+
+    template <class T, std::size_t N, class C = std::size_t, class P = C>
+    using xlinear_coo_tensor = xsparse_tensor<T, N, XSPARSE_TENSOR_SCHEME(linear_coo, T, N, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xcsr_tensor = xsparse_tensor<T, 2, XSPARSE_TENSOR_SCHEME(csr, T, 2, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xcsc_tensor = xsparse_tensor<T, 2, XSPARSE_TENSOR_SCHEME(csc, T, 2, C, P)>;
+
+    template <class T, std::size_t R, std::size_t CB = R, class C = std::size_t, class P = C>
+    using xbcsr_tensor = xsparse_tensor<T, 2, xdefault_bcsr_scheme_t<T, std::array<std::size_t, 2>, R, CB, C, P>>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xdcsr_tensor = xsparse_tensor<T, 2, XSPARSE_TENSOR_SCHEME(dcsr, T, 2, C, P)>;
+
+    template <class T, class C = std::size_t, class P = C>
+    using xdcsc_tensor = xsparse_tensor<T, 2, XSPARSE_TENSOR_SCHEME(dcsc, T, 2, C, P)>;
+
+    template <class T>
+    using xdia_tensor = xsparse_tensor<T, 2, XSPARSE_DEFAULT_TENSOR_SCHEME(dia, T, 2)>;
+
+    // The rank of a tensor is known at compile time, its CSF levels are held
+    // in std::arrays.
+    template <class T, std::size_t N, class C = std::size_t, class P = C>
+    using xcsf_tensor = xsparse_tensor<T, N, XSPARSE_TENSOR_SCHEME(fixed_csf, T, N, C, P)>;
+
+    template <class T, std::size_t N, class C = std::size_t, class P = C>
+    using xmap_tensor = xsparse_tensor<T, N, XSPARSE_TENSOR_SCHEME(map, T, N, C, P)>;
 
-    template <class T, std::size_t N>
-    using xcsf_tensor = xsparse_tensor<T, N, XSPARSE_DEFAULT_TENSOR_SCHEME(csf, T, N)>;
+    template <class T, std::size_t N, class C = std::size_t, class P = C>
+    using xhash_tensor = xsparse_tensor<T, N, XSPARSE_TENSOR_SCHEME(hash, T, N, C, P)>;
 
-    template <class T, std::size_t N>
-    using xmap_tensor = xsparse_tensor<T, N, XSPARSE_DEFAULT_TENSOR_SCHEME(map, T, N)>;
+    template <class T, std::size_t CS = 8, std::size_t SW = 256, class C = std::size_t, class P = C>
+    using xsell_tensor = xsparse_tensor<T, 2, xdefault_sell_scheme_t<T, std::array<std::size_t, 2>, CS, SW, C, P>>;
 }
 #endif
\ No newline at end of file
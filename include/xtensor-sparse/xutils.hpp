@@ -1,91 +1,180 @@
 #ifndef XSPARSE_UTILS_HPP
 #define XSPARSE_UTILS_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <numeric>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <xtl/xsequence.hpp>
+
+#include <xtensor/xexception.hpp>
 
 namespace xt
 {
+    /*****************************
+     * static_for implementation *
+     *****************************/
+
     namespace detail
     {
-        template <std::size_t I, class F, class... T>
-        inline typename std::enable_if<I == sizeof...(T), void>::type
-        transform_impl(F&& /*f*/, std::tuple<T...>& /*t*/, std::tuple<T*...>& /*d*/) //noexcept
+        template <std::size_t I, std::size_t N, class F>
+        inline std::enable_if_t<I == N, void>
+        static_for_impl(F&& /*f*/) noexcept
         {
         }
 
-        template <std::size_t I, class F, class... T>
-        inline typename std::enable_if<I < sizeof...(T), void>::type
-        transform_impl(F&& f, std::tuple<T...>& t, std::tuple<T*...>& d)
-            noexcept(noexcept(f(I, std::get<I>(t))))
+        template <std::size_t I, std::size_t N, class F>
+        inline std::enable_if_t<I < N, void>
+        static_for_impl(F&& f)
+            noexcept(noexcept(f(std::integral_constant<std::size_t, I>())))
         {
-            std::get<I>(d) = f(I, std::get<I>(t));
-            transform_impl<I + 1, F, T...>(std::forward<F>(f), t, d);
+            f(std::integral_constant<std::size_t, I>());
+            static_for_impl<I + 1, N, F>(std::forward<F>(f));
         }
     }
 
-    template <class F, class... T>
-    inline void transform(F&& f, std::tuple<T...>& t, std::tuple<T*...>& dest)
-        noexcept(noexcept(detail::transform_impl<0, F, T...>(std::forward<F>(f), t, dest)))
+    // Calls f(std::integral_constant<std::size_t, I>()) for I in [0, N), so
+    // that f can use I to access elements of several tuples at once.
+    template <std::size_t N, class F>
+    inline void static_for(F&& f)
+        noexcept(noexcept(detail::static_for_impl<0, N, F>(std::forward<F>(f))))
     {
-        detail::transform_impl<0, F, T...>(std::forward<F>(f), t, dest);
+        detail::static_for_impl<0, N, F>(std::forward<F>(f));
     }
 
+    /**********************
+     * stored coordinates *
+     **********************/
+
+    // Schemes may store coordinates and positions with an integer type
+    // narrower than the value_type of their index_type (e.g. std::uint32_t
+    // instead of std::size_t), the public API still takes and returns
+    // index_type.
+
     namespace detail
     {
-        template <std::size_t I, class F, class... T>
-        inline typename std::enable_if<I == sizeof...(T), void>::type
-        update_it_impl(F&& /*f*/, std::tuple<T...>& /*t*/, std::tuple<T...>& /*sentinel*/, std::tuple<T*...>& /*d*/) //noexcept
+        // Converts value to the integer type S used to store it.
+        template <class S, class T>
+        inline S stored_cast(T value)
         {
+            XTENSOR_ASSERT(static_cast<std::size_t>(value) <= static_cast<std::size_t>(std::numeric_limits<S>::max()));
+            return static_cast<S>(value);
         }
 
-        template <std::size_t I, class F, class... T>
-        inline typename std::enable_if<I < sizeof...(T), void>::type
-        update_it_impl(F&& f, std::tuple<T...>& t, std::tuple<T...>& sentinel, std::tuple<T*...>& d)
-            noexcept(noexcept(f(I, std::get<I>(t), std::get<I>(sentinel), std::get<I>(d))))
+        // Converts index to the index type R, without any copy when the
+        // types already match.
+        template <class R, class I>
+        inline std::enable_if_t<std::is_same<R, I>::value, const R&>
+        convert_index(const I& index) noexcept
         {
-            f(I, std::get<I>(t), std::get<I>(sentinel), std::get<I>(d));
-            update_it_impl<I + 1, F, T...>(std::forward<F>(f), t, sentinel, d);
+            return index;
         }
-    }
 
-    template <class F, class... T>
-    inline void update_it(F&& f, std::tuple<T...>& t, std::tuple<T...>& sentinel, std::tuple<T*...>& dest)
-        noexcept(noexcept(detail::update_it_impl<0, F, T...>(std::forward<F>(f), t, sentinel, dest)))
-    {
-        detail::update_it_impl<0, F, T...>(std::forward<F>(f), t, sentinel, dest);
-    }
+        template <class R, class I>
+        inline std::enable_if_t<!std::is_same<R, I>::value, R>
+        convert_index(const I& index)
+        {
+            using value_type = typename R::value_type;
+            R res = xtl::make_sequence<R>(index.size());
+            std::transform(index.cbegin(), index.cend(), res.begin(),
+                           [](auto i) { return stored_cast<value_type>(i); });
+            return res;
+        }
 
-    /*****************************
-     * accumulate implementation *
-     *****************************/
+        // Same as above, the converted index is written to buffer so that
+        // nz_iterators can return it by reference.
+        template <class R, class I>
+        inline std::enable_if_t<std::is_same<R, I>::value, const R&>
+        convert_index(const I& index, R&) noexcept
+        {
+            return index;
+        }
+
+        template <class R, class I>
+        inline std::enable_if_t<!std::is_same<R, I>::value, const R&>
+        convert_index(const I& index, R& buffer)
+        {
+            buffer = convert_index<R>(index);
+            return buffer;
+        }
+    }
 
-    /// @cond DOXYGEN_INCLUDE_NOEXCEPT
+    /***************
+     * sorted keys *
+     ***************/
 
     namespace detail
     {
-        template <std::size_t I, class F, class R, class... T>
-        inline std::enable_if_t<I == sizeof...(T), R>
-        accumulate_impl(F&& /*f*/, R init, const std::tuple<T...>& /*t*/, const std::array<bool, sizeof...(T)>& /*is_valid*/) noexcept
+        // Stable LSD radix sort of the unsigned integer keys, applying the
+        // same permutation to values; one byte is sorted per pass. Only the
+        // bytes significant in the largest key are sorted, and a pass where
+        // all the keys share the same byte is skipped, so that small offsets
+        // (e.g. the ones of a matrix with less than 2^32 elements) do not pay
+        // for the full width of the key type.
+        template <class K, class V>
+        inline void radix_sort(K& keys, V& values)
         {
-            return init;
+            using key_type = typename K::value_type;
+            static_assert(std::is_unsigned<key_type>::value, "radix_sort requires unsigned keys");
+
+            std::size_t size = keys.size();
+            if (size < 2)
+            {
+                return;
+            }
+
+            key_type max_key = *std::max_element(keys.cbegin(), keys.cend());
+            K tmp_keys(size);
+            V tmp_values(size);
+            for (std::size_t shift = 0; shift < 8 * sizeof(key_type) && (max_key >> shift) != 0; shift += 8)
+            {
+                std::array<std::size_t, 257> count = {};
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    ++count[((keys[i] >> shift) & 0xFFu) + 1u];
+                }
+                if (count[((keys[0] >> shift) & 0xFFu) + 1u] == size)
+                {
+                    continue;
+                }
+                std::partial_sum(count.cbegin(), count.cend(), count.begin());
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    std::size_t dst = count[(keys[i] >> shift) & 0xFFu]++;
+                    tmp_keys[dst] = keys[i];
+                    tmp_values[dst] = values[i];
+                }
+                using std::swap;
+                swap(keys, tmp_keys);
+                swap(values, tmp_values);
+            }
         }
 
-        template <std::size_t I, class F, class R, class... T>
-        inline std::enable_if_t<I < sizeof...(T), R>
-        accumulate_impl(F&& f, R init, const std::tuple<T...>& t, const std::array<bool, sizeof...(T)>& is_valid)
-            noexcept(noexcept(f(init, std::get<I>(t), true)))
+        // Equivalent to std::lower_bound on the random access range
+        // [first, first + size), without data-dependent branch: the number of
+        // iterations only depends on size and the selection of the half
+        // compiles to a conditional move.
+        template <class It, class T>
+        inline It branchless_lower_bound(It first, std::size_t size, const T& value)
         {
-            R res = f(init, std::get<I>(t), is_valid[I]);
-            return accumulate_impl<I + 1, F, R, T...>(std::forward<F>(f), res, t, is_valid);
+            if (size == 0)
+            {
+                return first;
+            }
+            while (size > 1)
+            {
+                std::size_t half = size / 2;
+                first += (first[static_cast<std::ptrdiff_t>(half)] < value) ? static_cast<std::ptrdiff_t>(half) : 0;
+                size -= half;
+            }
+            return first + ((*first < value) ? 1 : 0);
         }
     }
-
-    template <class F, class R, class... T>
-    inline R accumulate(F&& f, R init, const std::tuple<T...>& t, const std::array<bool, sizeof...(T)>& is_valid)
-        noexcept(noexcept(detail::accumulate_impl<0, F, R, T...>(std::forward<F>(f), init, t, is_valid)))
-    {
-        return detail::accumulate_impl<0, F, R, T...>(std::forward<F>(f), init, t, is_valid);
-    }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -12,6 +12,8 @@ namespace xt
     using container_list_types = ::testing::Types<
                                  std::tuple<    xcoo_array<double>,     xarray<double>,     xcoo_array<double>>,
                                  std::tuple<xcoo_tensor<double, 2>, xtensor<double, 2>, xcoo_tensor<double, 2>>,
+                                 std::tuple<    xcsr_array<double>,     xarray<double>,     xcoo_array<double>>,
+                                 std::tuple<   xcsr_tensor<double>, xtensor<double, 2>, xcoo_tensor<double, 2>>,
                                  std::tuple<    xcsf_array<double>,     xarray<double>,     xcoo_array<double>>,
                                  std::tuple<xcsf_tensor<double, 2>, xtensor<double, 2>, xcoo_tensor<double, 2>>,
                                  std::tuple<    xmap_array<double>,     xarray<double>,     xcoo_array<double>>,
@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+
+#include "xtensor-sparse/xbcsr_scheme.hpp"
+#include "xtensor-sparse/xcsr_scheme.hpp"
+#include "xtensor-sparse/xsparse_array.hpp"
+
+namespace xt
+{
+    using index_type = std::size_t;
+    using xbcsr_scheme_type = xbcsr_scheme<2, 2,
+                                           std::vector<index_type>,
+                                           std::vector<index_type>,
+                                           std::vector<double>>;
+    using xcsr_scheme_type = xcsr_scheme<std::vector<index_type>,
+                                         std::vector<index_type>,
+                                         std::vector<double>>;
+
+    TEST(xbcsr_scheme, insert)
+    {
+        xbcsr_scheme_type scheme(5, 5);
+        scheme.insert_element({4, 1}, 2.5);
+        scheme.insert_element({0, 3}, 8.2);
+        scheme.insert_element({1, 2}, 5.8);
+
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 1, 1, 2}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({1, 0}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0., 8.2, 5.8, 0., 0., 2.5, 0., 0.}));
+    }
+
+    TEST(xbcsr_scheme, find)
+    {
+        xbcsr_scheme_type scheme(5, 5);
+        scheme.insert_element({4, 1}, 2.5);
+        scheme.insert_element({0, 3}, 8.2);
+
+        EXPECT_EQ(scheme.find_element({2, 1}), nullptr);
+        EXPECT_EQ(scheme.find_element({0, 0}), nullptr);
+        EXPECT_EQ(*scheme.find_element({0, 3}), 8.2);
+        EXPECT_EQ(*scheme.find_element({4, 1}), 2.5);
+        // Padding entries of a stored block are found and hold zero
+        EXPECT_EQ(*scheme.find_element({1, 3}), 0.);
+    }
+
+    TEST(xbcsr_scheme, remove)
+    {
+        xbcsr_scheme_type scheme(4, 4);
+        scheme.insert_element({0, 0}, 2.5);
+        scheme.insert_element({1, 1}, 8.2);
+        scheme.insert_element({2, 3}, 1.3);
+
+        scheme.remove_element({0, 0});
+        EXPECT_EQ(scheme.coordinate().size(), 2u);
+        EXPECT_EQ(*scheme.find_element({0, 0}), 0.);
+
+        scheme.remove_element({3, 0});
+        EXPECT_EQ(scheme.coordinate().size(), 2u);
+
+        scheme.remove_element({1, 1});
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 0, 1}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({1}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0., 1.3, 0., 0.}));
+    }
+
+    TEST(xbcsr_scheme, prune)
+    {
+        xbcsr_scheme_type scheme(4, 4);
+        scheme.insert_element({0, 0}, 0.);
+        scheme.insert_element({1, 2}, 3.1);
+        scheme.insert_element({2, 0}, 0.01);
+        scheme.insert_element({3, 3}, -2.4);
+
+        scheme.prune();
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 1, 3}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({1, 0, 1}));
+
+        scheme.prune(1.);
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({1, 1}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0., 0., 3.1, 0., 0., 0., 0., -2.4}));
+    }
+
+    TEST(xbcsr_scheme, nz_iterator)
+    {
+        xbcsr_scheme_type scheme(3, 3, {0, 2, 3}, {0, 1, 1}, {1., 0., 0., 2., 3., 0., 4., 0., 5., 0., 0., 0.});
+
+        std::vector<std::array<index_type, 2>> indices;
+        std::vector<double> values;
+        for (auto it = scheme.nz_cbegin(); it != scheme.nz_cend(); ++it)
+        {
+            indices.push_back(it.index());
+            values.push_back(*it);
+        }
+        using array_type = std::array<index_type, 2>;
+        EXPECT_EQ(indices, std::vector<array_type>({array_type{0, 0}, array_type{1, 1}, array_type{0, 2},
+                                                    array_type{1, 2}, array_type{2, 2}}));
+        EXPECT_EQ(values, std::vector<double>({1., 2., 3., 4., 5.}));
+
+        auto it = scheme.nz_cend();
+        --it;
+        EXPECT_EQ(*it, 5.);
+        it -= 2;
+        EXPECT_EQ(*it, 3.);
+        EXPECT_EQ(scheme.nz_cend() - scheme.nz_cbegin(), 5);
+    }
+
+    TEST(xbcsr_scheme, assign_nz)
+    {
+        // 5 x 5 matrix, the last block row and block column are partial
+        xcsr_scheme_type csr({0, 2, 3, 3, 4, 6}, {0, 1, 1, 4, 0, 4}, {1., 2., 3., 4., 5., 6.});
+        xbcsr_scheme_type scheme(5, 5);
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 1, 2, 4}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({0, 2, 0, 2}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({1., 2., 0., 3.,
+                                                         0., 0., 4., 0.,
+                                                         5., 0., 0., 0.,
+                                                         6., 0., 0., 0.}));
+        EXPECT_DOUBLE_EQ(scheme.fill_ratio(), 16. / 6.);
+
+        std::vector<double> values;
+        for (auto it = scheme.nz_cbegin(); it != scheme.nz_cend(); ++it)
+        {
+            values.push_back(*it);
+            EXPECT_EQ(*csr.find_element(it.index()), *it);
+        }
+        EXPECT_EQ(values, std::vector<double>({1., 2., 3., 4., 5., 6.}));
+    }
+
+    TEST(xbcsr_scheme, const_stepper)
+    {
+        using array_type = xbcsr_array<double, 1, 4>;
+        static_assert(std::is_same<array_type::const_stepper, xindexed_stepper<array_type, true>>::value,
+                      "BCSR nz_iterator jumps are linear");
+
+        array_type a(std::vector<std::size_t>{3, 5});
+        a(0, 4) = 1.;
+        a(1, 1) = 2.;
+        a(2, 0) = 3.;
+        const array_type& ca = a;
+        std::vector<double> column_major(ca.template cbegin<layout_type::column_major>(),
+                                         ca.template cend<layout_type::column_major>());
+        EXPECT_EQ(column_major, std::vector<double>({0., 0., 3., 0., 2., 0., 0., 0., 0.,
+                                                     0., 0., 0., 1., 0., 0.}));
+    }
+
+    TEST(xbcsr_scheme, update_entries)
+    {
+        xbcsr_scheme_type scheme(2, 4);
+        scheme.insert_element({0, 3}, 1.);
+        scheme.insert_element({1, 0}, 2.);
+
+        // reshape 2 x 4 -> 4 x 2
+        scheme.update_entries(std::array<std::size_t, 2>({4, 1}), std::array<std::size_t, 2>({2, 1}), std::array<std::size_t, 2>({4, 2}));
+        EXPECT_EQ(scheme.shape(), (std::array<std::size_t, 2>({4, 2})));
+        EXPECT_EQ(*scheme.find_element({1, 1}), 1.);
+        EXPECT_EQ(*scheme.find_element({2, 0}), 2.);
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 1, 2}));
+    }
+}
@@ -1,4 +1,5 @@
 #include "gtest/gtest.h"
+#include <cstdint>
 #include <xtensor-sparse/xsparse_array.hpp>
 
 namespace xt
@@ -85,5 +86,40 @@ namespace xt
         EXPECT_EQ(A(1, 2), 10.);
         EXPECT_EQ(A(1, 4), 0.);
     }
-}
 
+    TEST(xcoo_array, insert_elements)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcoo_array<double> A(shape);
+
+        using index_type = typename xt::xcoo_array<double>::index_type;
+        std::vector<std::pair<index_type, double>> elements = {{{1, 2}, 10.},
+                                                               {{0, 0}, 3.},
+                                                               {{1, 2}, 1.}};
+        A.insert_elements(elements.cbegin(), elements.cend());
+
+        EXPECT_EQ(A(0, 0), 3.);
+        EXPECT_EQ(A(1, 2), 11.);
+        EXPECT_EQ(A(1, 4), 0.);
+    }
+
+    TEST(xcoo_array, compact_index)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcoo_array<double, std::uint16_t> A(shape);
+
+        A(1, 2) = 10.;
+        A(0, 4) = 3.;
+        EXPECT_EQ(A.scheme().coordinate()[0], (svector<std::uint16_t>{0, 4}));
+        EXPECT_EQ(A.scheme().coordinate()[1], (svector<std::uint16_t>{1, 2}));
+
+        std::vector<std::size_t> new_shape{5, 2};
+        A.reshape(new_shape);
+        EXPECT_EQ(A(2, 0), 3.);
+        EXPECT_EQ(A(3, 1), 10.);
+        EXPECT_EQ(A(1, 1), 0.);
+
+        auto it = A.nz_begin();
+        EXPECT_EQ(it.index(), (svector<std::size_t>{2, 0}));
+    }
+}
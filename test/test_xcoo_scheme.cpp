@@ -69,6 +69,50 @@ namespace xt
         EXPECT_EQ(scheme.position()[1], 3u);
     }
 
+    TEST(xcoo_scheme, prune)
+    {
+        auto scheme = make_coo_scheme();
+        scheme.insert_element({1, 3}, 0.);
+        scheme.prune(2.);
+
+        EXPECT_EQ(scheme.coordinate().size(), 3u);
+        EXPECT_EQ(scheme.coordinate()[0], index_type({0, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], index_type({1, 1}));
+        EXPECT_EQ(scheme.coordinate()[2], index_type({2, 7}));
+        EXPECT_EQ(scheme.position()[1], 3u);
+    }
+
+    TEST(xcoo_scheme, insert_elements)
+    {
+        auto scheme = make_coo_scheme();
+        std::vector<std::pair<index_type, double>> elements = {{{3, 1}, 1.2},
+                                                               {{0, 3}, 4.1},
+                                                               {{1, 1}, 1.0},
+                                                               {{0, 0}, 0.5},
+                                                               {{0, 3}, 0.9}};
+        scheme.insert_elements(elements.cbegin(), elements.cend());
+
+        EXPECT_EQ(scheme.coordinate().size(), 7u);
+        EXPECT_EQ(scheme.coordinate()[0], index_type({0, 0}));
+        EXPECT_EQ(scheme.coordinate()[1], index_type({0, 2}));
+        EXPECT_EQ(scheme.coordinate()[2], index_type({0, 3}));
+        EXPECT_EQ(scheme.coordinate()[3], index_type({0, 4}));
+        EXPECT_EQ(scheme.coordinate()[4], index_type({1, 1}));
+        EXPECT_EQ(scheme.coordinate()[5], index_type({2, 7}));
+        EXPECT_EQ(scheme.coordinate()[6], index_type({3, 1}));
+
+        EXPECT_EQ(scheme.storage()[0], 0.5);
+        EXPECT_EQ(scheme.storage()[1], 2.5);
+        EXPECT_EQ(scheme.storage()[2], 5.0);
+        EXPECT_EQ(scheme.storage()[3], 1.7);
+        EXPECT_EQ(scheme.storage()[4], 4.0);
+        EXPECT_EQ(scheme.storage()[5], 5.4);
+        EXPECT_EQ(scheme.storage()[6], 1.2);
+
+        EXPECT_EQ(scheme.position()[0], 0u);
+        EXPECT_EQ(scheme.position()[1], 7u);
+    }
+
     TEST(xcoo_scheme, update_entries)
     {
         auto scheme = make_coo_scheme();
@@ -0,0 +1,174 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <xtensor-sparse/xcoo_soa_scheme.hpp>
+#include <xtensor-sparse/xcsr_scheme.hpp>
+
+namespace xt
+{
+    using index_type = svector<size_t>;
+    using coordinate_array_type = std::vector<size_t>;
+    using xcoo_soa_scheme_type = xcoo_soa_scheme<std::vector<coordinate_array_type>,
+                                                 std::vector<double>>;
+
+    xcoo_soa_scheme_type make_coo_soa_scheme()
+    {
+        xcoo_soa_scheme_type scheme;
+        scheme.insert_element({0, 2}, 2.5);
+        scheme.insert_element({1, 1}, 3.0);
+        scheme.insert_element({0, 4}, 1.7);
+        scheme.insert_element({2, 7}, 5.4);
+        return scheme;
+    }
+
+    TEST(xcoo_soa_scheme, insert_element)
+    {
+        auto scheme = make_coo_soa_scheme();
+
+        ASSERT_EQ(scheme.coordinate().size(), 2u);
+        EXPECT_EQ(scheme.coordinate()[0], coordinate_array_type({0, 0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], coordinate_array_type({2, 4, 1, 7}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 1.7, 3.0, 5.4}));
+
+        scheme.insert_element({1, 1}, 1.5);
+        EXPECT_EQ(scheme.coordinate()[0], coordinate_array_type({0, 0, 1, 2}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 1.7, 1.5, 5.4}));
+    }
+
+    TEST(xcoo_soa_scheme, find_element)
+    {
+        auto scheme = make_coo_soa_scheme();
+
+        EXPECT_EQ(scheme.find_element({0, 2}), &(scheme.storage()[0]));
+        EXPECT_EQ(scheme.find_element({0, 4}), &(scheme.storage()[1]));
+        EXPECT_EQ(scheme.find_element({1, 1}), &(scheme.storage()[2]));
+        EXPECT_EQ(scheme.find_element({2, 7}), &(scheme.storage()[3]));
+        EXPECT_EQ(scheme.find_element({2, 2}), nullptr);
+        EXPECT_EQ(scheme.find_element({0, 3}), nullptr);
+        EXPECT_EQ(scheme.find_element({3, 0}), nullptr);
+
+        xcoo_soa_scheme_type empty;
+        EXPECT_EQ(empty.find_element({0, 0}), nullptr);
+    }
+
+    TEST(xcoo_soa_scheme, remove_element)
+    {
+        auto scheme = make_coo_soa_scheme();
+        scheme.remove_element({0, 4});
+        scheme.remove_element({1, 2});
+
+        EXPECT_EQ(scheme.coordinate()[0], coordinate_array_type({0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], coordinate_array_type({2, 1, 7}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 3.0, 5.4}));
+    }
+
+    TEST(xcoo_soa_scheme, prune)
+    {
+        auto scheme = make_coo_soa_scheme();
+        scheme.insert_element({1, 3}, 0.);
+        scheme.prune(2.);
+
+        EXPECT_EQ(scheme.coordinate()[0], coordinate_array_type({0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], coordinate_array_type({2, 1, 7}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 3.0, 5.4}));
+    }
+
+    TEST(xcoo_soa_scheme, insert_elements)
+    {
+        auto scheme = make_coo_soa_scheme();
+        std::vector<std::pair<index_type, double>> elements = {{{3, 1}, 1.2},
+                                                               {{0, 3}, 4.1},
+                                                               {{1, 1}, 1.0},
+                                                               {{0, 0}, 0.5},
+                                                               {{0, 3}, 0.9}};
+        scheme.insert_elements(elements.cbegin(), elements.cend());
+
+        EXPECT_EQ(scheme.coordinate()[0], coordinate_array_type({0, 0, 0, 0, 1, 2, 3}));
+        EXPECT_EQ(scheme.coordinate()[1], coordinate_array_type({0, 2, 3, 4, 1, 7, 1}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0.5, 2.5, 5.0, 1.7, 4.0, 5.4, 1.2}));
+    }
+
+    TEST(xcoo_soa_scheme, update_entries)
+    {
+        auto scheme = make_coo_soa_scheme();
+        std::vector<size_t> old_strides = {8, 1};
+        std::vector<size_t> new_strides = {8, 4, 1};
+        std::vector<size_t> new_shape;
+        scheme.update_entries(old_strides, new_strides, new_shape);
+
+        ASSERT_EQ(scheme.coordinate().size(), 3u);
+        EXPECT_EQ(scheme.coordinate()[0], coordinate_array_type({0, 0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], coordinate_array_type({0, 1, 0, 1}));
+        EXPECT_EQ(scheme.coordinate()[2], coordinate_array_type({2, 0, 1, 3}));
+        EXPECT_EQ(*scheme.find_element({2, 1, 3}), 5.4);
+    }
+
+    TEST(xcoo_soa_scheme, assign_nz)
+    {
+        using csr_type = xcsr_scheme<std::vector<size_t>, std::vector<size_t>, std::vector<double>>;
+        csr_type csr({0, 1, 2, 4}, {2, 0, 0, 2}, {1., 2., 3., 4.});
+        xcoo_soa_scheme<std::vector<std::vector<std::uint16_t>>, std::vector<double>> scheme;
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        EXPECT_EQ(scheme.coordinate()[0], std::vector<std::uint16_t>({0, 1, 2, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], std::vector<std::uint16_t>({2, 0, 0, 2}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({1., 2., 3., 4.}));
+        EXPECT_EQ(*scheme.find_element({2, 2}), 4.);
+    }
+
+    template <class S>
+    class coo_soa_scheme_iterator : public ::testing::Test
+    {
+    public:
+
+        using scheme_type = S;
+    };
+
+    using coo_soa_iterator_test_types = ::testing::Types<xcoo_soa_scheme_type, const xcoo_soa_scheme_type>;
+    TYPED_TEST_SUITE(coo_soa_scheme_iterator, coo_soa_iterator_test_types);
+
+    TYPED_TEST(coo_soa_scheme_iterator, increment)
+    {
+        TypeParam scheme = make_coo_soa_scheme();
+        auto it = scheme.nz_begin();
+        EXPECT_EQ(*it, 2.5);
+        EXPECT_EQ(it.index(), index_type({0, 2}));
+        ++it;
+        EXPECT_EQ(*it, 1.7);
+        EXPECT_EQ(it.index(), index_type({0, 4}));
+        ++it;
+        EXPECT_EQ(*it, 3.0);
+        EXPECT_EQ(it.index(), index_type({1, 1}));
+        ++it;
+        EXPECT_EQ(*it, 5.4);
+        EXPECT_EQ(it.index(), index_type({2, 7}));
+        ++it;
+        EXPECT_EQ(it, scheme.nz_end());
+
+        auto it2 = scheme.nz_begin();
+        it2 += 2;
+        EXPECT_EQ(*it2, 3.0);
+        EXPECT_EQ(it2.index(), index_type({1, 1}));
+        EXPECT_EQ(scheme.nz_end() - it2, 2);
+    }
+
+    TYPED_TEST(coo_soa_scheme_iterator, decrement)
+    {
+        TypeParam scheme = make_coo_soa_scheme();
+        auto it = scheme.nz_end();
+        --it;
+        EXPECT_EQ(*it, 5.4);
+        EXPECT_EQ(it.index(), index_type({2, 7}));
+        --it;
+        EXPECT_EQ(*it, 3.0);
+        EXPECT_EQ(it.index(), index_type({1, 1}));
+        --it;
+        EXPECT_EQ(*it, 1.7);
+        EXPECT_EQ(it.index(), index_type({0, 4}));
+        --it;
+        EXPECT_EQ(*it, 2.5);
+        EXPECT_EQ(it.index(), index_type({0, 2}));
+        EXPECT_EQ(it, scheme.nz_begin());
+    }
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include <xtensor/xarray.hpp>
+#include <xtensor-sparse/xsparse_array.hpp>
+
+namespace xt
+{
+    TEST(xcsc_array, shaped_constructor)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcsc_array<double> A(shape);
+
+        EXPECT_EQ(A.dimension(), size_t(2));
+        EXPECT_EQ(A.shape()[0], size_t(2));
+        EXPECT_EQ(A.shape()[1], size_t(5));
+        EXPECT_EQ(A.scheme().position().size(), size_t(6));
+    }
+
+    TEST(xcsc_array, access_operator)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcsc_array<double> A(shape);
+
+        A(1, 2) = 10.;
+        A(0, 0) = 3.;
+        A(0, 2) = 5.;
+
+        EXPECT_EQ(A(0, 0), 3.);
+        EXPECT_EQ(A(0, 2), 5.);
+        EXPECT_EQ(A(1, 2), 10.);
+        EXPECT_EQ(A(1, 4), 0.);
+        EXPECT_EQ(A.nz_layout, layout_type::column_major);
+        EXPECT_EQ(A.scheme().coordinate(), std::vector<std::size_t>({0, 0, 1}));
+    }
+
+    TEST(xcsc_array, nz_iterator)
+    {
+        std::vector<std::size_t> shape{3, 3};
+        xt::xcsc_array<double> A(shape);
+
+        A(2, 0) = 1.;
+        A(0, 1) = 2.;
+        A(1, 1) = 3.;
+
+        auto it = A.nz_cbegin();
+        svector<std::size_t> expected{2, 0};
+        EXPECT_EQ(it.index(), expected);
+        ++it;
+        expected = {0, 1};
+        EXPECT_EQ(it.index(), expected);
+        ++it;
+        expected = {1, 1};
+        EXPECT_EQ(it.index(), expected);
+        EXPECT_EQ(*it, 3.);
+        ++it;
+        EXPECT_EQ(it, A.nz_cend());
+    }
+
+    TEST(xcsc_array, function)
+    {
+        std::vector<std::size_t> shape{3, 3};
+        xt::xcsc_array<double> A(shape);
+        xt::xcoo_array<double> B(shape);
+
+        A(2, 0) = 1.;
+        A(0, 1) = 2.;
+        B(0, 1) = 4.;
+        B(1, 2) = 5.;
+
+        EXPECT_TRUE((std::is_same<decltype(A + B)::assign_tag, extension::xdense_assign_tag>::value));
+        xt::xarray<double> res = A + B;
+        xt::xarray<double> expected = {{0., 6., 0.},
+                                       {0., 0., 5.},
+                                       {1., 0., 0.}};
+        EXPECT_EQ(res, expected);
+
+        xt::xcoo_array<double> C = A;
+        EXPECT_EQ(C(2, 0), 1.);
+        EXPECT_EQ(C(0, 1), 2.);
+    }
+}
@@ -35,16 +35,106 @@ namespace xt
         xcsf_scheme_type scheme;
         scheme.insert_element({0, 2}, 2.5);
         scheme.insert_element({1, 5}, 8.2);
+        scheme.insert_element({1, 7}, 1.3);
 
         scheme.remove_element({0, 2});
         EXPECT_EQ(scheme.storage().size(), 2);
-        EXPECT_EQ(scheme.storage()[0], 0.);
-        EXPECT_EQ(scheme.storage()[1], 8.2);
+        EXPECT_EQ(scheme.storage()[0], 8.2);
+        EXPECT_EQ(scheme.storage()[1], 1.3);
+        EXPECT_EQ(scheme.position()[0], index_type({0, 1}));
+        EXPECT_EQ(scheme.coordinate()[0], index_type({1}));
+        EXPECT_EQ(scheme.position()[1], index_type({0, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], index_type({5, 7}));
+        EXPECT_EQ(scheme.find_element({0, 2}), nullptr);
 
         scheme.remove_element({0, 0});
         EXPECT_EQ(scheme.storage().size(), 2);
-        EXPECT_EQ(scheme.storage()[0], 0.);
-        EXPECT_EQ(scheme.storage()[1], 8.2);
+
+        scheme.remove_element({1, 7});
+        EXPECT_EQ(scheme.storage().size(), 1);
+        EXPECT_EQ(scheme.position()[1], index_type({0, 1}));
+        EXPECT_EQ(scheme.coordinate()[1], index_type({5}));
+
+        scheme.remove_element({1, 5});
+        EXPECT_EQ(scheme.storage().size(), 0);
+        EXPECT_EQ(scheme.position().size(), 0);
+        EXPECT_EQ(scheme.coordinate().size(), 0);
+
+        scheme.insert_element({3, 1}, 4.2);
+        EXPECT_EQ(*(scheme.find_element({3, 1})), 4.2);
+    }
+
+    TEST(xcsf_scheme, prune)
+    {
+        xcsf_scheme_type scheme;
+        scheme.insert_element({0, 0, 2}, 0.);
+        scheme.insert_element({0, 1, 1}, 3.1);
+        scheme.insert_element({0, 1, 5}, 0.01);
+        scheme.insert_element({2, 0, 0}, 0.);
+        scheme.insert_element({2, 3, 4}, -2.4);
+
+        scheme.prune();
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, 0.01, -2.4}));
+        EXPECT_EQ(scheme.position()[0], index_type({0, 2}));
+        EXPECT_EQ(scheme.coordinate()[0], index_type({0, 2}));
+        EXPECT_EQ(scheme.position()[1], index_type({0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], index_type({1, 3}));
+        EXPECT_EQ(scheme.position()[2], index_type({0, 2, 3}));
+        EXPECT_EQ(scheme.coordinate()[2], index_type({1, 5, 4}));
+
+        scheme.prune(0.1);
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, -2.4}));
+        EXPECT_EQ(scheme.coordinate()[2], index_type({1, 4}));
+        EXPECT_EQ(*(scheme.find_element({2, 3, 4})), -2.4);
+
+        scheme.prune(10.);
+        EXPECT_EQ(scheme.storage().size(), 0);
+        EXPECT_EQ(scheme.position().size(), 0);
+    }
+
+    TEST(xcsf_scheme, find_long_fiber)
+    {
+        xcsf_scheme_type scheme;
+        for (std::size_t j = 0; j < 64; ++j)
+        {
+            scheme.insert_element({1, 63 - j, 3 * j}, double(j));
+        }
+
+        for (std::size_t j = 0; j < 64; ++j)
+        {
+            EXPECT_EQ(*scheme.find_element({1, 63 - j, 3 * j}), double(j));
+            EXPECT_EQ(scheme.find_element({1, 63 - j, 3 * j + 1}), nullptr);
+        }
+        EXPECT_EQ(scheme.find_element({0, 0, 0}), nullptr);
+        EXPECT_EQ(scheme.find_element({1, 64, 0}), nullptr);
+        EXPECT_EQ(scheme.position()[1], index_type({0, 64}));
+    }
+
+    TEST(xcsf_scheme, insert_elements)
+    {
+        xcsf_scheme_type scheme;
+        scheme.insert_element({0, 1, 1}, 3.1);
+        scheme.insert_element({2, 3, 4}, -2.4);
+
+        std::vector<std::pair<index_type, double>> elements = {{{2, 0, 0}, 1.2},
+                                                               {{0, 1, 5}, 4.1},
+                                                               {{2, 3, 4}, 1.4},
+                                                               {{0, 0, 2}, 0.5},
+                                                               {{0, 1, 5}, 0.9}};
+        scheme.insert_elements(elements.cbegin(), elements.cend());
+
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0.5, 3.1, 5.0, 1.2, -1.}));
+        EXPECT_EQ(scheme.position()[0], index_type({0, 2}));
+        EXPECT_EQ(scheme.coordinate()[0], index_type({0, 2}));
+        EXPECT_EQ(scheme.position()[1], index_type({0, 2, 4}));
+        EXPECT_EQ(scheme.coordinate()[1], index_type({0, 1, 0, 3}));
+        EXPECT_EQ(scheme.position()[2], index_type({0, 1, 3, 4, 5}));
+        EXPECT_EQ(scheme.coordinate()[2], index_type({2, 1, 5, 0, 4}));
+
+        xcsf_scheme_type empty;
+        empty.insert_elements(elements.cbegin(), elements.cbegin() + 2);
+        EXPECT_EQ(empty.storage(), std::vector<double>({4.1, 1.2}));
+        EXPECT_EQ(*empty.find_element({2, 0, 0}), 1.2);
     }
 
     TEST(xcsf_scheme, update_entries)
@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <xtensor-sparse/xsparse_array.hpp>
+#include <xtensor-sparse/xsparse_tensor.hpp>
+
+namespace xt
+{
+    TEST(xcsr_array, shaped_constructor)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcsr_array<double> A(shape);
+
+        EXPECT_EQ(A.dimension(), size_t(2));
+        EXPECT_EQ(A.shape()[0], size_t(2));
+        EXPECT_EQ(A.shape()[1], size_t(5));
+    }
+
+    TEST(xcsr_array, resize)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcsr_array<double> A(shape);
+
+        std::vector<std::size_t> new_shape{20, 50};
+        A.resize(new_shape);
+        EXPECT_EQ(A.shape()[0], size_t(20));
+        EXPECT_EQ(A.shape()[1], size_t(50));
+        EXPECT_EQ(A.scheme().position().size(), size_t(21));
+    }
+
+    TEST(xcsr_array, reshape)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcsr_array<double> A(shape);
+
+        A(0, 1) = 10.;
+        A(1, 0) = 50.;
+        A(1, 2) = 70.;
+        A(0, 2) = 20.;
+
+        std::vector<std::size_t> new_shape{5, 2};
+        A.reshape(new_shape);
+
+        EXPECT_EQ(A.shape()[0], size_t(5));
+        EXPECT_EQ(A.shape()[1], size_t(2));
+        EXPECT_EQ(A(0, 1), 10.);
+        EXPECT_EQ(A(1, 0), 20.);
+        EXPECT_EQ(A(2, 1), 50.);
+        EXPECT_EQ(A(3, 1), 70.);
+    }
+
+    TEST(xcsr_array, access_operator)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcsr_array<double> A(shape);
+
+        A(0, 0) = 3.;
+        A(1, 2) = 10.;
+
+        EXPECT_EQ(A(0, 0), 3.);
+        EXPECT_EQ(A(1, 2), 10.);
+        EXPECT_EQ(A(1, 4), 0.);
+        EXPECT_EQ(A.nz_layout, layout_type::row_major);
+    }
+
+    TEST(xcsr_tensor, access_operator)
+    {
+        std::array<std::size_t, 2> shape{{3, 4}};
+        xt::xcsr_tensor<double> A(shape);
+
+        A(2, 3) = 1.5;
+        A(0, 1) = 2.5;
+
+        EXPECT_EQ(A(2, 3), 1.5);
+        EXPECT_EQ(A(0, 1), 2.5);
+        EXPECT_EQ(A(1, 1), 0.);
+        EXPECT_EQ(A.scheme().coordinate(), std::vector<std::size_t>({1, 3}));
+    }
+
+    TEST(xcsr_array, compact_index)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xcsr_array<double, std::uint16_t, std::uint32_t> A(shape);
+
+        A(0, 1) = 10.;
+        A(1, 0) = 50.;
+        A(1, 2) = 70.;
+        EXPECT_EQ(A.scheme().position(), std::vector<std::uint32_t>({0, 1, 3}));
+        EXPECT_EQ(A.scheme().coordinate(), std::vector<std::uint16_t>({1, 0, 2}));
+
+        std::vector<std::size_t> new_shape{5, 2};
+        A.reshape(new_shape);
+        EXPECT_EQ(A(0, 1), 10.);
+        EXPECT_EQ(A(2, 1), 50.);
+        EXPECT_EQ(A(3, 1), 70.);
+    }
+}
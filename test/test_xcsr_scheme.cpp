@@ -38,16 +38,44 @@ namespace xt
         xcsr_scheme_type scheme(5);
         scheme.insert_element({0, 2}, 2.5);
         scheme.insert_element({1, 5}, 8.2);
+        scheme.insert_element({1, 7}, 1.3);
 
         scheme.remove_element({0, 2});
         EXPECT_EQ(scheme.storage().size(), 2);
-        EXPECT_EQ(scheme.storage()[0], 0.);
-        EXPECT_EQ(scheme.storage()[1], 8.2);
+        EXPECT_EQ(scheme.storage()[0], 8.2);
+        EXPECT_EQ(scheme.storage()[1], 1.3);
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({5, 7}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 0, 2, 2, 2, 2}));
+        EXPECT_EQ(scheme.find_element({0, 2}), nullptr);
 
         scheme.remove_element({0, 0});
         EXPECT_EQ(scheme.storage().size(), 2);
-        EXPECT_EQ(scheme.storage()[0], 0.);
-        EXPECT_EQ(scheme.storage()[1], 8.2);
+
+        scheme.remove_element({1, 7});
+        EXPECT_EQ(scheme.storage().size(), 1);
+        EXPECT_EQ(scheme.storage()[0], 8.2);
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({5}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 0, 1, 1, 1, 1}));
+    }
+
+    TEST(xcsr_scheme, prune)
+    {
+        xcsr_scheme_type scheme(4);
+        scheme.insert_element({0, 2}, 0.);
+        scheme.insert_element({1, 1}, 3.1);
+        scheme.insert_element({1, 5}, 0.01);
+        scheme.insert_element({3, 0}, -2.4);
+        scheme.insert_element({3, 4}, 0.);
+
+        scheme.prune();
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, 0.01, -2.4}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({1, 5, 0}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 0, 2, 2, 3}));
+
+        scheme.prune(0.1);
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, -2.4}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({1, 0}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 0, 1, 1, 2}));
     }
 
     TEST(xcsr_scheme, update_entries)
@@ -193,4 +221,109 @@ namespace xt
         EXPECT_EQ(it.index(), expected);
         EXPECT_EQ(*it, 3.1);
     }
+
+    TEST(xcsr_scheme, iterator_empty_rows)
+    {
+        xcsr_scheme_type scheme(6);
+        EXPECT_EQ(scheme.nz_begin(), scheme.nz_end());
+
+        scheme.insert_element({2, 3}, 1.5);
+        scheme.insert_element({5, 0}, 4.2);
+
+        auto it = scheme.nz_cbegin();
+        std::array<std::size_t, 2> expected{{2, 3}};
+        EXPECT_EQ(it.index(), expected);
+        EXPECT_EQ(*it, 1.5);
+        ++it;
+        expected = {{5, 0}};
+        EXPECT_EQ(it.index(), expected);
+        EXPECT_EQ(*it, 4.2);
+        ++it;
+        EXPECT_EQ(it, scheme.nz_cend());
+    }
+
+    TEST(xcsr_scheme, iterator_jump)
+    {
+        xcsr_scheme_type scheme(8);
+        scheme.insert_element({0, 1}, 1.);
+        scheme.insert_element({3, 2}, 2.);
+        scheme.insert_element({3, 4}, 3.);
+        scheme.insert_element({7, 0}, 4.);
+
+        auto it = scheme.nz_cbegin();
+        it += 3;
+        std::array<std::size_t, 2> expected{{7, 0}};
+        EXPECT_EQ(it.index(), expected);
+        EXPECT_EQ(*it, 4.);
+        it += -2;
+        expected = {{3, 2}};
+        EXPECT_EQ(it.index(), expected);
+        it -= 1;
+        expected = {{0, 1}};
+        EXPECT_EQ(it.index(), expected);
+        it += 4;
+        EXPECT_EQ(it, scheme.nz_cend());
+        it -= 2;
+        expected = {{3, 4}};
+        EXPECT_EQ(it.index(), expected);
+        EXPECT_EQ(*it, 3.);
+    }
+
+    TEST(xcsc_scheme, insert_and_iterate)
+    {
+        using xcsc_scheme_type = xcsc_scheme<std::vector<index_type>,
+                                             std::vector<index_type>,
+                                             std::vector<double>>;
+        xcsc_scheme_type scheme(4);
+        scheme.insert_element({0, 2}, 2.5);
+        scheme.insert_element({3, 1}, 8.2);
+        scheme.insert_element({1, 2}, 5.8);
+
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 0, 1, 3, 3}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({3, 0, 1}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({8.2, 2.5, 5.8}));
+        EXPECT_EQ(*scheme.find_element({1, 2}), 5.8);
+        EXPECT_EQ(scheme.find_element({2, 1}), nullptr);
+
+        auto it = scheme.nz_begin();
+        std::array<std::size_t, 2> expected{{3, 1}};
+        EXPECT_EQ(it.index(), expected);
+        ++it;
+        expected = {{0, 2}};
+        EXPECT_EQ(it.index(), expected);
+        ++it;
+        expected = {{1, 2}};
+        EXPECT_EQ(it.index(), expected);
+        EXPECT_EQ(*it, 5.8);
+
+        svector<std::size_t> old_strides{4, 1};
+        svector<std::size_t> new_strides{2, 1};
+        svector<std::size_t> new_shape{8, 2};
+        scheme.update_entries(old_strides, new_strides, new_shape);
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 2, 3}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({1, 3, 6}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 5.8, 8.2}));
+    }
+
+    // The columns of the old shape interleave in the single column of the new
+    // one, whose rows must still end up sorted.
+    TEST(xcsc_scheme, update_entries_interleaved)
+    {
+        using xcsc_scheme_type = xcsc_scheme<std::vector<index_type>,
+                                             std::vector<index_type>,
+                                             std::vector<double>>;
+        xcsc_scheme_type scheme(2);
+        scheme.insert_element({0, 0}, 1.);
+        scheme.insert_element({1, 0}, 3.);
+        scheme.insert_element({0, 1}, 2.);
+        scheme.insert_element({1, 1}, 4.);
+
+        svector<std::size_t> old_strides{2, 1};
+        svector<std::size_t> new_strides{1, 1};
+        svector<std::size_t> new_shape{4, 1};
+        scheme.update_entries(old_strides, new_strides, new_shape);
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 4}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({0, 1, 2, 3}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({1., 2., 3., 4.}));
+    }
 }
@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include "xtensor-sparse/xdcsr_scheme.hpp"
+
+namespace xt
+{
+    using index_type = std::size_t;
+    using xdcsr_scheme_type = xdcsr_scheme<std::vector<index_type>,
+                                           std::vector<index_type>,
+                                           std::vector<double>>;
+    using xdcsc_scheme_type = xdcsc_scheme<std::vector<index_type>,
+                                           std::vector<index_type>,
+                                           std::vector<double>>;
+
+    // Row indices beyond 2^32 would require a 32 GB position array with CSR.
+    constexpr index_type large_row = index_type(1) << 40;
+
+    TEST(xdcsr_scheme, insert)
+    {
+        xdcsr_scheme_type scheme;
+        scheme.insert_element({large_row, 2}, 2.5);
+        scheme.insert_element({1, 5}, 8.2);
+        scheme.insert_element({large_row, 1}, 5.8);
+
+        EXPECT_EQ(scheme.outer_coordinate(), std::vector<index_type>({1, large_row}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 1, 3}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({5, 1, 2}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({8.2, 5.8, 2.5}));
+    }
+
+    TEST(xdcsr_scheme, find)
+    {
+        xdcsr_scheme_type scheme;
+        scheme.insert_element({large_row, 2}, 2.5);
+        scheme.insert_element({1, 5}, 8.2);
+
+        EXPECT_EQ(scheme.find_element({large_row, 3}), nullptr);
+        EXPECT_EQ(scheme.find_element({2, 5}), nullptr);
+        EXPECT_EQ(*scheme.find_element({large_row, 2}), 2.5);
+        EXPECT_EQ(*scheme.find_element({1, 5}), 8.2);
+    }
+
+    TEST(xdcsr_scheme, remove)
+    {
+        xdcsr_scheme_type scheme;
+        scheme.insert_element({0, 2}, 2.5);
+        scheme.insert_element({1, 5}, 8.2);
+        scheme.insert_element({1, 7}, 1.3);
+
+        scheme.remove_element({0, 2});
+        EXPECT_EQ(scheme.outer_coordinate(), std::vector<index_type>({1}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 2}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({5, 7}));
+
+        scheme.remove_element({0, 0});
+        EXPECT_EQ(scheme.storage().size(), 2u);
+
+        scheme.remove_element({1, 5});
+        EXPECT_EQ(scheme.storage(), std::vector<double>({1.3}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 1}));
+    }
+
+    TEST(xdcsr_scheme, prune)
+    {
+        xdcsr_scheme_type scheme;
+        scheme.insert_element({0, 2}, 0.);
+        scheme.insert_element({1, 1}, 3.1);
+        scheme.insert_element({1, 5}, 0.01);
+        scheme.insert_element({3, 0}, -2.4);
+        scheme.insert_element({3, 4}, 0.);
+
+        scheme.prune();
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, 0.01, -2.4}));
+        EXPECT_EQ(scheme.outer_coordinate(), std::vector<index_type>({1, 3}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 2, 3}));
+
+        scheme.prune(5.);
+        EXPECT_TRUE(scheme.outer_coordinate().empty());
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0}));
+    }
+
+    TEST(xdcsr_scheme, nz_iterator)
+    {
+        xdcsr_scheme_type scheme({1, 4, large_row}, {0, 2, 3, 4}, {0, 3, 2, 7}, {1., 2., 3., 4.});
+
+        std::vector<std::array<index_type, 2>> indices;
+        std::vector<double> values;
+        for (auto it = scheme.nz_cbegin(); it != scheme.nz_cend(); ++it)
+        {
+            indices.push_back(it.index());
+            values.push_back(*it);
+        }
+        using array_type = std::array<index_type, 2>;
+        EXPECT_EQ(indices, std::vector<array_type>({array_type{1, 0}, array_type{1, 3}, array_type{4, 2}, array_type{large_row, 7}}));
+        EXPECT_EQ(values, std::vector<double>({1., 2., 3., 4.}));
+
+        auto it = scheme.nz_cend();
+        --it;
+        EXPECT_EQ(it.index()[0], large_row);
+        it -= 2;
+        EXPECT_EQ(it.index()[0], 1u);
+        EXPECT_EQ(*it, 2.);
+        EXPECT_EQ(scheme.nz_cend() - scheme.nz_cbegin(), 4);
+
+        it = scheme.nz_cbegin();
+        it += 3;
+        EXPECT_EQ(it.index(), (array_type{large_row, 7}));
+        it += 1;
+        EXPECT_EQ(it, scheme.nz_cend());
+        it -= 2;
+        EXPECT_EQ(it.index(), (array_type{4, 2}));
+        it += -2;
+        EXPECT_EQ(it.index(), (array_type{1, 0}));
+    }
+
+    TEST(xdcsc_scheme, assign_nz)
+    {
+        xdcsr_scheme_type csr({0, 2, 3}, {0, 2, 3, 4}, {3, 5, 3, 0}, {1., 2., 3., 4.});
+        xdcsc_scheme_type csc;
+        csc.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        EXPECT_EQ(csc.outer_coordinate(), std::vector<index_type>({0, 3, 5}));
+        EXPECT_EQ(csc.position(), std::vector<index_type>({0, 1, 3, 4}));
+        EXPECT_EQ(csc.coordinate(), std::vector<index_type>({3, 0, 2, 0}));
+        EXPECT_EQ(csc.storage(), std::vector<double>({4., 1., 3., 2.}));
+        EXPECT_EQ(*csc.find_element({2, 3}), 3.);
+    }
+}
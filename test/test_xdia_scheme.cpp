@@ -0,0 +1,129 @@
+#include "gtest/gtest.h"
+
+#include "xtensor-sparse/xcsr_scheme.hpp"
+#include "xtensor-sparse/xdia_scheme.hpp"
+
+namespace xt
+{
+    using index_type = std::size_t;
+    using xdia_scheme_type = xdia_scheme<std::vector<std::ptrdiff_t>,
+                                         std::vector<double>>;
+    using xcsr_scheme_type = xcsr_scheme<std::vector<index_type>,
+                                         std::vector<index_type>,
+                                         std::vector<double>>;
+
+    // 4 x 5 tridiagonal matrix
+    inline xdia_scheme_type make_tridiagonal()
+    {
+        return xdia_scheme_type(4, 5, {-1, 0, 1}, {0., 1., 2., 3.,
+                                                   4., 5., 6., 7.,
+                                                   8., 9., 10., 11.});
+    }
+
+    TEST(xdia_scheme, find)
+    {
+        xdia_scheme_type scheme = make_tridiagonal();
+
+        EXPECT_EQ(*scheme.find_element({1, 0}), 1.);
+        EXPECT_EQ(*scheme.find_element({2, 2}), 6.);
+        EXPECT_EQ(*scheme.find_element({3, 4}), 11.);
+        EXPECT_EQ(scheme.find_element({0, 2}), nullptr);
+        EXPECT_EQ(scheme.find_element({3, 0}), nullptr);
+        EXPECT_EQ(scheme.find_element({4, 3}), nullptr);
+    }
+
+    TEST(xdia_scheme, insert)
+    {
+        xdia_scheme_type scheme(3, 3);
+        scheme.insert_element({1, 1}, 2.5);
+        scheme.insert_element({2, 0}, 8.2);
+        scheme.insert_element({0, 0}, 5.8);
+        scheme.insert_element({1, 1}, 1.5);
+
+        EXPECT_EQ(scheme.offset(), std::vector<std::ptrdiff_t>({-2, 0}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0., 0., 8.2, 5.8, 1.5, 0.}));
+    }
+
+    TEST(xdia_scheme, remove)
+    {
+        xdia_scheme_type scheme = make_tridiagonal();
+
+        scheme.remove_element({0, 2});
+        scheme.remove_element({2, 2});
+        EXPECT_EQ(scheme.offset().size(), 3u);
+        EXPECT_EQ(*scheme.find_element({2, 2}), 0.);
+
+        scheme.remove_element({1, 0});
+        scheme.remove_element({2, 1});
+        scheme.remove_element({3, 2});
+        EXPECT_EQ(scheme.offset(), std::vector<std::ptrdiff_t>({0, 1}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({4., 5., 0., 7., 8., 9., 10., 11.}));
+    }
+
+    TEST(xdia_scheme, prune)
+    {
+        xdia_scheme_type scheme = make_tridiagonal();
+
+        scheme.prune(7.5);
+        EXPECT_EQ(scheme.offset(), std::vector<std::ptrdiff_t>({1}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({8., 9., 10., 11.}));
+    }
+
+    TEST(xdia_scheme, nz_iterator)
+    {
+        xdia_scheme_type scheme = make_tridiagonal();
+        scheme.remove_element({2, 2});
+
+        std::vector<std::array<index_type, 2>> indices;
+        std::vector<double> values;
+        for (auto it = scheme.nz_cbegin(); it != scheme.nz_cend(); ++it)
+        {
+            indices.push_back(it.index());
+            values.push_back(*it);
+        }
+        // Padding (0, -1) and the removed element are skipped
+        using array_type = std::array<index_type, 2>;
+        EXPECT_EQ(indices, std::vector<array_type>({array_type{0, 0}, array_type{0, 1},
+                                                    array_type{1, 0}, array_type{1, 1}, array_type{1, 2},
+                                                    array_type{2, 1}, array_type{2, 3},
+                                                    array_type{3, 2}, array_type{3, 3}, array_type{3, 4}}));
+        EXPECT_EQ(values, std::vector<double>({4., 8., 1., 5., 9., 2., 10., 3., 7., 11.}));
+
+        auto it = scheme.nz_cend();
+        --it;
+        EXPECT_EQ(*it, 11.);
+        it -= 3;
+        EXPECT_EQ(*it, 10.);
+        EXPECT_EQ(scheme.nz_cend() - scheme.nz_cbegin(), 10);
+
+        xdia_scheme_type empty(2, 2);
+        EXPECT_TRUE(empty.nz_cbegin() == empty.nz_cend());
+    }
+
+    TEST(xdia_scheme, assign_nz)
+    {
+        xcsr_scheme_type csr({0, 1, 2, 4}, {2, 0, 0, 2}, {1., 2., 3., 4.});
+        xdia_scheme_type scheme(3, 3);
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        EXPECT_EQ(scheme.offset(), std::vector<std::ptrdiff_t>({-2, -1, 0, 2}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0., 0., 3.,
+                                                         0., 2., 0.,
+                                                         0., 0., 4.,
+                                                         1., 0., 0.}));
+    }
+
+    TEST(xdia_scheme, update_entries)
+    {
+        xdia_scheme_type scheme(2, 4);
+        scheme.insert_element({0, 3}, 1.);
+        scheme.insert_element({1, 0}, 2.);
+
+        // reshape 2 x 4 -> 4 x 2
+        scheme.update_entries(std::array<std::size_t, 2>({4, 1}), std::array<std::size_t, 2>({2, 1}), std::array<std::size_t, 2>({4, 2}));
+        EXPECT_EQ(scheme.shape(), (std::array<std::size_t, 2>({4, 2})));
+        EXPECT_EQ(scheme.offset(), std::vector<std::ptrdiff_t>({-2, 0}));
+        EXPECT_EQ(*scheme.find_element({1, 1}), 1.);
+        EXPECT_EQ(*scheme.find_element({2, 0}), 2.);
+    }
+}
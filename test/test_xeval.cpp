@@ -51,4 +51,56 @@ namespace xt
         EXPECT_EQ(result(1, 2), 1.);
 
     }
-}
\ No newline at end of file
+
+    TYPED_TEST(xeval_test, dense_operand)
+    {
+        using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
+        using xtensor_type = typename std::tuple_element<1, TypeParam>::type;
+        using shape_type = typename xsparse_type::shape_type;
+        shape_type shape{2, 5};
+        xsparse_type A(shape);
+
+        A(1, 3) = 2.;
+        A(0, 1) = -1.;
+        xtensor_type B = {{1., 2., 3., 4., 5.}, {6., 7., 8., 9., 10.}};
+        auto result = eval(A + B);
+
+        bool type_eq = std::is_same<decltype(result), xtensor_type>::value;
+        EXPECT_TRUE(type_eq);
+
+        EXPECT_EQ(result(1, 3), 11.);
+        EXPECT_EQ(result(0, 1), 1.);
+        EXPECT_EQ(result(0, 0), 1.);
+        EXPECT_EQ(result(1, 4), 10.);
+
+        xtensor_type C = B;
+        C = 2 * A;
+        EXPECT_EQ(C(1, 3), 4.);
+        EXPECT_EQ(C(0, 1), -2.);
+        EXPECT_EQ(C(0, 0), 0.);
+        EXPECT_EQ(C(1, 4), 0.);
+    }
+
+    TYPED_TEST(xeval_test, mixed_product)
+    {
+        using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
+        using xtensor_type = typename std::tuple_element<1, TypeParam>::type;
+        using shape_type = typename xsparse_type::shape_type;
+        shape_type shape{2, 5};
+        xsparse_type A(shape);
+
+        A(1, 3) = 2.;
+        A(0, 1) = -1.;
+        xtensor_type dense_A = {{0., -1., 0., 0., 0.}, {0., 0., 0., 2., 0.}};
+        xtensor_type B = {{1., 2., 3., 4., 5.}, {6., 7., 8., 9., 10.}};
+
+        // Sparse times dense is tagged as sparse but has no nz_iterator
+        xtensor_type product = A * B;
+        xtensor_type expected_product = dense_A * B;
+        EXPECT_EQ(product, expected_product);
+
+        xtensor_type sum = B + B * A;
+        xtensor_type expected_sum = B + B * dense_A;
+        EXPECT_EQ(sum, expected_sum);
+    }
+}
@@ -0,0 +1,216 @@
+#include "gtest/gtest.h"
+
+#include "xtensor-sparse/xcsf_scheme.hpp"
+#include "xtensor-sparse/xfixed_csf_scheme.hpp"
+
+namespace xt
+{
+    using level_type = std::vector<std::size_t>;
+    using index3_type = std::array<std::size_t, 3>;
+    using xfixed_csf_scheme_type = xfixed_csf_scheme<3, level_type, level_type, std::vector<double>>;
+
+    inline xfixed_csf_scheme_type make_fixed_csf()
+    {
+        xfixed_csf_scheme_type scheme;
+        scheme.insert_element({0, 0, 2}, 0.);
+        scheme.insert_element({2, 3, 4}, -2.4);
+        scheme.insert_element({0, 1, 5}, 0.01);
+        scheme.insert_element({2, 0, 0}, 0.);
+        scheme.insert_element({0, 1, 1}, 3.1);
+        return scheme;
+    }
+
+    TEST(xfixed_csf_scheme, insert)
+    {
+        xfixed_csf_scheme_type scheme = make_fixed_csf();
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0., 3.1, 0.01, 0., -2.4}));
+        EXPECT_EQ(scheme.position()[0], level_type({0, 2}));
+        EXPECT_EQ(scheme.coordinate()[0], level_type({0, 2}));
+        EXPECT_EQ(scheme.position()[1], level_type({0, 2, 4}));
+        EXPECT_EQ(scheme.coordinate()[1], level_type({0, 1, 0, 3}));
+        EXPECT_EQ(scheme.position()[2], level_type({0, 1, 3, 4, 5}));
+        EXPECT_EQ(scheme.coordinate()[2], level_type({2, 1, 5, 0, 4}));
+
+        scheme.insert_element({0, 1, 5}, 1.5);
+        EXPECT_EQ(scheme.storage().size(), 5u);
+        EXPECT_EQ(*scheme.find_element({0, 1, 5}), 1.5);
+    }
+
+    TEST(xfixed_csf_scheme, find)
+    {
+        xfixed_csf_scheme_type scheme;
+        EXPECT_EQ(scheme.find_element({0, 0, 0}), nullptr);
+
+        scheme = make_fixed_csf();
+        EXPECT_EQ(*scheme.find_element({0, 1, 1}), 3.1);
+        EXPECT_EQ(*scheme.find_element({2, 3, 4}), -2.4);
+        EXPECT_EQ(scheme.find_element({0, 1, 2}), nullptr);
+        EXPECT_EQ(scheme.find_element({1, 0, 0}), nullptr);
+        EXPECT_EQ(scheme.find_element({2, 2, 4}), nullptr);
+    }
+
+    TEST(xfixed_csf_scheme, remove)
+    {
+        xfixed_csf_scheme_type scheme = make_fixed_csf();
+
+        scheme.remove_element({0, 1, 3});
+        EXPECT_EQ(scheme.storage().size(), 5u);
+
+        scheme.remove_element({0, 0, 2});
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, 0.01, 0., -2.4}));
+        EXPECT_EQ(scheme.position()[1], level_type({0, 1, 3}));
+        EXPECT_EQ(scheme.coordinate()[1], level_type({1, 0, 3}));
+        EXPECT_EQ(scheme.position()[2], level_type({0, 2, 3, 4}));
+
+        scheme.remove_element({2, 0, 0});
+        scheme.remove_element({2, 3, 4});
+        EXPECT_EQ(scheme.position()[0], level_type({0, 1}));
+        EXPECT_EQ(scheme.coordinate()[0], level_type({0}));
+        EXPECT_EQ(scheme.position()[1], level_type({0, 1}));
+        EXPECT_EQ(scheme.position()[2], level_type({0, 2}));
+
+        scheme.remove_element({0, 1, 1});
+        scheme.remove_element({0, 1, 5});
+        EXPECT_EQ(scheme.storage().size(), 0u);
+        EXPECT_EQ(scheme.position()[0], level_type({0, 0}));
+        EXPECT_EQ(scheme.position()[1], level_type({0}));
+        EXPECT_EQ(scheme.position()[2], level_type({0}));
+
+        scheme.insert_element({3, 1, 2}, 4.2);
+        EXPECT_EQ(*scheme.find_element({3, 1, 2}), 4.2);
+    }
+
+    TEST(xfixed_csf_scheme, prune)
+    {
+        xfixed_csf_scheme_type scheme = make_fixed_csf();
+
+        scheme.prune();
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, 0.01, -2.4}));
+        EXPECT_EQ(scheme.position()[0], level_type({0, 2}));
+        EXPECT_EQ(scheme.coordinate()[0], level_type({0, 2}));
+        EXPECT_EQ(scheme.position()[1], level_type({0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate()[1], level_type({1, 3}));
+        EXPECT_EQ(scheme.position()[2], level_type({0, 2, 3}));
+        EXPECT_EQ(scheme.coordinate()[2], level_type({1, 5, 4}));
+
+        scheme.prune(10.);
+        EXPECT_EQ(scheme.storage().size(), 0u);
+        EXPECT_EQ(scheme.position()[0], level_type({0, 0}));
+        EXPECT_EQ(scheme.position()[1], level_type({0}));
+        EXPECT_TRUE(scheme.nz_cbegin() == scheme.nz_cend());
+    }
+
+    TEST(xfixed_csf_scheme, insert_elements)
+    {
+        xfixed_csf_scheme_type scheme;
+        scheme.insert_element({0, 1, 1}, 3.1);
+        scheme.insert_element({2, 3, 4}, -2.4);
+
+        std::vector<std::pair<index3_type, double>> elements = {{{2, 0, 0}, 1.2},
+                                                                {{0, 1, 5}, 4.1},
+                                                                {{2, 3, 4}, 1.4},
+                                                                {{0, 0, 2}, 0.5},
+                                                                {{0, 1, 5}, 0.9}};
+        scheme.insert_elements(elements.cbegin(), elements.cend());
+
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0.5, 3.1, 5.0, 1.2, -1.}));
+        EXPECT_EQ(scheme.position()[1], level_type({0, 2, 4}));
+        EXPECT_EQ(scheme.coordinate()[1], level_type({0, 1, 0, 3}));
+        EXPECT_EQ(scheme.position()[2], level_type({0, 1, 3, 4, 5}));
+        EXPECT_EQ(scheme.coordinate()[2], level_type({2, 1, 5, 0, 4}));
+    }
+
+    TEST(xfixed_csf_scheme, update_entries)
+    {
+        xfixed_csf_scheme_type scheme;
+        scheme.insert_element({0, 0, 1}, 2.5);
+        scheme.insert_element({0, 1, 2}, 8.2);
+        scheme.insert_element({1, 0, 2}, 6.7);
+
+        // reshape 2 x 2 x 3 -> 3 x 2 x 2
+        index3_type old_strides = {6, 3, 1};
+        index3_type new_strides = {4, 2, 1};
+        scheme.update_entries(old_strides, new_strides, index3_type({3, 2, 2}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 8.2, 6.7}));
+        EXPECT_EQ(*scheme.find_element({0, 0, 1}), 2.5);
+        EXPECT_EQ(*scheme.find_element({1, 0, 1}), 8.2);
+        EXPECT_EQ(*scheme.find_element({2, 0, 0}), 6.7);
+
+        // reshape 3 x 2 x 2 -> 1 x 3 x 4
+        index3_type flat_strides = {12, 4, 1};
+        scheme.update_entries(new_strides, flat_strides, index3_type({1, 3, 4}));
+        EXPECT_EQ(scheme.position()[0], level_type({0, 1}));
+        EXPECT_EQ(scheme.position()[1], level_type({0, 3}));
+        EXPECT_EQ(scheme.coordinate()[1], level_type({0, 1, 2}));
+        EXPECT_EQ(scheme.coordinate()[2], level_type({1, 1, 0}));
+    }
+
+    TEST(xfixed_csf_scheme, nz_iterator)
+    {
+        xfixed_csf_scheme_type scheme = make_fixed_csf();
+
+        std::vector<index3_type> indices;
+        std::vector<double> values;
+        for (auto it = scheme.nz_cbegin(); it != scheme.nz_cend(); ++it)
+        {
+            indices.push_back(it.index());
+            values.push_back(*it);
+        }
+        EXPECT_EQ(indices, std::vector<index3_type>({index3_type{0, 0, 2}, index3_type{0, 1, 1}, index3_type{0, 1, 5},
+                                                     index3_type{2, 0, 0}, index3_type{2, 3, 4}}));
+        EXPECT_EQ(values, std::vector<double>({0., 3.1, 0.01, 0., -2.4}));
+
+        auto it = scheme.nz_end();
+        --it;
+        EXPECT_EQ(it.index(), index3_type({2, 3, 4}));
+        --it;
+        EXPECT_EQ(it.index(), index3_type({2, 0, 0}));
+        --it;
+        EXPECT_EQ(it.index(), index3_type({0, 1, 5}));
+        *it = 1.5;
+        EXPECT_EQ(*scheme.find_element({0, 1, 5}), 1.5);
+
+        it -= 2;
+        EXPECT_EQ(it.index(), index3_type({0, 0, 2}));
+        it += 4;
+        EXPECT_EQ(it.index(), index3_type({2, 3, 4}));
+        ++it;
+        EXPECT_TRUE(it == scheme.nz_end());
+        EXPECT_EQ(scheme.nz_cend() - scheme.nz_cbegin(), 5);
+
+        xfixed_csf_scheme_type empty;
+        EXPECT_TRUE(empty.nz_cbegin() == empty.nz_cend());
+    }
+
+    TEST(xfixed_csf_scheme, assign_nz)
+    {
+        using dynamic_type = xcsf_scheme<std::vector<level_type>, std::vector<level_type>, std::vector<double>>;
+        dynamic_type dynamic;
+        dynamic.insert_element({2, 3, 4}, -2.4);
+        dynamic.insert_element({0, 1, 5}, 0.01);
+        dynamic.insert_element({0, 1, 1}, 3.1);
+
+        xfixed_csf_scheme_type scheme = make_fixed_csf();
+        scheme.assign_nz(dynamic.nz_cbegin(), dynamic.nz_cend());
+        EXPECT_EQ(scheme.storage(), std::vector<double>({3.1, 0.01, -2.4}));
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            EXPECT_EQ(scheme.position()[d], dynamic.position()[d]);
+            EXPECT_EQ(scheme.coordinate()[d], dynamic.coordinate()[d]);
+        }
+    }
+
+    TEST(xfixed_csf_scheme, compact_levels)
+    {
+        using compact_type = xdefault_fixed_csf_scheme_t<double, std::array<std::size_t, 4>, std::uint16_t, std::uint32_t>;
+        compact_type scheme;
+        scheme.insert_element({1, 2, 3, 4}, 1.);
+        scheme.insert_element({1, 2, 0, 4}, 2.);
+        scheme.insert_element({0, 5, 5, 5}, 3.);
+
+        EXPECT_EQ(scheme.position()[3], std::vector<std::uint32_t>({0, 1, 2, 3}));
+        EXPECT_EQ(scheme.coordinate()[2], std::vector<std::uint16_t>({5, 0, 3}));
+        EXPECT_EQ(*scheme.find_element({1, 2, 0, 4}), 2.);
+        EXPECT_EQ((scheme.nz_cbegin() + 2).index(), (std::array<std::size_t, 4>({1, 2, 3, 4})));
+    }
+}
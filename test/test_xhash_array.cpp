@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include <vector>
+#include <xtensor-sparse/xsparse_array.hpp>
+
+namespace xt
+{
+    TEST(xhash_array, shaped_constructor)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xhash_array<double> A(shape);
+
+        EXPECT_EQ(A.dimension(), size_t(2));
+        EXPECT_EQ(A.shape()[0], size_t(2));
+        EXPECT_EQ(A.shape()[1], size_t(5));
+    }
+
+    TEST(xhash_array, reshape)
+    {
+        std::vector<std::size_t> shape{10};
+        xt::xhash_array<double> A(shape);
+
+        A(1) = 1.;
+        A(5) = 5.;
+        A(7) = 7.;
+
+        std::vector<std::size_t> new_shape{2, 5};
+        A.reshape(new_shape);
+
+        EXPECT_EQ(A(0, 1), 1.);
+        EXPECT_EQ(A(1, 0), 5.);
+        EXPECT_EQ(A(1, 2), 7.);
+        EXPECT_EQ(A(1, 1), 0.);
+    }
+
+    TEST(xhash_array, access_operator)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xhash_array<double> A(shape);
+
+        A(0, 0) = 3.;
+        A(1, 2) = 10.;
+
+        EXPECT_EQ(A(0, 0), 3.);
+        EXPECT_EQ(A(1, 2), 10.);
+        EXPECT_EQ(A(1, 4), 0.);
+
+        A(0, 0) = 0.;
+        EXPECT_EQ(A(0, 0), 0.);
+        EXPECT_EQ(A.scheme().size(), size_t(1));
+    }
+
+    TEST(xhash_array, insert_remove)
+    {
+        std::vector<std::size_t> shape{100, 100};
+        xt::xhash_array<double> A(shape);
+
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            for (std::size_t j = 0; j < 100; j += 3)
+            {
+                A(i, j) = double(i * 100 + j + 1);
+            }
+        }
+        EXPECT_EQ(A.scheme().size(), size_t(3400));
+        EXPECT_LE(4 * A.scheme().size(), 3 * A.scheme().capacity());
+
+        for (std::size_t i = 0; i < 100; i += 2)
+        {
+            for (std::size_t j = 0; j < 100; j += 3)
+            {
+                A(i, j) = 0.;
+            }
+        }
+        EXPECT_EQ(A.scheme().size(), size_t(1700));
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            for (std::size_t j = 0; j < 100; ++j)
+            {
+                double expected = (i % 2 == 1 && j % 3 == 0) ? double(i * 100 + j + 1) : 0.;
+                EXPECT_EQ(A(i, j), expected);
+            }
+        }
+    }
+
+    TEST(xhash_array, prune)
+    {
+        std::vector<std::size_t> shape{4, 5};
+        xt::xhash_array<double> A(shape);
+
+        A(0, 1) = 1e-3;
+        A(2, 3) = 2.;
+        A(3, 4) = -1e-4;
+        A.prune(1e-2);
+
+        EXPECT_EQ(A.scheme().size(), size_t(1));
+        EXPECT_EQ(A(2, 3), 2.);
+        EXPECT_EQ(A(0, 1), 0.);
+    }
+
+    TEST(xhash_array, nz_iterator)
+    {
+        std::vector<std::size_t> shape{4, 5};
+        xt::xhash_array<double> A(shape);
+
+        A(3, 0) = 5.;
+        A(0, 3) = 2.;
+        A(2, 1) = -3.;
+        A(0, 0) = 1.;
+
+        double sum = 0.;
+        std::size_t nnz = 0;
+        for (auto it = A.nz_cbegin(); it != A.nz_cend(); ++it)
+        {
+            EXPECT_EQ(A(it.index()[0], it.index()[1]), *it);
+            sum += *it;
+            ++nnz;
+        }
+        EXPECT_EQ(nnz, size_t(4));
+        EXPECT_EQ(sum, 5.);
+
+        const auto& s = A.scheme();
+        auto order = s.sorted_order();
+        std::vector<double> values;
+        for (auto it = s.nz_cbegin(order); it != s.nz_cend(order); ++it)
+        {
+            values.push_back(*it);
+        }
+        EXPECT_EQ(values, std::vector<double>({1., 2., -3., 5.}));
+        EXPECT_EQ(s.nz_cend(order) - s.nz_cbegin(order), 4);
+    }
+}
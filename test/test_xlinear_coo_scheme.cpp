@@ -0,0 +1,193 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <xtensor-sparse/xcsr_scheme.hpp>
+#include <xtensor-sparse/xlinear_coo_scheme.hpp>
+
+namespace xt
+{
+    using index_type = svector<size_t>;
+    using xlinear_coo_scheme_type = xlinear_coo_scheme<std::vector<size_t>, std::vector<double>>;
+
+    // 3 x 8 matrix
+    xlinear_coo_scheme_type make_linear_coo_scheme()
+    {
+        xlinear_coo_scheme_type scheme;
+        std::vector<size_t> strides = {8, 1};
+        scheme.update_entries(strides, strides, std::vector<size_t>({3, 8}));
+        scheme.insert_element({0, 2}, 2.5);
+        scheme.insert_element({1, 1}, 3.0);
+        scheme.insert_element({0, 4}, 1.7);
+        scheme.insert_element({2, 7}, 5.4);
+        return scheme;
+    }
+
+    TEST(xlinear_coo_scheme, insert_element)
+    {
+        auto scheme = make_linear_coo_scheme();
+
+        EXPECT_EQ(scheme.keys(), std::vector<size_t>({2, 4, 9, 23}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 1.7, 3.0, 5.4}));
+
+        scheme.insert_element({1, 1}, 1.5);
+        EXPECT_EQ(scheme.keys(), std::vector<size_t>({2, 4, 9, 23}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 1.7, 1.5, 5.4}));
+    }
+
+    TEST(xlinear_coo_scheme, find_element)
+    {
+        auto scheme = make_linear_coo_scheme();
+
+        EXPECT_EQ(scheme.find_element({0, 2}), &(scheme.storage()[0]));
+        EXPECT_EQ(scheme.find_element({0, 4}), &(scheme.storage()[1]));
+        EXPECT_EQ(scheme.find_element({1, 1}), &(scheme.storage()[2]));
+        EXPECT_EQ(scheme.find_element({2, 7}), &(scheme.storage()[3]));
+        EXPECT_EQ(scheme.find_element({0, 0}), nullptr);
+        EXPECT_EQ(scheme.find_element({2, 2}), nullptr);
+    }
+
+    TEST(xlinear_coo_scheme, remove_element)
+    {
+        auto scheme = make_linear_coo_scheme();
+        scheme.remove_element({0, 4});
+        scheme.remove_element({1, 2});
+
+        EXPECT_EQ(scheme.keys(), std::vector<size_t>({2, 9, 23}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 3.0, 5.4}));
+    }
+
+    TEST(xlinear_coo_scheme, prune)
+    {
+        auto scheme = make_linear_coo_scheme();
+        scheme.insert_element({1, 3}, 0.);
+        scheme.prune(2.);
+
+        EXPECT_EQ(scheme.keys(), std::vector<size_t>({2, 9, 23}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2.5, 3.0, 5.4}));
+    }
+
+    TEST(xlinear_coo_scheme, insert_elements)
+    {
+        auto scheme = make_linear_coo_scheme();
+        std::vector<std::pair<index_type, double>> elements = {{{2, 1}, 1.2},
+                                                               {{0, 3}, 4.1},
+                                                               {{1, 1}, 1.0},
+                                                               {{0, 0}, 0.5},
+                                                               {{0, 3}, 0.9}};
+        scheme.insert_elements(elements.cbegin(), elements.cend());
+
+        EXPECT_EQ(scheme.keys(), std::vector<size_t>({0, 2, 3, 4, 9, 17, 23}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({0.5, 2.5, 5.0, 1.7, 4.0, 1.2, 5.4}));
+    }
+
+    TEST(xlinear_coo_scheme, radix_sort)
+    {
+        // Keys spanning several bytes, with a byte shared by all of them
+        std::vector<std::uint32_t> keys = {0x030201, 0x010005, 0x030001, 0x000203, 0x010005, 0x000001};
+        std::vector<int> values = {0, 1, 2, 3, 4, 5};
+        detail::radix_sort(keys, values);
+
+        EXPECT_EQ(keys, std::vector<std::uint32_t>({0x000001, 0x000203, 0x010005, 0x010005, 0x030001, 0x030201}));
+        EXPECT_EQ(values, std::vector<int>({5, 3, 1, 4, 2, 0}));
+    }
+
+    TEST(xlinear_coo_scheme, branchless_lower_bound)
+    {
+        std::vector<std::size_t> keys = {1, 3, 3, 5, 8, 13, 21};
+        for (std::size_t size = 0; size <= keys.size(); ++size)
+        {
+            for (std::size_t value = 0; value < 23; ++value)
+            {
+                auto last = keys.cbegin() + static_cast<std::ptrdiff_t>(size);
+                EXPECT_EQ(detail::branchless_lower_bound(keys.cbegin(), size, value),
+                          std::lower_bound(keys.cbegin(), last, value));
+            }
+        }
+    }
+
+    TEST(xlinear_coo_scheme, update_entries)
+    {
+        auto scheme = make_linear_coo_scheme();
+
+        // reshape 3 x 8 -> 3 x 2 x 4
+        std::vector<size_t> old_strides = {8, 1};
+        std::vector<size_t> new_strides = {8, 4, 1};
+        scheme.update_entries(old_strides, new_strides, std::vector<size_t>({3, 2, 4}));
+
+        EXPECT_EQ(scheme.keys(), std::vector<size_t>({2, 4, 9, 23}));
+        EXPECT_EQ(*scheme.find_element({0, 0, 2}), 2.5);
+        EXPECT_EQ(*scheme.find_element({0, 1, 0}), 1.7);
+        EXPECT_EQ(*scheme.find_element({1, 0, 1}), 3.0);
+        EXPECT_EQ(*scheme.find_element({2, 1, 3}), 5.4);
+    }
+
+    TEST(xlinear_coo_scheme, assign_nz)
+    {
+        using csr_type = xcsr_scheme<std::vector<size_t>, std::vector<size_t>, std::vector<double>>;
+        csr_type csr({0, 1, 2, 4}, {2, 0, 0, 2}, {1., 2., 3., 4.});
+        xlinear_coo_scheme<std::vector<std::uint16_t>, std::vector<double>> scheme;
+        std::vector<size_t> strides = {3, 1};
+        scheme.update_entries(strides, strides, std::vector<size_t>({3, 3}));
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        EXPECT_EQ(scheme.keys(), std::vector<std::uint16_t>({2, 3, 6, 8}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({1., 2., 3., 4.}));
+        EXPECT_EQ(*scheme.find_element({2, 2}), 4.);
+    }
+
+    template <class S>
+    class linear_coo_scheme_iterator : public ::testing::Test
+    {
+    public:
+
+        using scheme_type = S;
+    };
+
+    using linear_coo_iterator_test_types = ::testing::Types<xlinear_coo_scheme_type, const xlinear_coo_scheme_type>;
+    TYPED_TEST_SUITE(linear_coo_scheme_iterator, linear_coo_iterator_test_types);
+
+    TYPED_TEST(linear_coo_scheme_iterator, increment)
+    {
+        TypeParam scheme = make_linear_coo_scheme();
+        auto it = scheme.nz_begin();
+        EXPECT_EQ(*it, 2.5);
+        EXPECT_EQ(it.index(), index_type({0, 2}));
+        ++it;
+        EXPECT_EQ(*it, 1.7);
+        EXPECT_EQ(it.index(), index_type({0, 4}));
+        ++it;
+        EXPECT_EQ(*it, 3.0);
+        EXPECT_EQ(it.index(), index_type({1, 1}));
+        ++it;
+        EXPECT_EQ(*it, 5.4);
+        EXPECT_EQ(it.index(), index_type({2, 7}));
+        ++it;
+        EXPECT_EQ(it, scheme.nz_end());
+
+        auto it2 = scheme.nz_begin();
+        it2 += 2;
+        EXPECT_EQ(*it2, 3.0);
+        EXPECT_EQ(it2.index(), index_type({1, 1}));
+        EXPECT_EQ(scheme.nz_end() - it2, 2);
+    }
+
+    TYPED_TEST(linear_coo_scheme_iterator, decrement)
+    {
+        TypeParam scheme = make_linear_coo_scheme();
+        auto it = scheme.nz_end();
+        --it;
+        EXPECT_EQ(*it, 5.4);
+        EXPECT_EQ(it.index(), index_type({2, 7}));
+        --it;
+        EXPECT_EQ(*it, 3.0);
+        EXPECT_EQ(it.index(), index_type({1, 1}));
+        --it;
+        EXPECT_EQ(*it, 1.7);
+        EXPECT_EQ(it.index(), index_type({0, 4}));
+        --it;
+        EXPECT_EQ(*it, 2.5);
+        EXPECT_EQ(it.index(), index_type({0, 2}));
+        EXPECT_EQ(it, scheme.nz_begin());
+    }
+}
@@ -1,4 +1,5 @@
 #include "gtest/gtest.h"
+#include <cstdint>
 #include <vector>
 #include <xtensor-sparse/xsparse_array.hpp>
 
@@ -86,5 +87,44 @@ namespace xt
         EXPECT_EQ(A(1, 2), 10.);
         EXPECT_EQ(A(1, 4), 0.);
     }
-}
 
+    TEST(xmap_array, compact_index)
+    {
+        std::vector<std::size_t> shape{2, 5};
+        xt::xmap_array<double, std::uint16_t> A(shape);
+
+        A(1, 2) = 10.;
+        A(0, 4) = 3.;
+        EXPECT_EQ(A(0, 4), 3.);
+        EXPECT_EQ(A(1, 2), 10.);
+        EXPECT_EQ(A(1, 4), 0.);
+        EXPECT_EQ(A.scheme().storage().cbegin()->first, (svector<std::uint16_t>{0, 4}));
+
+        auto it = A.nz_begin();
+        ++it;
+        EXPECT_EQ(it.index(), (svector<std::size_t>{1, 2}));
+    }
+
+    TEST(xmap_array, const_traversal)
+    {
+        std::vector<std::size_t> shape{2, 3};
+        xt::xmap_array<double> A(shape);
+        A(0, 2) = 1.;
+        A(1, 0) = 2.;
+        A(1, 1) = 3.;
+
+        auto first = A.nz_cbegin();
+        auto last = A.nz_cend();
+        EXPECT_EQ(last - first, 3);
+        EXPECT_EQ(first - last, -3);
+        EXPECT_TRUE(first < last);
+        EXPECT_FALSE(last < first);
+
+        const xt::xmap_array<double>& cA = A;
+        std::vector<double> row_major(cA.cbegin(), cA.cend());
+        EXPECT_EQ(row_major, std::vector<double>({0., 0., 1., 2., 3., 0.}));
+        std::vector<double> column_major(cA.template cbegin<layout_type::column_major>(),
+                                         cA.template cend<layout_type::column_major>());
+        EXPECT_EQ(column_major, std::vector<double>({0., 2., 0., 3., 1., 0.}));
+    }
+}
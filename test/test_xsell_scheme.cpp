@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+
+#include "xtensor-sparse/xcsr_scheme.hpp"
+#include "xtensor-sparse/xsell_scheme.hpp"
+
+namespace xt
+{
+    using index_type = std::size_t;
+    using xsell_scheme_type = xsell_scheme<2, 4,
+                                           std::vector<index_type>,
+                                           std::vector<index_type>,
+                                           std::vector<double>>;
+    using xcsr_scheme_type = xcsr_scheme<std::vector<index_type>,
+                                         std::vector<index_type>,
+                                         std::vector<double>>;
+
+    // Rows of lengths 1, 3, 0, 2, 1
+    inline xcsr_scheme_type make_csr()
+    {
+        return xcsr_scheme_type({0, 1, 4, 4, 6, 7}, {2, 0, 1, 4, 1, 3, 0}, {1., 2., 3., 4., 5., 6., 7.});
+    }
+
+    TEST(xsell_scheme, assign_nz)
+    {
+        xcsr_scheme_type csr = make_csr();
+        xsell_scheme_type scheme(5, 5);
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        // The first window (rows 0 to 3) is sorted by decreasing length
+        EXPECT_EQ(scheme.permutation(), std::vector<index_type>({1, 3, 0, 2, 4}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 6, 8, 10}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({0, 1, 1, 3, 4, 0, 2, 0, 0, 0}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2., 5., 3., 6., 4., 0., 1., 0., 7., 0.}));
+        EXPECT_DOUBLE_EQ(scheme.fill_ratio(), 10. / 7.);
+    }
+
+    TEST(xsell_scheme, find)
+    {
+        xcsr_scheme_type csr = make_csr();
+        xsell_scheme_type scheme(5, 5);
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        EXPECT_EQ(*scheme.find_element({1, 4}), 4.);
+        EXPECT_EQ(*scheme.find_element({3, 3}), 6.);
+        EXPECT_EQ(*scheme.find_element({4, 0}), 7.);
+        EXPECT_EQ(scheme.find_element({2, 0}), nullptr);
+        EXPECT_EQ(scheme.find_element({0, 0}), nullptr);
+        EXPECT_EQ(scheme.find_element({3, 2}), nullptr);
+    }
+
+    TEST(xsell_scheme, insert)
+    {
+        xsell_scheme_type scheme(3, 4);
+        scheme.insert_element({0, 2}, 2.5);
+        scheme.insert_element({0, 0}, 8.2);
+        scheme.insert_element({1, 3}, 5.8);
+        scheme.insert_element({0, 2}, 1.5);
+
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 4, 4}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({0, 3, 2, 0}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({8.2, 5.8, 1.5, 0.}));
+
+        scheme.insert_element({2, 1}, 1.);
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 4, 6}));
+        EXPECT_EQ(*scheme.find_element({2, 1}), 1.);
+    }
+
+    TEST(xsell_scheme, remove)
+    {
+        xcsr_scheme_type csr = make_csr();
+        xsell_scheme_type scheme(5, 5);
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        scheme.remove_element({1, 1});
+        scheme.remove_element({2, 2});
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 4, 6, 8}));
+        EXPECT_EQ(scheme.coordinate(), std::vector<index_type>({0, 1, 4, 3, 2, 0, 0, 0}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({2., 5., 4., 6., 1., 0., 7., 0.}));
+        EXPECT_EQ(scheme.find_element({1, 1}), nullptr);
+        EXPECT_EQ(*scheme.find_element({1, 4}), 4.);
+    }
+
+    TEST(xsell_scheme, prune)
+    {
+        xcsr_scheme_type csr = make_csr();
+        xsell_scheme_type scheme(5, 5);
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        scheme.prune(4.5);
+        EXPECT_EQ(scheme.permutation(), std::vector<index_type>({3, 0, 1, 2, 4}));
+        EXPECT_EQ(scheme.position(), std::vector<index_type>({0, 4, 4, 6}));
+        EXPECT_EQ(scheme.storage(), std::vector<double>({5., 0., 6., 0., 7., 0.}));
+    }
+
+    TEST(xsell_scheme, nz_iterator)
+    {
+        xcsr_scheme_type csr = make_csr();
+        xsell_scheme_type scheme(5, 5);
+        scheme.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        std::vector<std::array<index_type, 2>> indices;
+        std::vector<double> values;
+        for (auto it = scheme.nz_cbegin(); it != scheme.nz_cend(); ++it)
+        {
+            indices.push_back(it.index());
+            values.push_back(*it);
+        }
+        using array_type = std::array<index_type, 2>;
+        EXPECT_EQ(indices, std::vector<array_type>({array_type{0, 2}, array_type{1, 0}, array_type{1, 1}, array_type{1, 4},
+                                                    array_type{3, 1}, array_type{3, 3}, array_type{4, 0}}));
+        EXPECT_EQ(values, std::vector<double>({1., 2., 3., 4., 5., 6., 7.}));
+
+        auto it = scheme.nz_cend();
+        --it;
+        EXPECT_EQ(*it, 7.);
+        --it;
+        EXPECT_EQ(*it, 6.);
+        it -= 3;
+        EXPECT_EQ(*it, 3.);
+        EXPECT_EQ(scheme.nz_cend() - scheme.nz_cbegin(), 7);
+        EXPECT_EQ(scheme.nz_cbegin() - it, -2);
+    }
+
+    TEST(xsell_scheme, update_entries)
+    {
+        xsell_scheme_type scheme(2, 4);
+        scheme.insert_element({0, 3}, 1.);
+        scheme.insert_element({1, 0}, 2.);
+
+        // reshape 2 x 4 -> 4 x 2
+        scheme.update_entries(std::array<std::size_t, 2>({4, 1}), std::array<std::size_t, 2>({2, 1}), std::array<std::size_t, 2>({4, 2}));
+        EXPECT_EQ(scheme.shape(), (std::array<std::size_t, 2>({4, 2})));
+        EXPECT_EQ(*scheme.find_element({1, 1}), 1.);
+        EXPECT_EQ(*scheme.find_element({2, 0}), 2.);
+        EXPECT_EQ(scheme.find_element({0, 1}), nullptr);
+    }
+}
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <tuple>
+#include <vector>
 #include "test_common.hpp"
 
 namespace xt
@@ -11,6 +13,19 @@ namespace xt
 
     TYPED_TEST_SUITE(container_test, container_list_types);
 
+    // Number of stored elements, counted on the nz_iterator since not all
+    // of them provide a distance.
+    template <class E>
+    std::size_t nnz(const E& e)
+    {
+        std::size_t res = 0;
+        for (auto it = e.nz_begin(); it != e.nz_end(); ++it)
+        {
+            ++res;
+        }
+        return res;
+    }
+
     TYPED_TEST(container_test, shaped_constructor)
     {
         using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
@@ -97,6 +112,50 @@ namespace xt
         EXPECT_EQ(it, A.end());
     }
 
+    TYPED_TEST(container_test, dense_traversal)
+    {
+        using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
+        using shape_type = typename xsparse_type::shape_type;
+
+        shape_type shape{3, 4};
+        xsparse_type A(shape);
+
+        const xsparse_type& cA = A;
+        EXPECT_EQ(std::count(cA.cbegin(), cA.cend(), 0.), 12);
+
+        A(0, 1) = 1.;
+        A(1, 3) = 2.;
+        A(2, 0) = 3.;
+        A(2, 2) = 4.;
+
+        std::vector<double> row_major(cA.cbegin(), cA.cend());
+        EXPECT_EQ(row_major, std::vector<double>({0., 1., 0., 0., 0., 0., 0., 2., 3., 0., 4., 0.}));
+
+        std::vector<double> column_major(cA.template cbegin<layout_type::column_major>(),
+                                         cA.template cend<layout_type::column_major>());
+        EXPECT_EQ(column_major, std::vector<double>({0., 0., 3., 1., 0., 0., 0., 0., 4., 0., 2., 0.}));
+    }
+
+    TYPED_TEST(container_test, insert_elements)
+    {
+        using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
+        using shape_type = typename xsparse_type::shape_type;
+        using index_type = typename xsparse_type::index_type;
+
+        shape_type shape{2, 5};
+        xsparse_type A(shape);
+        A(1, 2) = 4.;
+
+        std::vector<std::pair<index_type, double>> elements = {{{1, 2}, 10.},
+                                                               {{0, 0}, 3.},
+                                                               {{1, 2}, 1.}};
+        A.insert_elements(elements.cbegin(), elements.cend());
+
+        EXPECT_EQ(A(0, 0), 3.);
+        EXPECT_EQ(A(1, 2), 15.);
+        EXPECT_EQ(A(1, 4), 0.);
+    }
+
     TYPED_TEST(container_test, semantic)
     {
         using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
@@ -130,4 +189,79 @@ namespace xt
         EXPECT_EQ(B(0, 2), 1.);
         EXPECT_EQ(B(1, 4), 1.);
     }
+
+    TYPED_TEST(container_test, sparse_assign)
+    {
+        using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
+        using eval_type = typename std::tuple_element<2, TypeParam>::type;
+        using shape_type = typename xsparse_type::shape_type;
+
+        shape_type shape{2, 5};
+        xsparse_type A(shape), B(shape), C(shape);
+
+        A(0, 0) = 3.;
+        A(1, 2) = 10.;
+
+        B(0, 1) = 5.;
+        B(1, 4) = 9.;
+
+        C(0, 3) = 1.;
+
+        // Previous values of C are discarded
+        C = A * B + A;
+        EXPECT_EQ(nnz(C), std::size_t(2));
+        EXPECT_EQ(C(0, 0), 3.);
+        EXPECT_EQ(C(1, 2), 10.);
+        EXPECT_EQ(C(0, 3), 0.);
+
+        C = A - B;
+        EXPECT_EQ(nnz(C), std::size_t(4));
+        EXPECT_EQ(C(0, 0), 3.);
+        EXPECT_EQ(C(0, 1), -5.);
+        EXPECT_EQ(C(1, 2), 10.);
+        EXPECT_EQ(C(1, 4), -9.);
+
+        eval_type D = C;
+        EXPECT_EQ(nnz(D), std::size_t(4));
+        EXPECT_EQ(D(0, 1), -5.);
+        EXPECT_EQ(D(1, 4), -9.);
+    }
+
+    TYPED_TEST(container_test, sparse_assign_new_shape)
+    {
+        using xsparse_type = typename std::tuple_element<0, TypeParam>::type;
+        using eval_type = typename std::tuple_element<2, TypeParam>::type;
+        using shape_type = typename xsparse_type::shape_type;
+
+        eval_type A(shape_type{2, 3});
+        A(0, 2) = 1.;
+        A(1, 0) = 2.;
+
+        // The stored elements of B are out of the shape of A
+        xsparse_type B(shape_type{4, 6});
+        B(3, 5) = 7.;
+        B(0, 4) = 8.;
+        B(2, 1) = 9.;
+
+        B = A;
+        EXPECT_EQ(B.shape()[0], std::size_t(2));
+        EXPECT_EQ(B.shape()[1], std::size_t(3));
+        EXPECT_EQ(nnz(B), std::size_t(2));
+        EXPECT_EQ(B(0, 2), 1.);
+        EXPECT_EQ(B(1, 0), 2.);
+        EXPECT_EQ(B(1, 1), 0.);
+
+        // The stored elements of C are in the shape of D
+        xsparse_type C(shape_type{1, 2});
+        C(0, 1) = 5.;
+        eval_type D(shape_type{3, 4});
+        D(2, 3) = 6.;
+
+        C = D;
+        EXPECT_EQ(C.shape()[0], std::size_t(3));
+        EXPECT_EQ(C.shape()[1], std::size_t(4));
+        EXPECT_EQ(nnz(C), std::size_t(1));
+        EXPECT_EQ(C(0, 1), 0.);
+        EXPECT_EQ(C(2, 3), 6.);
+    }
 }
@@ -0,0 +1,284 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <xtensor/xarray.hpp>
+
+#include <xtensor-sparse/xsparse_array.hpp>
+#include <xtensor-sparse/xsparse_convert.hpp>
+#include <xtensor-sparse/xsparse_tensor.hpp>
+
+namespace xt
+{
+    namespace
+    {
+        using array_index_type = svector<std::size_t>;
+        using coo_scheme = xdefault_coo_scheme_t<double, array_index_type>;
+        using coo_soa_scheme = xdefault_coo_soa_scheme_t<double, array_index_type>;
+        using linear_coo_scheme = xdefault_linear_coo_scheme_t<double, array_index_type>;
+        using csr_scheme = xdefault_csr_scheme_t<double, array_index_type>;
+        using csc_scheme = xdefault_csc_scheme_t<double, array_index_type>;
+        using csf_scheme = xdefault_csf_scheme_t<double, array_index_type>;
+        using map_scheme = xdefault_map_scheme_t<double, array_index_type>;
+        using hash_scheme = xdefault_hash_scheme_t<double, array_index_type>;
+        using dcsr_scheme = xdefault_dcsr_scheme_t<double, array_index_type>;
+        using dcsc_scheme = xdefault_dcsc_scheme_t<double, array_index_type>;
+        using bcsr_scheme = xdefault_bcsr_scheme_t<double, array_index_type, 2>;
+        using sell_scheme = xdefault_sell_scheme_t<double, array_index_type, 2, 4>;
+        using dia_scheme = xdefault_dia_scheme_t<double, array_index_type>;
+
+        template <class E>
+        void fill_matrix(E& a)
+        {
+            a(0, 3) = 2.;
+            a(0, 0) = 1.;
+            a(2, 2) = 4.;
+            a(3, 0) = 5.;
+            a(2, 1) = -3.;
+        }
+
+        template <class E1, class E2>
+        void check_equal(const E1& a, const E2& b)
+        {
+            ASSERT_EQ(a.shape()[0], b.shape()[0]);
+            ASSERT_EQ(a.shape()[1], b.shape()[1]);
+            for (std::size_t i = 0; i < a.shape()[0]; ++i)
+            {
+                for (std::size_t j = 0; j < a.shape()[1]; ++j)
+                {
+                    EXPECT_EQ(a(i, j), b(i, j));
+                }
+            }
+
+            std::size_t nnz_a = 0, nnz_b = 0;
+            for (auto it = a.nz_begin(); it != a.nz_end(); ++it)
+            {
+                ++nnz_a;
+            }
+            for (auto it = b.nz_begin(); it != b.nz_end(); ++it)
+            {
+                ++nnz_b;
+            }
+            EXPECT_EQ(nnz_a, nnz_b);
+        }
+    }
+
+    TEST(xsparse_convert, from_coo)
+    {
+        xcoo_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        check_equal(a, sparse::convert<coo_scheme>(a));
+        check_equal(a, sparse::convert<coo_soa_scheme>(a));
+        check_equal(a, sparse::convert<linear_coo_scheme>(a));
+        check_equal(a, sparse::convert<csr_scheme>(a));
+        check_equal(a, sparse::convert<csc_scheme>(a));
+        check_equal(a, sparse::convert<csf_scheme>(a));
+        check_equal(a, sparse::convert<map_scheme>(a));
+        check_equal(a, sparse::convert<dcsr_scheme>(a));
+        check_equal(a, sparse::convert<dcsc_scheme>(a));
+        check_equal(a, sparse::convert<bcsr_scheme>(a));
+        check_equal(a, sparse::convert<sell_scheme>(a));
+        check_equal(a, sparse::convert<dia_scheme>(a));
+    }
+
+    TEST(xsparse_convert, from_csc)
+    {
+        xcsc_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        auto csr = sparse::convert<csr_scheme>(a);
+        EXPECT_EQ(csr.scheme().position(), std::vector<std::size_t>({0, 2, 2, 4, 5}));
+        EXPECT_EQ(csr.scheme().coordinate(), std::vector<std::size_t>({0, 3, 1, 2, 0}));
+        check_equal(a, csr);
+        check_equal(a, sparse::convert<coo_scheme>(a));
+        check_equal(a, sparse::convert<csf_scheme>(a));
+        check_equal(a, sparse::convert<map_scheme>(a));
+    }
+
+    TEST(xsparse_convert, from_dcsc)
+    {
+        xdcsc_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        auto dcsr = sparse::convert<dcsr_scheme>(a);
+        EXPECT_EQ(dcsr.scheme().outer_coordinate(), std::vector<std::size_t>({0, 2, 3}));
+        EXPECT_EQ(dcsr.scheme().coordinate(), std::vector<std::size_t>({0, 3, 1, 2, 0}));
+        check_equal(a, dcsr);
+        check_equal(a, sparse::convert<csr_scheme>(a));
+    }
+
+    TEST(xsparse_convert, from_map)
+    {
+        xmap_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        auto coo = sparse::convert<coo_scheme>(a);
+        EXPECT_EQ(coo.scheme().storage(), std::vector<double>({1., 2., -3., 4., 5.}));
+        check_equal(a, coo);
+        check_equal(a, sparse::convert<csc_scheme>(a));
+    }
+
+    TEST(xsparse_convert, from_hash)
+    {
+        xhash_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        auto csr = sparse::convert<csr_scheme>(a);
+        EXPECT_EQ(csr.scheme().position(), std::vector<std::size_t>({0, 2, 2, 4, 5}));
+        EXPECT_EQ(csr.scheme().storage(), std::vector<double>({1., 2., -3., 4., 5.}));
+        check_equal(a, csr);
+        check_equal(a, sparse::convert<csc_scheme>(a));
+        check_equal(a, sparse::convert<hash_scheme>(csr));
+    }
+
+    TEST(xsparse_convert, from_bcsr)
+    {
+        xcsr_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        // Blocks (0, 0), (0, 1), (1, 0) and (1, 1) hold 16 values
+        EXPECT_DOUBLE_EQ(sparse::block_fill_ratio<2, 2>(a), 16. / 5.);
+        EXPECT_DOUBLE_EQ(sparse::block_fill_ratio<1, 1>(a), 1.);
+
+        auto bcsr = sparse::convert<bcsr_scheme>(a);
+        EXPECT_EQ(bcsr.scheme().position(), std::vector<std::size_t>({0, 2, 4}));
+        EXPECT_DOUBLE_EQ(bcsr.scheme().fill_ratio(), sparse::block_fill_ratio<2, 2>(a));
+        check_equal(a, bcsr);
+        check_equal(a, sparse::convert<csr_scheme>(bcsr));
+        check_equal(a, sparse::convert<csc_scheme>(bcsr));
+    }
+
+    TEST(xsparse_convert, from_sell)
+    {
+        xsell_array<double, 2, 4> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        auto csr = sparse::convert<csr_scheme>(a);
+        EXPECT_EQ(csr.scheme().position(), std::vector<std::size_t>({0, 2, 2, 4, 5}));
+        EXPECT_EQ(csr.scheme().storage(), std::vector<double>({1., 2., -3., 4., 5.}));
+        check_equal(a, csr);
+        check_equal(a, sparse::convert<csc_scheme>(a));
+    }
+
+    TEST(xsparse_convert, from_dia)
+    {
+        xcsr_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        // Diagonals -3, -1, 0 and 3 hold 16 values
+        EXPECT_DOUBLE_EQ(sparse::dia_fill_ratio(a), 16. / 5.);
+        EXPECT_FALSE(sparse::prefer_dia(a));
+
+        xcsr_array<double> b(std::vector<std::size_t>{6, 6});
+        for (std::size_t i = 0; i < 6; ++i)
+        {
+            b(i, i) = 2.;
+            if (i != 0)
+            {
+                b(i, i - 1) = -1.;
+            }
+        }
+        EXPECT_TRUE(sparse::prefer_dia(b));
+
+        auto dia = sparse::convert<dia_scheme>(a);
+        EXPECT_EQ(dia.scheme().offset(), std::vector<std::ptrdiff_t>({-3, -1, 0, 3}));
+        check_equal(a, dia);
+        check_equal(a, sparse::convert<csr_scheme>(dia));
+        check_equal(b, sparse::convert<csc_scheme>(sparse::convert<dia_scheme>(b)));
+    }
+
+    TEST(xsparse_convert, compact_index)
+    {
+        using compact_coo_scheme = xdefault_coo_scheme_t<double, array_index_type, std::uint16_t, std::uint32_t>;
+        using compact_csr_scheme = xdefault_csr_scheme_t<double, array_index_type, std::uint32_t>;
+        using compact_csc_scheme = xdefault_csc_scheme_t<double, array_index_type, std::uint16_t, std::uint32_t>;
+        using compact_csf_scheme = xdefault_csf_scheme_t<double, array_index_type, std::uint16_t, std::uint32_t>;
+        using compact_map_scheme = xdefault_map_scheme_t<double, array_index_type, std::uint16_t>;
+        using compact_hash_scheme = xdefault_hash_scheme_t<double, array_index_type, std::uint16_t, std::uint32_t>;
+        using compact_linear_coo_scheme = xdefault_linear_coo_scheme_t<double, array_index_type, std::uint16_t, std::uint32_t>;
+        using compact_dcsr_scheme = xdefault_dcsr_scheme_t<double, array_index_type, std::uint16_t, std::uint32_t>;
+        using compact_bcsr_scheme = xdefault_bcsr_scheme_t<double, array_index_type, 2, 2, std::uint16_t, std::uint32_t>;
+        using compact_sell_scheme = xdefault_sell_scheme_t<double, array_index_type, 2, 4, std::uint16_t, std::uint32_t>;
+
+        xcoo_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        auto csr = sparse::convert<compact_csr_scheme>(a);
+        EXPECT_EQ(csr.scheme().position(), std::vector<std::uint32_t>({0, 2, 2, 4, 5}));
+        EXPECT_EQ(csr.scheme().coordinate(), std::vector<std::uint32_t>({0, 3, 1, 2, 0}));
+        check_equal(a, csr);
+        check_equal(a, sparse::convert<compact_coo_scheme>(a));
+        check_equal(a, sparse::convert<compact_csc_scheme>(a));
+        check_equal(a, sparse::convert<compact_csf_scheme>(a));
+        check_equal(a, sparse::convert<compact_map_scheme>(a));
+        check_equal(a, sparse::convert<compact_hash_scheme>(a));
+        check_equal(a, sparse::convert<compact_linear_coo_scheme>(a));
+        check_equal(a, sparse::convert<compact_dcsr_scheme>(a));
+        check_equal(a, sparse::convert<compact_bcsr_scheme>(a));
+        check_equal(a, sparse::convert<compact_sell_scheme>(a));
+
+        // Back to schemes storing std::size_t
+        check_equal(a, sparse::convert<csr_scheme>(sparse::convert<compact_csc_scheme>(a)));
+        check_equal(a, sparse::convert<coo_scheme>(sparse::convert<compact_hash_scheme>(a)));
+    }
+
+    TEST(xsparse_convert, tensor)
+    {
+        using index_type = std::array<std::size_t, 3>;
+        using csf_tensor_scheme = xdefault_csf_scheme_t<double, index_type>;
+        using fixed_csf_tensor_scheme = xdefault_fixed_csf_scheme_t<double, index_type, std::uint16_t, std::uint32_t>;
+
+        xcoo_tensor<double, 3> a({2, 3, 4});
+        a(1, 2, 3) = 1.;
+        a(0, 1, 0) = 2.;
+        a(1, 0, 2) = 3.;
+        a(1, 2, 0) = 4.;
+
+        auto b = sparse::convert<csf_tensor_scheme>(a);
+        auto c = sparse::convert<fixed_csf_tensor_scheme>(b);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    EXPECT_EQ(a(i, j, k), b(i, j, k));
+                    EXPECT_EQ(a(i, j, k), c(i, j, k));
+                }
+            }
+        }
+    }
+
+    TEST(xsparse_convert, from_dense)
+    {
+        xarray<double> d = {{1., 0., 0., 2., 0.},
+                            {0., 0., 0., 0., 0.},
+                            {0., -3., 4., 0., 0.1},
+                            {5., 0., 0., 0., -0.05}};
+        xcoo_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+
+        auto coo = sparse::from_dense(d, 0.2);
+        EXPECT_EQ(coo.scheme().storage(), std::vector<double>({1., 2., -3., 4., 5.}));
+        check_equal(a, coo);
+
+        auto csr = sparse::from_dense<csr_scheme>(d, 0.2);
+        EXPECT_EQ(csr.scheme().position(), std::vector<std::size_t>({0, 2, 2, 4, 5}));
+        EXPECT_EQ(csr.scheme().coordinate(), std::vector<std::size_t>({0, 3, 1, 2, 0}));
+        check_equal(a, csr);
+        check_equal(a, sparse::from_dense<csc_scheme>(d, 0.2));
+        check_equal(a, sparse::from_dense<csf_scheme>(d, 0.2));
+        check_equal(a, sparse::from_dense<map_scheme>(d, 0.2));
+
+        xarray<double, layout_type::column_major> dc = d;
+        check_equal(a, sparse::from_dense<csr_scheme>(dc, 0.2));
+
+        auto scaled = sparse::from_dense<coo_scheme>(2. * d, 0.4);
+        EXPECT_EQ(scaled.scheme().storage(), std::vector<double>({2., 4., -6., 8., 10.}));
+
+        auto all = sparse::from_dense(d);
+        EXPECT_EQ(all.scheme().storage().size(), 7u);
+        EXPECT_EQ(all(3, 4), -0.05);
+    }
+}
@@ -45,9 +45,9 @@ namespace xt
 
         auto expr1 = A*B + B;
         auto it1 = expr1.nz_begin();
-        EXPECT_EQ(*it1, 0.);
-        ++it1;
         EXPECT_EQ(*it1, 9.24);
+        ++it1;
+        EXPECT_EQ(it1, expr1.nz_end());
 
         auto expr2 = A*B + A;
         auto it2 = expr2.nz_begin();
@@ -57,15 +57,15 @@ namespace xt
 
         auto expr3 = A*B + 1;
         auto it3 = expr3.nz_begin();
-        EXPECT_EQ(*it3, 1.);
-        ++it3;
         EXPECT_EQ(*it3, 6.04);
+        ++it3;
+        EXPECT_EQ(it3, expr3.nz_end());
 
         auto expr4 = A*B + B + 1;
         auto it4 = expr4.nz_begin();
-        EXPECT_EQ(*it4, 1.);
-        ++it4;
         EXPECT_EQ(*it4, 10.24);
+        ++it4;
+        EXPECT_EQ(it4, expr4.nz_end());
     }
 
     TEST(xsparse_function, nz_iterator_end)
@@ -83,8 +83,7 @@ namespace xt
         auto it1 = expr1.nz_end();
         --it1;
         EXPECT_EQ(*it1, 9.24);
-        --it1;
-        EXPECT_EQ(*it1, 0.);
+        EXPECT_EQ(it1, expr1.nz_begin());
 
         auto expr2 = A*B + A;
         auto it2 = expr2.nz_end();
@@ -100,4 +99,52 @@ namespace xt
         --it3;
         EXPECT_EQ(*it3, 1.1);
     }
-}
\ No newline at end of file
+
+    TEST(xsparse_function, nz_iterator_intersection)
+    {
+        std::vector<std::size_t> shape{20, 30};
+        xcoo_array<double> A(shape);
+        xcsr_array<double> M(shape);
+
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            for (std::size_t j = 0; j < 30; ++j)
+            {
+                if ((i + j) % 2 == 0)
+                {
+                    A(i, j) = static_cast<double>(i * 30 + j + 1);
+                }
+            }
+        }
+        M(3, 5) = 2.;
+        M(7, 8) = 2.;
+        M(7, 10) = 2.;
+        M(19, 29) = 2.;
+
+        using index_type = std::array<std::size_t, 2>;
+        std::vector<index_type> expected_index = {{3, 5}, {19, 29}};
+        std::vector<double> expected_value = {192., 1200.};
+
+        auto expr = A * M;
+        std::size_t k = 0;
+        for (auto it = expr.nz_begin(); it != expr.nz_end(); ++it, ++k)
+        {
+            ASSERT_LT(k, expected_value.size());
+            EXPECT_EQ(it.index()[0], expected_index[k][0]);
+            EXPECT_EQ(it.index()[1], expected_index[k][1]);
+            EXPECT_EQ(*it, expected_value[k]);
+        }
+        EXPECT_EQ(k, expected_value.size());
+
+        auto it = expr.nz_end();
+        --it;
+        EXPECT_EQ(*it, 1200.);
+        --it;
+        EXPECT_EQ(*it, 192.);
+        EXPECT_EQ(it, expr.nz_begin());
+
+        auto quotient = M / A;
+        auto qit = quotient.nz_begin();
+        EXPECT_EQ(*qit, 2. / 96.);
+    }
+}
@@ -0,0 +1,362 @@
+#include "gtest/gtest.h"
+
+#include <xtensor/xarray.hpp>
+#include <xtensor/xtensor.hpp>
+#include <xtensor-sparse/xsparse_array.hpp>
+#include <xtensor-sparse/xsparse_linalg.hpp>
+
+namespace xt
+{
+    template <class S>
+    void fill_matrix(S& a)
+    {
+        a(0, 0) = 1.;
+        a(0, 3) = 2.;
+        a(2, 1) = -3.;
+        a(2, 2) = 4.;
+        a(3, 0) = 5.;
+    }
+
+    TEST(xsparse_linalg, spmv_csr_scheme)
+    {
+        using scheme_type = xcsr_scheme<std::vector<std::size_t>,
+                                        std::vector<std::size_t>,
+                                        std::vector<double>>;
+        scheme_type a({0, 2, 2, 4}, {0, 3, 1, 2}, {1., 2., -3., 4.});
+        std::vector<double> x = {1., 2., 3., 4.};
+        std::vector<double> y = {1., 1., 1.};
+
+        sparse::spmv(a, x.cbegin(), y.begin());
+        EXPECT_EQ(y, std::vector<double>({10., 1., 7.}));
+    }
+
+    TEST(xsparse_linalg, parallel_spmv_csr)
+    {
+        using scheme_type = xcsr_scheme<std::vector<std::size_t>,
+                                        std::vector<std::size_t>,
+                                        std::vector<double>>;
+        // One heavy row followed by light rows
+        std::vector<std::size_t> pos = {0}, coords;
+        std::vector<double> values;
+        for (std::size_t i = 0; i < 50; ++i)
+        {
+            std::size_t nnz = i == 3 ? 40 : i % 3;
+            for (std::size_t j = 0; j < nnz; ++j)
+            {
+                coords.push_back(j);
+                values.push_back(static_cast<double>(i + j));
+            }
+            pos.push_back(coords.size());
+        }
+        scheme_type a(pos, coords, values);
+        std::vector<double> x(40, 0.5);
+        std::vector<double> expected(50, 0.);
+        sparse::spmv(a, x.cbegin(), expected.begin());
+
+        for (std::size_t nb_parts: {1u, 2u, 5u, 64u})
+        {
+            std::vector<double> y(50, 0.);
+            sparse::parallel_spmv(a, x.cbegin(), y.begin(), nb_parts);
+            EXPECT_EQ(y, expected);
+        }
+    }
+
+    TEST(xsparse_linalg, dot_csr)
+    {
+        xcsr_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x);
+        xtensor<double, 1> expected = {9., 0., 6., 5.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, dot_csc)
+    {
+        xcsc_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xarray<double> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x);
+        xtensor<double, 1> expected = {9., 0., 6., 5.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, dot_dcsr)
+    {
+        xdcsr_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x);
+        xtensor<double, 1> expected = {9., 0., 6., 5.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, dot_dcsc)
+    {
+        xdcsc_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x);
+        xtensor<double, 1> expected = {9., 0., 6., 5.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, parallel_spmv_dcsr)
+    {
+        using scheme_type = xdcsr_scheme<std::vector<std::size_t>,
+                                         std::vector<std::size_t>,
+                                         std::vector<double>>;
+        // Every third row is empty, and row 4 is heavy
+        scheme_type a;
+        for (std::size_t i = 0; i < 50; ++i)
+        {
+            std::size_t nnz = i % 3 == 0 ? 0 : (i == 4 ? 40 : i % 5 + 1);
+            for (std::size_t j = 0; j < nnz; ++j)
+            {
+                a.insert_element({i, j}, static_cast<double>(i + j));
+            }
+        }
+        std::vector<double> x(40, 0.5);
+        std::vector<double> expected(50, 1.);
+        for (auto it = a.nz_cbegin(); it != a.nz_cend(); ++it)
+        {
+            expected[it.index()[0]] += *it * 0.5;
+        }
+
+        for (std::size_t nb_parts: {1u, 2u, 5u, 64u})
+        {
+            std::vector<double> y(50, 1.);
+            sparse::parallel_spmv(a, x.cbegin(), y.begin(), nb_parts);
+            EXPECT_EQ(y, expected);
+        }
+    }
+
+    TEST(xsparse_linalg, dot_bcsr)
+    {
+        // 3 x 2 blocks, the last block row and block column are partial
+        xbcsr_array<double, 3, 2> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+        a(3, 4) = 6.;
+        xtensor<double, 1> x = {1., 2., 3., 4., 5.};
+
+        auto res = sparse::dot(a, x);
+        xtensor<double, 1> expected = {9., 0., 6., 35.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, parallel_spmv_bcsr)
+    {
+        using scheme_type = xbcsr_scheme<4, 4,
+                                         std::vector<std::size_t>,
+                                         std::vector<std::size_t>,
+                                         std::vector<double>>;
+        // Banded matrix with a heavy row 5
+        scheme_type a(50, 40);
+        for (std::size_t i = 0; i < 50; ++i)
+        {
+            for (std::size_t j = 0; j < 40; ++j)
+            {
+                if (i == 5 || (j + 2 >= i && j <= i + 2))
+                {
+                    a.insert_element({i, j}, static_cast<double>(i + j + 1));
+                }
+            }
+        }
+        std::vector<double> x(40, 0.5);
+        std::vector<double> expected(50, 1.);
+        for (auto it = a.nz_cbegin(); it != a.nz_cend(); ++it)
+        {
+            expected[it.index()[0]] += *it * 0.5;
+        }
+
+        for (std::size_t nb_parts: {1u, 2u, 5u, 64u})
+        {
+            std::vector<double> y(50, 1.);
+            sparse::parallel_spmv(a, x.cbegin(), y.begin(), nb_parts);
+            EXPECT_EQ(y, expected);
+        }
+    }
+
+    TEST(xsparse_linalg, dot_sell)
+    {
+        xsell_array<double, 2, 4> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x);
+        xtensor<double, 1> expected = {9., 0., 6., 5.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, parallel_spmv_sell)
+    {
+        using scheme_type = xsell_scheme<4, 16,
+                                         std::vector<std::size_t>,
+                                         std::vector<std::size_t>,
+                                         std::vector<double>>;
+        using csr_type = xcsr_scheme<std::vector<std::size_t>,
+                                     std::vector<std::size_t>,
+                                     std::vector<double>>;
+        // Row lengths vary from 0 to 40
+        std::vector<std::size_t> pos = {0}, coords;
+        std::vector<double> values;
+        for (std::size_t i = 0; i < 50; ++i)
+        {
+            std::size_t nnz = i == 3 ? 40 : (i * 7) % 11;
+            for (std::size_t j = 0; j < nnz; ++j)
+            {
+                coords.push_back(j);
+                values.push_back(static_cast<double>(i + j));
+            }
+            pos.push_back(coords.size());
+        }
+        csr_type csr(pos, coords, values);
+        scheme_type a(50, 40);
+        a.assign_nz(csr.nz_cbegin(), csr.nz_cend());
+
+        std::vector<double> x(40, 0.5);
+        std::vector<double> expected(50, 0.);
+        sparse::spmv(csr, x.cbegin(), expected.begin());
+
+        for (std::size_t nb_parts: {1u, 2u, 5u, 64u})
+        {
+            std::vector<double> y(50, 0.);
+            sparse::parallel_spmv(a, x.cbegin(), y.begin(), nb_parts);
+            EXPECT_EQ(y, expected);
+        }
+    }
+
+    TEST(xsparse_linalg, dot_dia)
+    {
+        xdia_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x);
+        xtensor<double, 1> expected = {9., 0., 6., 5.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, parallel_spmv_dia)
+    {
+        using scheme_type = xdia_scheme<std::vector<std::ptrdiff_t>, std::vector<double>>;
+        // Pentadiagonal 50 x 40 matrix
+        scheme_type a(50, 40);
+        for (std::size_t i = 0; i < 50; ++i)
+        {
+            for (std::size_t j = i < 2 ? 0 : i - 2; j < std::min(std::size_t(40), i + 3); ++j)
+            {
+                a.insert_element({i, j}, static_cast<double>(i + j + 1));
+            }
+        }
+        std::vector<double> x(40, 0.5);
+        std::vector<double> expected(50, 1.);
+        for (auto it = a.nz_cbegin(); it != a.nz_cend(); ++it)
+        {
+            expected[it.index()[0]] += *it * 0.5;
+        }
+
+        for (std::size_t nb_parts: {1u, 2u, 5u, 64u})
+        {
+            std::vector<double> y(50, 1.);
+            sparse::parallel_spmv(a, x.cbegin(), y.begin(), nb_parts);
+            EXPECT_EQ(y, expected);
+        }
+    }
+
+    TEST(xsparse_linalg, dot_coo)
+    {
+        xcoo_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x + 1.);
+        xtensor<double, 1> expected = {12., 0., 7., 10.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, dot_coo_soa)
+    {
+        xcoo_soa_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x + 1.);
+        xtensor<double, 1> expected = {12., 0., 7., 10.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, dot_linear_coo)
+    {
+        xlinear_coo_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xtensor<double, 1> x = {1., 2., 3., 4.};
+
+        auto res = sparse::dot(a, x + 1.);
+        xtensor<double, 1> expected = {12., 0., 7., 10.};
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xsparse_linalg, dot_shape_mismatch)
+    {
+        xcsr_array<double> a(std::vector<std::size_t>{4, 4});
+        xtensor<double, 1> x = {1., 2., 3.};
+        EXPECT_THROW(sparse::dot(a, x), std::runtime_error);
+    }
+
+    TEST(xsparse_linalg, transpose)
+    {
+        xcsr_array<double> a(std::vector<std::size_t>{4, 5});
+        fill_matrix(a);
+        a(1, 4) = 6.;
+
+        auto at = sparse::transpose(a);
+        EXPECT_EQ(at.shape()[0], size_t(5));
+        EXPECT_EQ(at.shape()[1], size_t(4));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 5; ++j)
+            {
+                EXPECT_EQ(at(j, i), a(i, j));
+            }
+        }
+    }
+
+    TEST(xsparse_linalg, spgemm)
+    {
+        xcsr_array<double> a(std::vector<std::size_t>{4, 4});
+        fill_matrix(a);
+        xcsr_array<double> b(std::vector<std::size_t>{4, 3});
+        b(0, 0) = 1.;
+        b(0, 2) = -1.;
+        b(1, 1) = 2.;
+        b(3, 0) = 0.5;
+
+        auto c = sparse::spgemm(a, b);
+        xarray<double> expected = {{ 2.,  0., -1.},
+                                   { 0.,  0.,  0.},
+                                   { 0., -6.,  0.},
+                                   { 5.,  0., -5.}};
+        EXPECT_EQ(c.shape()[0], size_t(4));
+        EXPECT_EQ(c.shape()[1], size_t(3));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                EXPECT_EQ(c(i, j), expected(i, j));
+            }
+        }
+        // Exact sizing: structural entries only, no explicit zeros
+        EXPECT_EQ(c.scheme().storage().size(), size_t(5));
+
+        auto ata = sparse::spgemm(sparse::transpose(a), a);
+        EXPECT_EQ(ata(0, 0), 26.);
+        EXPECT_EQ(ata(0, 3), 2.);
+        EXPECT_EQ(ata(1, 2), -12.);
+        EXPECT_THROW(sparse::spgemm(b, b), std::runtime_error);
+    }
+}
@@ -0,0 +1,108 @@
+#include "gtest/gtest.h"
+
+#include <xtensor-sparse/xsparse_array.hpp>
+#include <xtensor-sparse/xsparse_linalg.hpp>
+#include <xtensor-sparse/xsparse_simd.hpp>
+
+namespace xt
+{
+    template <class T>
+    class simd_test : public ::testing::Test
+    {
+    };
+
+    using simd_value_types = ::testing::Types<float, double, int>;
+    TYPED_TEST_SUITE(simd_test, simd_value_types);
+
+    // Rows longer than any SIMD batch, with remainders of every size
+    TYPED_TEST(simd_test, spmv)
+    {
+        using value_type = TypeParam;
+        using scheme_type = xdefault_csr_scheme_t<value_type, std::array<std::size_t, 2>>;
+
+        std::vector<std::size_t> pos = {0}, coords;
+        std::vector<value_type> values;
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            for (std::size_t j = 0; j < 2 * i; ++j)
+            {
+                coords.push_back(j);
+                values.push_back(static_cast<value_type>((i + j) % 5));
+            }
+            pos.push_back(coords.size());
+        }
+        std::vector<value_type> x(40);
+        for (std::size_t j = 0; j < x.size(); ++j)
+        {
+            x[j] = static_cast<value_type>(j % 3);
+        }
+
+        std::vector<value_type> expected(20, value_type(1));
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            for (std::size_t j = pos[i]; j < pos[i + 1]; ++j)
+            {
+                expected[i] += values[j] * x[coords[j]];
+            }
+        }
+
+        scheme_type a(pos, coords, values);
+        std::vector<value_type> y(20, value_type(1));
+        sparse::spmv(a, x.data(), y.data());
+        EXPECT_EQ(y, expected);
+    }
+
+    TYPED_TEST(simd_test, scale_and_sum)
+    {
+        using value_type = TypeParam;
+        xcsr_array<value_type> a(std::vector<std::size_t>{4, 10});
+        value_type expected = value_type(0);
+        for (std::size_t j = 0; j < 10; ++j)
+        {
+            a(1, j) = static_cast<value_type>(j);
+            a(3, j) = static_cast<value_type>(2);
+            expected += static_cast<value_type>(j + 2);
+        }
+
+        EXPECT_EQ(sparse::sum(a.scheme()), expected);
+        sparse::scale(a.scheme(), 3);
+        EXPECT_EQ(sparse::sum(a.scheme()), 3 * expected);
+        EXPECT_EQ(a(1, 7), value_type(21));
+        EXPECT_EQ(a(0, 7), value_type(0));
+    }
+
+    TEST(xsparse_simd, map_fallback)
+    {
+        xmap_array<double> a(std::vector<std::size_t>{3, 3});
+        a(0, 1) = 2.;
+        a(2, 2) = 5.;
+
+        sparse::scale(a.scheme(), 0.5);
+        EXPECT_EQ(a(0, 1), 1.);
+        EXPECT_EQ(sparse::sum(a.scheme()), 3.5);
+    }
+
+    TEST(xsparse_simd, coo_fallback)
+    {
+        xcoo_array<double> a(std::vector<std::size_t>{3, 3});
+        a(0, 1) = 2.;
+        a(2, 2) = 5.;
+
+        sparse::scale(a.scheme(), 0.5);
+        EXPECT_EQ(a(0, 1), 1.);
+        EXPECT_EQ(a(2, 2), 2.5);
+        EXPECT_EQ(sparse::sum(a.scheme()), 3.5);
+    }
+
+    TEST(xsparse_simd, hash_fallback)
+    {
+        xhash_array<double> a(std::vector<std::size_t>{3, 3});
+        a(0, 1) = 2.;
+        a(2, 2) = 5.;
+
+        sparse::scale(a.scheme(), 0.5);
+        EXPECT_EQ(a(0, 1), 1.);
+        EXPECT_EQ(a(2, 2), 2.5);
+        EXPECT_EQ(sparse::sum(a.scheme()), 3.5);
+    }
+}